@@ -123,6 +123,8 @@ for (my $j = 0; $j < $rangesTotal; ++$j) {
 		next if ($x == 0);
 		print "|$n| has $x $ppLabel lines\n";
 		next if ($ppLabel eq "dmrg");
+		# checked by postCi.pl from the output of this run
+		next if ($ppLabel eq "inSituCorrelations" || $ppLabel eq "sameEnergies");
 
 		if ($ppLabel eq "observe") {
 			$cmd .= runObserve($n, $w, $sOptions);
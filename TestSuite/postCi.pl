@@ -87,7 +87,9 @@ for (my $j = 0; $j < $rangesTotal; ++$j) {
 	               CollectBrakets => \&checkCollectBrakets,
 	               metts => \&checkMetts,
 	               observe => \&checkObserve,
-	               procOmegas => \&checkProcOmegas);
+	               procOmegas => \&checkProcOmegas,
+	               inSituCorrelations => \&checkInSituCorrelations,
+	               sameEnergies => \&checkSameEnergies);
 	for (my $i = 0; $i < $totalAnnotations; ++$i) {
 		my ($ppLabel, $w) = Ci::readAnnotationFromIndex(\@ciAnnotations, $i);
 		my $x = defined($w) ? scalar(@$w) : 0;
@@ -189,6 +191,20 @@ sub maxEnergyDiff
 	return "$maxEdiff [out of $n]";
 }
 
+# Compares the energies of this run with those of test m of this same run
+sub checkSameEnergies
+{
+	my ($n, $what, $workdir, $golddir) = @_;
+	foreach my $m (@$what) {
+		my %newValues;
+		my %otherValues;
+		procCout(\%newValues, $n, $workdir);
+		procCout(\%otherValues, $m, $workdir);
+		my $maxEdiff = maxEnergyDiff($newValues{"Energies"}, $otherValues{"Energies"});
+		print "|$n|: MaxEnergyDiff with $m = $maxEdiff\n";
+	}
+}
+
 sub procMemcheck
 {
 	my ($n) = @_;
@@ -588,6 +604,99 @@ sub checkObserve
 	compareObserveData(\@m1, \@m2);
 }
 
+# Compares the in-situ matrices in the cout of this run with
+# the observe matrices of this same run, for i <= j and for sites
+# visited in the last finite loop (nonzero in-situ diagonal)
+sub checkInSituCorrelations
+{
+	my ($n, $what, $workdir, $golddir) = @_;
+	my $file1 = "$workdir/runForinput$n.cout";
+	my $file2 = "$workdir/observe$n.txt";
+	print "$0: kompare in situ $file1 with $file2\n";
+	my %inSitu = loadInSituCorrelations($file1);
+	my @observed = loadObserveData($file2);
+	my %observedByLabel;
+	foreach my $h (@observed) {
+		$observedByLabel{$h->{"label"}} = $h->{"data"};
+	}
+
+	foreach my $label (@$what) {
+		my $m1 = $inSitu{"$label"};
+		my $m2 = $observedByLabel{"$label"};
+		if (!defined($m1)) {
+			print "\tIn situ $label NOT FOUND\n";
+			next;
+		}
+
+		if (!defined($m2)) {
+			print "\tObserve $label NOT FOUND\n";
+			next;
+		}
+
+		print "Comparing in situ $label\n";
+		compareUpperVisited($m1, $m2);
+	}
+}
+
+sub loadInSituCorrelations
+{
+	my ($file) = @_;
+	my %m;
+	my $fh;
+	if (!open($fh, "<", "$file")) {
+		print "$0: File $file NOT FOUND\n";
+		return %m;
+	}
+
+	while (<$fh>) {
+		chomp;
+		next unless (/^InSituCorrelations (.+$)/);
+		my $label = $1;
+		my @m1;
+		my $ret = readNextMatrix($fh, \@m1);
+		if ($ret ne "ok") {
+			print "$0: $ret\n";
+			print "$0: $label\n";
+			last;
+		}
+
+		$m{"$label"} = \@m1;
+	}
+
+	close($fh);
+	return %m;
+}
+
+sub compareUpperVisited
+{
+	my ($m1, $m2) = @_;
+	if (scalar(@$m1) < 3 || scalar(@$m2) < 3) {
+		print "\tMatrix TOO SMALL\n";
+		return;
+	}
+
+	my $rows = $m1->[0];
+	if ($rows != $m2->[0] || $m1->[1] != $m2->[1]) {
+		print "\tRows or cols not equal\n";
+		return;
+	}
+
+	my $max = 0;
+	my $counter = 0;
+	for (my $i = 0; $i < $rows; ++$i) {
+		next if ($m1->[2 + $i + $i*$rows] == 0);
+		for (my $j = $i; $j < $rows; ++$j) {
+			next if ($m1->[2 + $j + $j*$rows] == 0);
+			my $index = 2 + $i + $j*$rows;
+			my $val = abs($m1->[$index] - $m2->[$index]);
+			$max = $val if ($max < $val);
+			++$counter;
+		}
+	}
+
+	print "\tMaximum difference= $max [out of $counter]\n";
+}
+
 sub compareObserveData
 {
 	my ($m1, $m2) = @_;
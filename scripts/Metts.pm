@@ -5,21 +5,54 @@ use warnings;
 
 package Metts;
 
+# Lines of each METTS chain, from the standard output of dmrg in fin
+# With MettsChains=n, each line of chain c starts with MettsChain<c>: and the
+# lines of different chains are interleaved; the prefix is removed here
+# Lines without prefix, such as those of a run without MettsChains=,
+# are under chain -1
+sub chains
+{
+	my ($fin) = @_;
+	my %lines;
+	while (<$fin>) {
+		my $chain = -1;
+		$chain = $1 if (s/^MettsChain(\d+): //);
+		push @{$lines{$chain}}, $_;
+	}
+
+	return %lines;
+}
+
 sub energy
 {
 	my ($beta,$betaLabel,$option,$fin) = @_;
 	defined($fin) or die "Metts::energy beta label option fin\n";
 
+	my %chains = chains($fin);
+	my $counter  = 0;
+	my $sum = 0;
+	foreach my $chain (sort {$a <=> $b} keys %chains) {
+		($sum, $counter) = energyOfChain($beta, $betaLabel, $option, $chains{$chain},
+		                                 $chain, $sum, $counter);
+	}
+
+	die "$0: counter==0\n" if ($counter==0);
+	$sum /= ($counter);
+	return ($sum, $counter);
+}
+
+sub energyOfChain
+{
+	my ($beta,$betaLabel,$option,$lines,$chain,$sum,$counter) = @_;
+
 	my $minSite = 1;
 	my $minMeas = 0;
 
-	my $counter  = 0;
-	my $sum = 0;
 	my $sum2 = 0;
 	my $meas =0;
 	my $site = -1;
 	my $flag=0;
-	while (<$fin>) {
+	foreach (@$lines) {
 		if (/sites=([^\+])\+([^\+])/) {
 			my $site1 = $1;
 			my $site2 = $2;
@@ -45,14 +78,12 @@ sub energy
 			next unless ($flag);
 			$flag=0;
 			$sum += $sum2;
-			print "$counter $sum2 $site\n" if ($option);
+			print "$counter $sum2 $site $chain\n" if ($option);
 			$sum2=0;
 			$counter++;
 		}
 	}
 
-	die "$0: counter==0\n" if ($counter==0);
-	$sum /= ($counter);
 	return ($sum, $counter);
 }
 
@@ -62,6 +93,24 @@ sub density
 
 	defined($fin) or die "Metts::density: beta label option fin\n";
 
+	my %chains = chains($fin);
+	my ($denominator,$average,$total)=(0,0,0);
+	foreach my $chain (sort {$a <=> $b} keys %chains) {
+		($denominator, $average, $total) = densityOfChain($beta, $label, $option,
+		                                                  $chains{$chain}, $chain,
+		                                                  $denominator, $average, $total);
+	}
+
+	($total>0) or die "$0: No data found\n";
+	($denominator>0) or die "$0: No data found yet\n";
+	$average /= $denominator;
+	return ($average, $total);
+}
+
+sub densityOfChain
+{
+	my ($beta,$label,$option,$lines,$chain,$denominator,$average,$totalSoFar)=@_;
+
 	#print STDERR "$beta $label $option\n";
 	my $minSite = 1000;
 	my $maxSite = 0;
@@ -69,7 +118,7 @@ sub density
 	my @value2;
 	my @counter;
 
-	while(<$fin>) {
+	foreach (@$lines) {
 		next unless (/\Q$label/);
 		my @temp=split;
 		(scalar(@temp) > 2) or next;
@@ -91,8 +140,8 @@ sub density
 	}
 
 	my $total = $counter[1];
-	my ($denominator,$average)=(0,0);
-	defined($total) or die "$0: No data found\n";
+	return ($denominator, $average, $totalSoFar) if (!defined($total));
+
 	for (my $i=0;$i<$total;$i++) {
 		my $sum = 0;
 		my $exitHere = 0;
@@ -116,12 +165,11 @@ sub density
 			print "$_ "  if ($option);
 		}
 
+		print "   $chain" if ($option);
 		print "\n"  if ($option);
 	}
 
-	($denominator>0) or die "$0: No data found yet\n";
-	$average /= $denominator;
-	return ($average, $total);
+	return ($denominator, $average, $totalSoFar + $total);
 }
 
 sub load
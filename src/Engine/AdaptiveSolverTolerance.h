@@ -0,0 +1,110 @@
+#ifndef ADAPTIVE_SOLVER_TOLERANCE_H
+#define ADAPTIVE_SOLVER_TOLERANCE_H
+#include "Vector.h"
+#include "PsimagLite.h"
+#include <cmath>
+
+// Tolerance and step budget of the Lanczos or Davidson solver tied to
+// the progress of the sweeps, enabled with SolverOptions=adaptiveSolverTolerance
+// The tolerance is FACTOR times the larger of the last truncation error and
+// the change in energy between the last two finite loops, never tighter
+// than the tolerance in the input, and never looser than MAX_TOLERANCE
+// The last FINAL_LOOPS finite loops use the tolerance in the input
+namespace Dmrg {
+
+template<typename RealType>
+class AdaptiveSolverTolerance {
+
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef PsimagLite::Vector<bool>::Type VectorBoolType;
+
+public:
+
+	enum {FINAL_LOOPS = 2, MIN_STEPS = 20};
+
+	AdaptiveSolverTolerance(bool enabled, SizeType loopsTotal)
+	    : enabled_(enabled),
+	      loopsTotal_(loopsTotal),
+	      truncationError_(0),
+	      energyOfLoop_(loopsTotal, 0),
+	      hasEnergy_(loopsTotal, false),
+	      matvecs_(0),
+	      matvecsSaved_(0)
+	{}
+
+	bool enabled() const { return enabled_; }
+
+	void setTruncationError(RealType error) { truncationError_ = error; }
+
+	// the last energy computed in each finite loop
+	void recordEnergy(RealType energy, SizeType loopIndex)
+	{
+		if (loopIndex >= loopsTotal_) return;
+		energyOfLoop_[loopIndex] = energy;
+		hasEnergy_[loopIndex] = true;
+	}
+
+	// Loosens tolerance and steps, which come from the input,
+	// if the sweeps allow it; returns true if they were changed
+	bool operator()(RealType& tolerance, SizeType& steps, SizeType loopIndex) const
+	{
+		if (!enabled_ || loopIndex + FINAL_LOOPS >= loopsTotal_) return false;
+
+		RealType scale = truncationError_;
+		if (loopIndex >= 2 && hasEnergy_[loopIndex - 1] && hasEnergy_[loopIndex - 2])
+			scale = std::max(scale, fabs(energyOfLoop_[loopIndex - 1] -
+			                             energyOfLoop_[loopIndex - 2]));
+
+		RealType adapted = std::min(FACTOR*scale, MAX_TOLERANCE);
+		if (adapted <= tolerance) return false;
+
+		const SizeType minSteps = MIN_STEPS;
+		steps = std::min(steps, std::max(minSteps, stepsFor(adapted, tolerance, steps)));
+		tolerance = adapted;
+		return true;
+	}
+
+	// Lanczos and Davidson converge linearly in the number of digits,
+	// so the matvecs at the input tolerance are estimated by scaling
+	void recordMatvecs(SizeType matvecs, RealType toleranceUsed, RealType toleranceInput)
+	{
+		matvecs_ += matvecs;
+		if (toleranceUsed <= toleranceInput) return;
+		SizeType estimated = stepsFor(toleranceInput, toleranceUsed, matvecs);
+		if (estimated > matvecs) matvecsSaved_ += estimated - matvecs;
+	}
+
+	SizeType matvecs() const { return matvecs_; }
+
+	SizeType matvecsSaved() const { return matvecsSaved_; }
+
+private:
+
+	// steps needed for tolerance if refSteps were needed for refTolerance
+	static SizeType stepsFor(RealType tolerance, RealType refTolerance, SizeType refSteps)
+	{
+		if (tolerance <= 0 || refTolerance <= 0 || refTolerance >= 1) return refSteps;
+		RealType digits = -log10(std::min(tolerance, static_cast<RealType>(0.1)));
+		RealType refDigits = -log10(refTolerance);
+		return static_cast<SizeType>(ceil(refSteps*digits/refDigits));
+	}
+
+	static const RealType FACTOR;
+	static const RealType MAX_TOLERANCE;
+
+	bool enabled_;
+	SizeType loopsTotal_;
+	RealType truncationError_;
+	VectorRealType energyOfLoop_;
+	VectorBoolType hasEnergy_;
+	SizeType matvecs_;
+	SizeType matvecsSaved_;
+};
+
+template<typename RealType>
+const RealType AdaptiveSolverTolerance<RealType>::FACTOR = 0.1;
+
+template<typename RealType>
+const RealType AdaptiveSolverTolerance<RealType>::MAX_TOLERANCE = 1e-5;
+}
+#endif // ADAPTIVE_SOLVER_TOLERANCE_H
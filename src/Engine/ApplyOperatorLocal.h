@@ -82,6 +82,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "PackIndices.h" // in PsimagLite
 #include "FermionSign.h"
 #include "ProgramGlobals.h"
+#include "Concurrency.h"
+#include "ParallelizerPool.h"
 
 namespace Dmrg {
 
@@ -94,6 +96,9 @@ class ApplyOperatorLocal {
 	typedef typename BasisWithOperatorsType::ComplexOrRealType ComplexOrRealType;
 	typedef PsimagLite::PackIndices PackIndicesType;
 	typedef typename BasisWithOperatorsType::OperatorType OperatorType_;
+	typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename PsimagLite::Vector<TargetVectorType>::Type VectorTargetVectorType;
+	typedef typename PsimagLite::Vector<const OperatorType_*>::Type VectorConstOperatorPtrType;
 
 	class LegacyBug {
 
@@ -106,14 +111,19 @@ class ApplyOperatorLocal {
 		{
 			if (withLegacyBug_) return;
 
+			transposeOnly(*Aptr_, A);
+		}
+
+		static void transposeOnly(OperatorType_& dest, const OperatorType_& A)
+		{
 			// copy A
-			*Aptr_ = A;
+			dest = A;
 
-			// transpose conjugate Aptr_->data
-			transposeConjugate(Aptr_->data, A.data);
+			// transpose conjugate dest.data
+			transposeConjugate(dest.data, A.data);
 
 			// conjugate again to end up transposing only
-			Aptr_->data.conjugate();
+			dest.data.conjugate();
 		}
 
 		~LegacyBug()
@@ -139,13 +149,13 @@ public:
 
 	enum BorderEnum {BORDER_NO = false, BORDER_YES = true};
 
-	enum {MIDDLE, LEFT_CORNER, RIGHT_CORNER};
-
 	typedef LeftRightSuperType_ LeftRightSuperType;
 	typedef typename BasisWithOperatorsType::BasisType BasisType;
 	typedef VectorWithOffsetType_ VectorWithOffsetType;
 	typedef OperatorType_ OperatorType;
 	typedef FermionSign FermionSignType;
+	typedef typename PsimagLite::Vector<OperatorType>::Type VectorOperatorType;
+	typedef typename PsimagLite::Vector<VectorWithOffsetType>::Type VectorVectorWithOffsetType;
 
 	ApplyOperatorLocal(const LeftRightSuperType& lrs, bool withLegacyBug)
 	    : lrs_(lrs), withLegacyBug_(withLegacyBug)
@@ -161,17 +171,36 @@ public:
 	                BorderEnum corner) const
 	{
 		LegacyBug legacyBug(withLegacyBug_, AA);
-		const OperatorType& A = legacyBug();
+		VectorConstOperatorPtrType ops(1, &legacyBug());
+		VectorVectorWithOffsetType dests(1);
+		applyLocalOps(dests, src, ops, fermionSign, systemOrEnviron, corner);
+		dest = dests[0];
+	}
+
+	// dest[i] = AA[i] applied to src, for all i in one pass over src
+	// All operators must be of the same site, and thus of the same size
+	void operator()(VectorVectorWithOffsetType& dest,
+	                const VectorWithOffsetType& src,
+	                const VectorOperatorType& AA,
+	                const FermionSign& fermionSign,
+	                ProgramGlobals::DirectionEnum systemOrEnviron,
+	                BorderEnum corner) const
+	{
+		const SizeType n = AA.size();
+		VectorOperatorType transposed((withLegacyBug_) ? 0 : n);
+		VectorConstOperatorPtrType ops(n);
+		for (SizeType i = 0; i < n; ++i) {
+			if (withLegacyBug_) {
+				ops[i] = &AA[i];
+				continue;
+			}
 
-		if (corner == BORDER_NO) {
-			if (systemOrEnviron == ProgramGlobals::DirectionEnum::EXPAND_SYSTEM)
-				applyLocalOpSystem(dest,src,A,fermionSign);
-			else
-				applyLocalOpEnviron(dest,src,A);
-			return;
+			LegacyBug::transposeOnly(transposed[i], AA[i]);
+			ops[i] = &transposed[i];
 		}
 
-		applyLocalOpCorner(dest,src,A,fermionSign);
+		dest.resize(n);
+		applyLocalOps(dest, src, ops, fermionSign, systemOrEnviron, corner);
 	}
 
 	//! FIXME: we need to make a fast version for when we're just
@@ -238,208 +267,326 @@ public:
 
 private:
 
-	ApplyOperatorLocal(const ApplyOperatorLocal&);
+	// How the product basis is seen by an operator of the site at the border
+	// Element i of src is (a, b, row), where the operator acts on row, and
+	// (a, b) holds the indices the operator does not act on:
+	// LAYOUT_SYSTEM: left is x0 + row*nx, and super is left + b*ns, a = x0
+	// LAYOUT_ENVIRON: right is row + b*nx, and super is a + right*ns
+	// LAYOUT_LEFT_CORNER: super is row + b*ns
+	// LAYOUT_RIGHT_CORNER: super is a + row*ns
+	enum LayoutEnum {LAYOUT_SYSTEM,
+		             LAYOUT_ENVIRON,
+		             LAYOUT_LEFT_CORNER,
+		             LAYOUT_RIGHT_CORNER};
+
+	enum {FIBERS_PER_TASK = 256};
+
+	// The elements of src grouped by (a, b); each group, or fiber, of src
+	// maps into one fiber of dest, so fibers are independent of each other
+	// Elements of fiber f are row[k] and value[k] for start[f] <= k < start[f + 1]
+	struct Fibers {
+		VectorSizeType a;
+		VectorSizeType b;
+		VectorSizeType start;
+		VectorSizeType row;
+		TargetVectorType value;
+	};
+
+	// The operators times the elements of a range of fibers,
+	// each fiber as a small dense matrix-vector product
+	class ParallelApply {
 
-	ApplyOperatorLocal& operator=(const ApplyOperatorLocal&);
+	public:
 
-	void applyLocalOpSystem(VectorWithOffsetType& dest,
-	                        const VectorWithOffsetType& src,
-	                        const OperatorType& A,
-	                        const FermionSign& fermionSign,
-	                        SizeType whichPartOfTheLattice = MIDDLE) const
-	{
-		TargetVectorType dest2(lrs_.super().size(),0.0);
+		ParallelApply(VectorTargetVectorType& dest,
+		              const Fibers& fibers,
+		              const VectorConstOperatorPtrType& ops,
+		              const FermionSign& fermionSign,
+		              const ApplyOperatorLocal& aol,
+		              LayoutEnum layout,
+		              SizeType nx)
+		    : dest_(dest),
+		      fibers_(fibers),
+		      ops_(ops),
+		      fermionSign_(fermionSign),
+		      aol_(aol),
+		      layout_(layout),
+		      nx_(nx),
+		      w_(PsimagLite::Concurrency::storageSize(
+		             PsimagLite::Concurrency::codeSectionParams.npthreads)),
+		      used_(w_.size()),
+		      touched_(w_.size())
+		{}
+
+		SizeType tasks() const
+		{
+			return (fibers_.a.size() + FIBERS_PER_TASK - 1)/FIBERS_PER_TASK;
+		}
 
-		for (SizeType ii=0;ii<src.sectors();ii++) {
-			SizeType i = src.sector(ii);
-			switch (whichPartOfTheLattice) {
-			case MIDDLE:
-				applyLocalOpSystem(dest2,src,A,fermionSign,i);
-				break;
-			case LEFT_CORNER:
-				throw PsimagLite::RuntimeError("applyLocalOpSystem: internal error\n");
-			case RIGHT_CORNER:
-				applyLocalOpRightCorner(dest2,src,A,i);
-				break;
+		void doTask(SizeType taskNumber, SizeType threadNum)
+		{
+			assert(threadNum < w_.size());
+			const SizeType cols = ops_[0]->data.cols();
+			TargetVectorType& w = w_[threadNum];
+			PsimagLite::Vector<bool>::Type& used = used_[threadNum];
+			VectorSizeType& touched = touched_[threadNum];
+			if (w.size() != cols) {
+				w.resize(cols, 0.0);
+				used.resize(cols, false);
+			}
+
+			const SizeType first = taskNumber*FIBERS_PER_TASK;
+			const SizeType last = std::min(first + FIBERS_PER_TASK, fibers_.a.size());
+			for (SizeType f = first; f < last; ++f) {
+				const SizeType a = fibers_.a[f];
+				const SizeType b = fibers_.b[f];
+				for (SizeType o = 0; o < ops_.size(); ++o) {
+					const OperatorType& A = *ops_[o];
+					const RealType sign = aol_.sign(layout_, a, A, fermionSign_);
+					touched.clear();
+					for (SizeType e = fibers_.start[f]; e < fibers_.start[f + 1]; ++e) {
+						const SizeType row = fibers_.row[e];
+						const ComplexOrRealType val = fibers_.value[e]*sign;
+						const SizeType end = A.data.getRowPtr(row + 1);
+						for (SizeType k = A.data.getRowPtr(row); k < end; ++k) {
+							const SizeType col = A.data.getCol(k);
+							if (!used[col]) {
+								used[col] = true;
+								touched.push_back(col);
+							}
+
+							w[col] += val*A.data.getValue(k);
+						}
+					}
+
+					TargetVectorType& dest = dest_[o];
+					for (SizeType t = 0; t < touched.size(); ++t) {
+						const SizeType col = touched[t];
+						dest[aol_.destIndex(layout_, a, b, col, nx_)] += w[col];
+						w[col] = 0.0;
+						used[col] = false;
+					}
+				}
 			}
 		}
 
-		dest.fromFull(dest2,lrs_.super());
-	}
+	private:
 
-	// dest2 = transpose(A) * src; corrected if !withLegacyBug
-	void applyLocalOpSystem(TargetVectorType& dest2,
-	                        const VectorWithOffsetType& src,
-	                        const OperatorType& A,
-	                        const FermionSign& fermionSign,
-	                        SizeType i0) const
+		VectorTargetVectorType& dest_;
+		const Fibers& fibers_;
+		const VectorConstOperatorPtrType& ops_;
+		const FermionSign& fermionSign_;
+		const ApplyOperatorLocal& aol_;
+		LayoutEnum layout_;
+		SizeType nx_;
+		VectorTargetVectorType w_;
+		typename PsimagLite::Vector<PsimagLite::Vector<bool>::Type>::Type used_;
+		typename PsimagLite::Vector<VectorSizeType>::Type touched_;
+	}; // class ParallelApply
+
+	ApplyOperatorLocal(const ApplyOperatorLocal&);
+
+	ApplyOperatorLocal& operator=(const ApplyOperatorLocal&);
+
+	// dest[i] = transpose(ops[i]) * src; corrected if !withLegacyBug
+	void applyLocalOps(VectorVectorWithOffsetType& dest,
+	                   const VectorWithOffsetType& src,
+	                   const VectorConstOperatorPtrType& ops,
+	                   const FermionSign& fermionSign,
+	                   ProgramGlobals::DirectionEnum systemOrEnviron,
+	                   BorderEnum corner) const
 	{
-		SizeType offset = src.offset(i0);
-		SizeType final = offset + src.effectiveSize(i0);
-		SizeType ns = lrs_.left().permutationVector().size();
-		SizeType nx = ns/A.data.rows();
+		assert(ops.size() > 0 && dest.size() == ops.size());
+		const SizeType rows = ops[0]->data.rows();
+		for (SizeType i = 1; i < ops.size(); ++i)
+			if (ops[i]->data.rows() != rows)
+				err("ApplyOperatorLocal: operators of different sizes\n");
+
+		LayoutEnum layout = LAYOUT_SYSTEM;
+		if (corner == BORDER_YES)
+			layout = (lrs_.right().size() == rows) ? LAYOUT_RIGHT_CORNER
+			                                       : LAYOUT_LEFT_CORNER;
+		else if (systemOrEnviron != ProgramGlobals::DirectionEnum::EXPAND_SYSTEM)
+			layout = LAYOUT_ENVIRON;
+
+		const SizeType ns = lrs_.left().size();
+		const SizeType nx = (layout == LAYOUT_SYSTEM) ? ns/rows : rows;
 		if (src.size() != lrs_.super().permutationVector().size())
-			err("applyLocalOpSystem SE\n");
+			err("ApplyOperatorLocal: src does not match the superblock\n");
 
-		PackIndicesType pack1(ns);
-		PackIndicesType pack2(nx);
-		for (SizeType i = offset; i < final; ++i) {
-			SizeType x = 0;
-			SizeType y = 0;
-			pack1.unpack(x,y,lrs_.super().permutation(i));
+		Fibers fibers;
+		findFibers(fibers, src, layout, nx);
 
-			SizeType x0 = 0;
-			SizeType x1 = 0;
-			assert(x<lrs_.left().permutationVector().size());
-			pack2.unpack(x0,x1,lrs_.left().permutation(x));
+		VectorTargetVectorType dest2(ops.size(), TargetVectorType(lrs_.super().size(), 0.0));
+		ParallelApply parallelApply(dest2, fibers, ops, fermionSign, *this, layout, nx);
+		typedef ParallelizerPool<ParallelApply> ParallelizerType;
+		ParallelizerType threaded(PsimagLite::Concurrency::codeSectionParams,
+		                          "ApplyOperatorLocal");
+		threaded.loopCreate(parallelApply);
 
-			const bool isFermion = (A.fermionOrBoson ==
-			                        ProgramGlobals::FermionOrBosonEnum::FERMION);
-			const RealType sign = fermionSign(x0, (isFermion) ? -1 : 1);
-			const SizeType start = A.data.getRowPtr(x1);
-			const SizeType end = A.data.getRowPtr(x1 + 1);
-			for (SizeType k = start; k < end; ++k) {
-				SizeType x1prime = A.data.getCol(k);
-				SizeType xprime = lrs_.left().permutationInverse(x0+x1prime*nx);
-				SizeType j = lrs_.super().permutationInverse(xprime+y*ns);
-				dest2[j] += src.slowAccess(i)*A.data.getValue(k)*sign;
-			}
-		}
+		for (SizeType i = 0; i < ops.size(); ++i)
+			dest[i].fromFull(dest2[i], lrs_.super());
 	}
 
-	void applyLocalOpEnviron(VectorWithOffsetType& dest,
-	                         const VectorWithOffsetType& src,
-	                         const OperatorType& A,
-	                         SizeType whichPartOfTheLattice = MIDDLE) const
+	// Counting sort of the elements of all sectors of src by (a, b)
+	void findFibers(Fibers& fibers,
+	                const VectorWithOffsetType& src,
+	                LayoutEnum layout,
+	                SizeType nx) const
 	{
-		TargetVectorType dest2(lrs_.super().size(),0.0);
-
-		for (SizeType ii=0;ii<src.sectors();ii++) {
-			SizeType i = src.sector(ii);
-			switch (whichPartOfTheLattice) {
-			case MIDDLE:
-				applyLocalOpEnviron(dest2,src,A,i);
-				break;
-			case LEFT_CORNER:
-				applyLocalOpLeftCorner(dest2,src,A,i);
-				break;
-			case RIGHT_CORNER:
-				err("applyLocalOpEnviron: internal error\n");
-			}
+		const SizeType ns = lrs_.left().size();
+		const SizeType nright = lrs_.right().size();
+		SizeType dimA = ns;
+		SizeType dimB = 1;
+		switch (layout) {
+		case LAYOUT_SYSTEM:
+			dimA = nx;
+			dimB = nright;
+			break;
+		case LAYOUT_ENVIRON:
+			dimB = nright/nx;
+			break;
+		case LAYOUT_LEFT_CORNER:
+			dimA = 1;
+			dimB = nright;
+			break;
+		case LAYOUT_RIGHT_CORNER:
+			break;
 		}
 
-		dest.fromFull(dest2,lrs_.super());
-	}
+		SizeType total = 0;
+		for (SizeType ii = 0; ii < src.sectors(); ++ii)
+			total += src.effectiveSize(src.sector(ii));
 
-	// dest2 = transpose(A) * src; corrected if !withLegacyBug
-	void applyLocalOpEnviron(TargetVectorType& dest2,
-	                         const VectorWithOffsetType& src,
-	                         const OperatorType& A,
-	                         SizeType i0) const
-	{
-		SizeType offset = src.offset(i0);
-		SizeType final = offset + src.effectiveSize(i0);
+		const SizeType noFiber = dimA*dimB;
+		VectorSizeType fiberOfKey(dimA*dimB, noFiber);
+		VectorSizeType fiberOfElement(total);
+		VectorSizeType rowOfElement(total);
+		VectorSizeType count;
+		fibers.a.clear();
+		fibers.b.clear();
 
-		SizeType ns = lrs_.left().size();
-		SizeType nx = A.data.rows();
-		PackIndicesType pack1(ns);
-		PackIndicesType pack2(nx);
-
-		for (SizeType i = offset; i < final; ++i) {
-			SizeType x = 0;
-			SizeType y = 0;
-			pack1.unpack(x,y,lrs_.super().permutation(i));
-			SizeType y0 = 0;
-			SizeType y1 = 0;
-			pack2.unpack(y0,y1,lrs_.right().permutation(y));
-			const bool isFermion = (A.fermionOrBoson ==
-			                        ProgramGlobals::FermionOrBosonEnum::FERMION);
-			const RealType sign = lrs_.left().fermionicSign(x, (isFermion) ? -1 : 1);
-			const SizeType start = A.data.getRowPtr(y0);
-			const SizeType end = A.data.getRowPtr(y0 + 1);
-			for (SizeType k = start; k < end; ++k) {
-				SizeType y0prime = A.data.getCol(k);
-				SizeType yprime = lrs_.right().permutationInverse(y0prime+y1*nx);
-				SizeType j = lrs_.super().permutationInverse(x+yprime*ns);
-				dest2[j] += src.slowAccess(i)*A.data.getValue(k)*sign;
+		SizeType e = 0;
+		for (SizeType ii = 0; ii < src.sectors(); ++ii) {
+			const SizeType i0 = src.sector(ii);
+			const SizeType offset = src.offset(i0);
+			const SizeType final = offset + src.effectiveSize(i0);
+			for (SizeType i = offset; i < final; ++i) {
+				SizeType a = 0;
+				SizeType b = 0;
+				unpack(a, b, rowOfElement[e], i, layout, nx);
+				const SizeType key = a + b*dimA;
+				assert(key < fiberOfKey.size());
+				if (fiberOfKey[key] == noFiber) {
+					fiberOfKey[key] = fibers.a.size();
+					fibers.a.push_back(a);
+					fibers.b.push_back(b);
+					count.push_back(0);
+				}
+
+				fiberOfElement[e] = fiberOfKey[key];
+				++count[fiberOfElement[e]];
+				++e;
 			}
 		}
-	}
-
-	// dest2 = transpose(A) * src; corrected if !withLegacyBug
-	void applyLocalOpLeftCorner(TargetVectorType& dest2,
-	                            const VectorWithOffsetType& src,
-	                            const OperatorType& A,
-	                            SizeType i0) const
-	{
-		SizeType offset = src.offset(i0);
-		SizeType final = offset + src.effectiveSize(i0);
 
-		SizeType ns = lrs_.left().size();
-		PackIndicesType pack(ns);
+		const SizeType nfibers = fibers.a.size();
+		fibers.start.resize(nfibers + 1);
+		fibers.start[0] = 0;
+		for (SizeType f = 0; f < nfibers; ++f)
+			fibers.start[f + 1] = fibers.start[f] + count[f];
 
-		for (SizeType i = offset; i < final; ++i) {
-			SizeType x = 0;
-			SizeType y = 0;
-			pack.unpack(x,y,lrs_.super().permutation(i));
+		for (SizeType f = 0; f < nfibers; ++f)
+			count[f] = fibers.start[f];
 
-			const SizeType start = A.data.getRowPtr(x);
-			const SizeType end = A.data.getRowPtr(x + 1);
-			for (SizeType k = start; k < end; ++k) {
-				SizeType xprime = A.data.getCol(k);
-				SizeType j = lrs_.super().permutationInverse(xprime+y*ns);
-				dest2[j] += src.slowAccess(i)*A.data.getValue(k);
+		fibers.row.resize(total);
+		fibers.value.resize(total);
+		e = 0;
+		for (SizeType ii = 0; ii < src.sectors(); ++ii) {
+			const SizeType i0 = src.sector(ii);
+			const SizeType n = src.effectiveSize(i0);
+			for (SizeType i = 0; i < n; ++i) {
+				const SizeType k = count[fiberOfElement[e]]++;
+				fibers.row[k] = rowOfElement[e];
+				fibers.value[k] = src.fastAccess(i0, i);
+				++e;
 			}
 		}
 	}
 
-	// dest2 = transpose(A) * src; corrected if !withLegacyBug
-	void applyLocalOpRightCorner(TargetVectorType& dest2,
-	                             const VectorWithOffsetType& src,
-	                             const OperatorType& A,
-	                             SizeType i0) const
+	void unpack(SizeType& a,
+	            SizeType& b,
+	            SizeType& row,
+	            SizeType i,
+	            LayoutEnum layout,
+	            SizeType nx) const
 	{
-		SizeType offset = src.offset(i0);
-		SizeType final = offset + src.effectiveSize(i0);
-		SizeType ns = lrs_.left().permutationVector().size();
-		if (src.size() != lrs_.super().permutationVector().size())
-			err("applyLocalOpSystem SE\n");
-
-		PackIndicesType pack(ns);
-
-		for (SizeType i = offset; i < final; ++i) {
-			SizeType x = 0;
-			SizeType y = 0;
-			pack.unpack(x,y,lrs_.super().permutation(i));
-
-			if (x >= lrs_.left().permutationVector().size())
-				err("applyLocalOpSystem S\n");
-
-			const bool isFermion = (A.fermionOrBoson ==
-			                        ProgramGlobals::FermionOrBosonEnum::FERMION);
-			const RealType sign = lrs_.left().fermionicSign(x, (isFermion) ? -1 : 1);
-			const SizeType start = A.data.getRowPtr(y);
-			const SizeType end = A.data.getRowPtr(y + 1);
-			for (SizeType k = start; k < end; ++k) {
-				SizeType yprime = A.data.getCol(k);
-				SizeType j = lrs_.super().permutationInverse(x+yprime*ns);
-				dest2[j] += src.slowAccess(i)*A.data.getValue(k)*sign;
-			}
+		const SizeType ns = lrs_.left().size();
+		const SizeType super = lrs_.super().permutation(i);
+		const SizeType x = super % ns;
+		const SizeType y = super/ns;
+		switch (layout) {
+		case LAYOUT_SYSTEM:
+			assert(x < lrs_.left().permutationVector().size());
+			a = lrs_.left().permutation(x) % nx;
+			row = lrs_.left().permutation(x)/nx;
+			b = y;
+			break;
+		case LAYOUT_ENVIRON:
+			a = x;
+			row = lrs_.right().permutation(y) % nx;
+			b = lrs_.right().permutation(y)/nx;
+			break;
+		case LAYOUT_LEFT_CORNER:
+			a = 0;
+			row = x;
+			b = y;
+			break;
+		case LAYOUT_RIGHT_CORNER:
+			a = x;
+			row = y;
+			b = 0;
+			break;
 		}
 	}
 
-	// entry point for corner cases. These are all when expanding ths system
-	void applyLocalOpCorner(VectorWithOffsetType& dest,
-	                        const VectorWithOffsetType& src,
-	                        const OperatorType& A,
-	                        const FermionSign& fermionSign) const
+	SizeType destIndex(LayoutEnum layout,
+	                   SizeType a,
+	                   SizeType b,
+	                   SizeType col,
+	                   SizeType nx) const
 	{
-		if (lrs_.right().size() == A.data.rows()) { // right corner
-			applyLocalOpSystem(dest,src,A,fermionSign,RIGHT_CORNER);
-			return;
+		const SizeType ns = lrs_.left().size();
+		switch (layout) {
+		case LAYOUT_SYSTEM:
+			return lrs_.super().permutationInverse(
+			            lrs_.left().permutationInverse(a + col*nx) + b*ns);
+		case LAYOUT_ENVIRON:
+			return lrs_.super().permutationInverse(
+			            a + lrs_.right().permutationInverse(col + b*nx)*ns);
+		case LAYOUT_LEFT_CORNER:
+			return lrs_.super().permutationInverse(col + b*ns);
+		case LAYOUT_RIGHT_CORNER:
+			break;
 		}
 
-		applyLocalOpEnviron(dest,src,A,LEFT_CORNER);
+		return lrs_.super().permutationInverse(a + col*ns);
+	}
+
+	// The sign of fiber (a, b) depends only on a
+	RealType sign(LayoutEnum layout,
+	              SizeType a,
+	              const OperatorType& A,
+	              const FermionSign& fermionSign) const
+	{
+		if (layout == LAYOUT_LEFT_CORNER) return 1;
+
+		const bool isFermion = (A.fermionOrBoson ==
+		                        ProgramGlobals::FermionOrBosonEnum::FERMION);
+		if (!isFermion) return 1;
+
+		return (layout == LAYOUT_SYSTEM) ? fermionSign(a, -1)
+		                                 : lrs_.left().fermionicSign(a, -1);
 	}
 
 	const LeftRightSuperType& lrs_;
@@ -0,0 +1,267 @@
+#ifndef ASYNC_OUTPUT_WRITER_H
+#define ASYNC_OUTPUT_WRITER_H
+#include "Vector.h"
+#include "PsimagLite.h"
+#include "Io/IoSelector.h"
+#include <deque>
+#include <functional>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <cassert>
+#ifdef USE_PTHREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+#ifdef USE_SIGNALS
+#include <signal.h>
+#endif
+
+// Writes snapshots to the data file in a background thread,
+// enabled with SolverOptions=asyncWrite
+// Each job owns copies of what it writes (the parts of DmrgSerializer that
+// it owns, TimeSerializer), so the engine may change its own objects after
+// push(); jobs are written in the order they were pushed
+// HDF5 is not thread safe, so the background thread runs jobs only while a
+// Window is open, and the main thread must not use HDF5, for any file,
+// while it holds a Window; DmrgSolver opens one around each
+// diagonalization. Outside windows, flush() and a full queue run the
+// pending jobs in the calling thread
+// Without USE_PTHREADS, or if not enabled, push() writes at once
+namespace Dmrg {
+
+class AsyncOutputWriter {
+
+	typedef std::chrono::steady_clock ClockType;
+
+public:
+
+	typedef PsimagLite::IoSelector::Out IoOutType;
+	typedef std::function<void (IoOutType&)> JobType;
+
+	enum {MAX_PENDING = 4};
+
+	AsyncOutputWriter(IoOutType& io, bool enabled)
+	    : io_(io),
+	      enabled_(enabled),
+	      jobs_(0),
+	      writeSeconds_(0),
+	      waitSeconds_(0)
+#ifdef USE_PTHREADS
+	      ,shutdown_(false),
+	      busy_(false),
+	      window_(false)
+#endif
+	{}
+
+	~AsyncOutputWriter()
+	{
+#ifdef USE_PTHREADS
+		if (!worker_.joinable()) return;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			shutdown_ = true;
+		}
+
+		cvWork_.notify_one();
+		worker_.join();
+#endif
+	}
+
+	// While alive, the background thread may write; see the top of this file
+	class Window {
+
+	public:
+
+		Window(AsyncOutputWriter* writer)
+		    : writer_(writer)
+		{
+			if (writer_) writer_->openWindow();
+		}
+
+		~Window()
+		{
+			if (writer_) writer_->closeWindow();
+		}
+
+	private:
+
+		Window(const Window&);
+
+		Window& operator=(const Window&);
+
+		AsyncOutputWriter* writer_;
+	};
+
+	bool enabled() const { return enabled_; }
+
+	const IoOutType& io() const { return io_; }
+
+	void push(const JobType& job)
+	{
+		++jobs_;
+#ifdef USE_PTHREADS
+		if (enabled_) {
+			if (!worker_.joinable())
+				worker_ = std::thread(&AsyncOutputWriter::workerLoop, this);
+
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				assert(!window_);
+				queue_.push_back(job);
+				if (queue_.size() <= MAX_PENDING) return;
+			}
+
+			runPending();
+			return;
+		}
+#endif
+
+		run(job);
+	}
+
+	// writes all pending jobs, and rethrows the first error of a job
+	void flush()
+	{
+		runPending();
+		if (!error_) return;
+		std::exception_ptr e = error_;
+		error_ = std::exception_ptr();
+		std::rethrow_exception(e);
+	}
+
+	// as flush(), but errors are only reported; for destructors
+	void wait()
+	{
+		runPending();
+		if (!error_) return;
+		try {
+			std::rethrow_exception(error_);
+		} catch (std::exception& e) {
+			std::cerr<<"AsyncOutputWriter: "<<e.what()<<"\n";
+		} catch (...) {
+			std::cerr<<"AsyncOutputWriter: unknown error\n";
+		}
+
+		error_ = std::exception_ptr();
+	}
+
+	void printStats(std::ostream& os) const
+	{
+		if (!enabled_) return;
+		os<<"AsyncOutputWriter: jobs="<<jobs_;
+		os<<" writeSeconds="<<writeSeconds_;
+		os<<" waitSeconds="<<waitSeconds_<<"\n";
+	}
+
+private:
+
+	void run(const JobType& job)
+	{
+		ClockType::time_point t0 = ClockType::now();
+		try {
+			if (!error_) job(io_);
+		} catch (...) {
+			error_ = std::current_exception();
+		}
+
+		std::chrono::duration<double> spent = ClockType::now() - t0;
+		writeSeconds_ += spent.count();
+	}
+
+	// in the calling thread, outside windows, when the worker is idle
+	void runPending()
+	{
+#ifdef USE_PTHREADS
+		while (true) {
+			JobType job;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				assert(!window_ && !busy_);
+				if (queue_.empty()) return;
+				job = queue_.front();
+				queue_.pop_front();
+			}
+
+			run(job);
+		}
+#endif
+	}
+
+#ifdef USE_PTHREADS
+	void openWindow()
+	{
+		if (!enabled_) return;
+		std::unique_lock<std::mutex> lock(mutex_);
+		window_ = true;
+		cvWork_.notify_one();
+	}
+
+	// waits for the job being written, if any; the others stay queued
+	void closeWindow()
+	{
+		if (!enabled_) return;
+		ClockType::time_point t0 = ClockType::now();
+		std::unique_lock<std::mutex> lock(mutex_);
+		window_ = false;
+		cvDone_.wait(lock, [this]{ return !busy_; });
+		std::chrono::duration<double> waited = ClockType::now() - t0;
+		waitSeconds_ += waited.count();
+	}
+
+	void workerLoop()
+	{
+#ifdef USE_SIGNALS
+		// signals are handled by the main thread
+		sigset_t all;
+		sigfillset(&all);
+		pthread_sigmask(SIG_BLOCK, &all, 0);
+#endif
+		while (true) {
+			JobType job;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				cvWork_.wait(lock, [this]{ return shutdown_ || (window_ && !queue_.empty()); });
+				if (shutdown_) return;
+				job = queue_.front();
+				queue_.pop_front();
+				busy_ = true;
+			}
+
+			run(job);
+
+			std::unique_lock<std::mutex> lock(mutex_);
+			busy_ = false;
+			cvDone_.notify_all();
+		}
+	}
+#else
+	void openWindow() {}
+
+	void closeWindow() {}
+#endif
+
+	AsyncOutputWriter(const AsyncOutputWriter&);
+
+	AsyncOutputWriter& operator=(const AsyncOutputWriter&);
+
+	IoOutType& io_;
+	bool enabled_;
+	SizeType jobs_;
+	double writeSeconds_;
+	double waitSeconds_;
+	std::exception_ptr error_;
+#ifdef USE_PTHREADS
+	bool shutdown_;
+	bool busy_;
+	bool window_;
+	std::deque<JobType> queue_;
+	std::thread worker_;
+	std::mutex mutex_;
+	std::condition_variable cvWork_;
+	std::condition_variable cvDone_;
+#endif
+};
+}
+#endif // ASYNC_OUTPUT_WRITER_H
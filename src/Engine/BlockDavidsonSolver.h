@@ -0,0 +1,268 @@
+#ifndef BLOCK_DAVIDSON_SOLVER_H
+#define BLOCK_DAVIDSON_SOLVER_H
+#include "Vector.h"
+#include "Matrix.h"
+#include "PsimagLite.h"
+#include "Random48.h"
+#include "ProgressIndicator.h"
+#include "DavidsonPreconditioner.h"
+
+// Block Davidson for the lowest nstates eigenpairs of the superblock sector
+// All states share one subspace, which grows each iteration by one
+// correction per Ritz pair not yet converged, t = M(theta) r if a
+// DavidsonPreconditioner is given, or t = r otherwise
+// Converged pairs are kept in the subspace but no longer corrected
+// The subspace is restarted with the current Ritz vectors
+// once it cannot take one more block
+// Levels not converged after maxIterations are reported, and can be
+// queried with converged() and residuals()
+namespace Dmrg {
+
+template<typename MatrixVectorType, typename VectorType>
+class BlockDavidsonSolver {
+
+	typedef typename VectorType::value_type ComplexOrRealType;
+	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
+	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
+	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+
+public:
+
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef DavidsonPreconditioner<ComplexOrRealType> PreconditionerType;
+
+	BlockDavidsonSolver(const MatrixVectorType& h,
+	                    const PreconditionerType* precond,
+	                    SizeType maxIterations,
+	                    RealType residualTolerance,
+	                    SizeType maxSubspace = 20)
+	    : h_(h),
+	      precond_(precond),
+	      maxIterations_(maxIterations),
+	      tolerance_(residualTolerance),
+	      maxSubspace_(maxSubspace),
+	      iterations_(0),
+	      matvecs_(0),
+	      residual_(0),
+	      progress_("BlockDavidsonSolver")
+	{}
+
+	// energy and z of level excited; all levels up to it are in energies()
+	void computeOneState(RealType& energy,
+	                     VectorType& z,
+	                     const VectorType& initialVector,
+	                     SizeType excited)
+	{
+		VectorVectorType states;
+		computeStates(energies_, states, initialVector, excited + 1);
+		energy = energies_[excited];
+		z = states[excited];
+	}
+
+	void computeStates(VectorRealType& energies,
+	                   VectorVectorType& z,
+	                   const VectorType& initialVector,
+	                   SizeType nstates)
+	{
+		const SizeType n = h_.rows();
+		if (nstates > n)
+			err("BlockDavidsonSolver: more states than the size of the matrix\n");
+
+		const SizeType maxSubspace = std::max(maxSubspace_, 3*nstates);
+		VectorVectorType v;
+		VectorVectorType w;
+		VectorVectorType u(nstates);
+		VectorVectorType hu(nstates);
+		VectorRealType theta(nstates, 0.0);
+		iterations_ = matvecs_ = 0;
+		residuals_.assign(nstates, 0.0);
+
+		// the guess, and random vectors for the other states
+		VectorVectorType t(nstates, initialVector);
+		PsimagLite::Random48<RealType> rng(3433117);
+		for (SizeType s = 1; s < nstates; ++s)
+			for (SizeType i = 0; i < n; ++i)
+				t[s][i] = rng() - 0.5;
+
+		for (; iterations_ < maxIterations_; ++iterations_) {
+			SizeType added = 0;
+			for (SizeType s = 0; s < t.size(); ++s)
+				if (appendOrthonormal(v, w, t[s])) ++added;
+
+			if (added == 0) break;
+
+			if (v.size() < nstates)
+				err("BlockDavidsonSolver: initial block is linearly dependent\n");
+
+			SizeType k = v.size();
+			MatrixType hs(k, k);
+			for (SizeType i = 0; i < k; ++i)
+				for (SizeType j = 0; j < k; ++j)
+					hs(i, j) = dot(v[i], w[j]);
+
+			VectorRealType eigs(k);
+			PsimagLite::diag(hs, eigs, 'V');
+
+			t.clear();
+			residual_ = 0;
+			for (SizeType s = 0; s < nstates; ++s) {
+				theta[s] = eigs[s];
+				combine(u[s], v, hs, s);
+				combine(hu[s], w, hs, s);
+
+				VectorType r(n);
+				for (SizeType i = 0; i < n; ++i)
+					r[i] = hu[s][i] - theta[s]*u[s][i];
+
+				RealType rnorm = PsimagLite::norm(r);
+				residuals_[s] = rnorm;
+				if (rnorm > residual_) residual_ = rnorm;
+				if (rnorm < tolerance_) continue;
+
+				t.push_back(r);
+				if (!precond_) continue;
+				// only the lowest state is clamped, see DavidsonPreconditioner
+				const RealType shift = (s == 0) ? std::min(theta[s], precond_->lowest())
+				                                : theta[s];
+				(*precond_)(t.back(), r, shift);
+			}
+
+			if (t.size() == 0) {
+				++iterations_;
+				break;
+			}
+
+			if (k + t.size() <= maxSubspace) continue;
+
+			// restart with the Ritz vectors, whose images are known
+			v.clear();
+			w.clear();
+			for (SizeType s = 0; s < nstates; ++s)
+				appendOrthonormalNoMatvec(v, w, u[s], hu[s]);
+		}
+
+		energies = theta;
+		z = u;
+
+		if (converged()) return;
+
+		PsimagLite::OstringStream msg;
+		msg<<"WARNING: not converged after "<<iterations_<<" iterations, levels";
+		for (SizeType s = 0; s < nstates; ++s)
+			if (residuals_[s] >= tolerance_) msg<<" "<<s;
+		msg<<" with residuals";
+		for (SizeType s = 0; s < nstates; ++s)
+			if (residuals_[s] >= tolerance_) msg<<" "<<residuals_[s];
+		msg<<" tolerance="<<tolerance_;
+		progress_.printline(msg, std::cout);
+	}
+
+	const VectorRealType& energies() const { return energies_; }
+
+	SizeType iterations() const { return iterations_; }
+
+	SizeType matvecs() const { return matvecs_; }
+
+	// largest residual of the states returned
+	RealType residual() const { return residual_; }
+
+	// residual of each state returned
+	const VectorRealType& residuals() const { return residuals_; }
+
+	bool converged() const { return (residual_ < tolerance_); }
+
+private:
+
+	static ComplexOrRealType dot(const VectorType& a, const VectorType& b)
+	{
+		ComplexOrRealType sum = 0;
+		for (SizeType i = 0; i < a.size(); ++i)
+			sum += PsimagLite::conj(a[i])*b[i];
+		return sum;
+	}
+
+	// u = sum_i v[i] c(i, col)
+	static void combine(VectorType& u,
+	                    const VectorVectorType& v,
+	                    const MatrixType& c,
+	                    SizeType col)
+	{
+		const SizeType n = v[0].size();
+		u.resize(n);
+		for (SizeType j = 0; j < n; ++j)
+			u[j] = 0.0;
+
+		for (SizeType i = 0; i < v.size(); ++i)
+			for (SizeType j = 0; j < n; ++j)
+				u[j] += v[i][j]*c(i, col);
+	}
+
+	// Gram-Schmidt twice; returns the norm of what remains of t
+	static RealType orthogonalize(VectorType& t, const VectorVectorType& v)
+	{
+		for (SizeType pass = 0; pass < 2; ++pass) {
+			for (SizeType i = 0; i < v.size(); ++i) {
+				ComplexOrRealType c = dot(v[i], t);
+				for (SizeType j = 0; j < t.size(); ++j)
+					t[j] -= c*v[i][j];
+			}
+		}
+
+		return PsimagLite::norm(t);
+	}
+
+	bool appendOrthonormal(VectorVectorType& v, VectorVectorType& w, VectorType& t)
+	{
+		RealType norma = orthogonalize(t, v);
+		if (norma < 1e-12) return false;
+		for (SizeType j = 0; j < t.size(); ++j)
+			t[j] /= norma;
+
+		v.push_back(t);
+		VectorType ht(t.size(), 0.0);
+		h_.matrixVectorProduct(ht, t);
+		++matvecs_;
+		w.push_back(ht);
+		return true;
+	}
+
+	// appends t (with H t = ht already known) orthonormalized against v
+	static bool appendOrthonormalNoMatvec(VectorVectorType& v,
+	                                      VectorVectorType& w,
+	                                      VectorType t,
+	                                      VectorType ht)
+	{
+		for (SizeType i = 0; i < v.size(); ++i) {
+			ComplexOrRealType c = dot(v[i], t);
+			for (SizeType j = 0; j < t.size(); ++j) {
+				t[j] -= c*v[i][j];
+				ht[j] -= c*w[i][j];
+			}
+		}
+
+		RealType norma = PsimagLite::norm(t);
+		if (norma < 1e-6) return false;
+		for (SizeType j = 0; j < t.size(); ++j) {
+			t[j] /= norma;
+			ht[j] /= norma;
+		}
+
+		v.push_back(t);
+		w.push_back(ht);
+		return true;
+	}
+
+	const MatrixVectorType& h_;
+	const PreconditionerType* precond_;
+	SizeType maxIterations_;
+	RealType tolerance_;
+	SizeType maxSubspace_;
+	SizeType iterations_;
+	SizeType matvecs_;
+	RealType residual_;
+	VectorRealType residuals_;
+	VectorRealType energies_;
+	PsimagLite::ProgressIndicator progress_;
+};
+}
+#endif // BLOCK_DAVIDSON_SOLVER_H
@@ -87,6 +87,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "CrsMatrix.h"
 #include "PsimagLite.h"
 #include "EnforcePhase.h"
+#include "SubspaceIterationDiag.h"
 #include "Io/IoSelector.h"
 
 namespace Dmrg {
@@ -291,6 +292,43 @@ public:
 		EnforcePhase<ComplexOrRealType>::enforcePhase(data_[m]);
 	}
 
+	void eigenvaluesOfBlock(SizeType m, VectorRealType& eigsTmp) const
+	{
+		assert(m < data_.size());
+		MatrixInBlockTemplate tmp = data_[m];
+		PsimagLite::diag(tmp, eigsTmp, 'N');
+	}
+
+	// On return only the last kept columns of block m are eigenvectors,
+	// those of its kept largest eigenvalues; the other columns are zero
+	// Returns false if it had to fall back to full diagonalization
+	bool diagTopAndEnforcePhase(SizeType m, SizeType kept)
+	{
+		assert(m < data_.size());
+		const SizeType n = data_[m].rows();
+		assert(kept <= n);
+		if (kept == 0) {
+			data_[m].setTo(0.0);
+			return true;
+		}
+
+		VectorRealType eigsTmp;
+		MatrixInBlockTemplate x;
+		SubspaceIterationDiag<MatrixInBlockTemplate> subspace(data_[m], kept);
+		if (!subspace.worthIt() || !subspace(x, eigsTmp, 1e-12)) {
+			diagAndEnforcePhase(m, eigsTmp, 'V');
+			return false;
+		}
+
+		EnforcePhase<ComplexOrRealType>::enforcePhase(x);
+		data_[m].setTo(0.0);
+		for (SizeType j = 0; j < kept; ++j)
+			for (SizeType i = 0; i < n; ++i)
+				data_[m](i, n - kept + j) = x(i, j);
+
+		return true;
+	}
+
 	const MatrixInBlockTemplate& operator()(SizeType i) const
 	{
 		assert(i < data_.size());
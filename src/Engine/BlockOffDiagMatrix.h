@@ -253,7 +253,9 @@ public:
 		sparse.checkValidity();
 	}
 
-	void transform(const BlockDiagonalMatrixType& f)
+	// f is a BlockDiagonalMatrix, or a view with the same interface
+	template<typename SomeBlockDiagonalType>
+	void transform(const SomeBlockDiagonalType& f)
 	{
 		if (offsetCols_.size() != 0)
 			err("BlockOffDiagMatrix::transform() only for square matrix\n");
@@ -265,8 +267,9 @@ public:
 				MatrixBlockType* mptr = data_(ipatch, jpatch);
 				if (mptr == 0) continue;
 				MatrixBlockType& m = *mptr;
-				const MatrixBlockType& mRight = f(jpatch);
-				const MatrixBlockType& mLeft = f(ipatch);
+				typedef typename SomeBlockDiagonalType::BuildingBlockType BuildingBlockType;
+				const BuildingBlockType& mRight = f(jpatch);
+				const BuildingBlockType& mLeft = f(ipatch);
 
 				if (mLeft.rows() == 0 || mRight.rows() == 0) {
 					m.clear();
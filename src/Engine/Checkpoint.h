@@ -87,6 +87,10 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "ProgramGlobals.h"
 #include "Io/IoSelector.h"
 #include "DiskOrMemoryStack.h"
+#include <fstream>
+#include <map>
+#include <set>
+#include <unistd.h>
 
 namespace Dmrg {
 
@@ -129,7 +133,9 @@ public:
 	              isObserveCode),
 	    progress_("Checkpoint"),
 	    energyFromFile_(0.0),
-	    dummyBwo_("dummy")
+	    dummyBwo_("dummy"),
+	    blobsInFile_(0),
+	    isFork_(false)
 	{
 		if (parameters_.autoRestart) isRestart_ = true;
 
@@ -182,7 +188,7 @@ public:
 
 	~Checkpoint()
 	{
-		if (parameters_.options.find("noSaveStacks") != PsimagLite::String::npos)
+		if (parameters_.options.find("noSaveStacks") != PsimagLite::String::npos || isFork_)
 			return;
 
 		loadStacksMemoryToDisk();
@@ -202,6 +208,70 @@ public:
 		sayWritingDone();
 	}
 
+	// Writes to the blob file only the stack entries that no previous call
+	// has written, and to filename a manifest with the blob of each entry
+	// Blobs are not removed from a blob file, so that older manifests
+	// remain valid; instead, when most blobs of the blob file are no longer
+	// used by any manifest, a new blob file is started, and blob files
+	// that no manifest uses are deleted
+	void checkpointStacksIncremental(PsimagLite::String filename) const
+	{
+		sayAboutToWrite();
+
+		// the caller has overwritten filename, and with it its manifest
+		manifests_.erase(filename);
+
+		if (blobFile_ == "" || blobsMostlyUnused()) openBlobs();
+
+		VectorSizeType systemBlobs;
+		VectorSizeType environBlobs;
+		SizeType written = 0;
+
+		{
+			typename IoType::Out ioBlobs(blobFile_, IoType::ACC_RDW);
+			written += writeBlobs(systemBlobs, systemStack_, ioBlobs);
+			written += writeBlobs(environBlobs, envStack_, ioBlobs);
+			ioBlobs.write(blobsInFile_,
+			              "Blobs/Size",
+			              IoType::Out::Serializer::ALLOW_OVERWRITE);
+			ioBlobs.close();
+		}
+
+		// forget entries that were popped
+		MapSizeType blobOfEntry;
+		rememberBlobs(blobOfEntry, systemStack_, systemBlobs);
+		rememberBlobs(blobOfEntry, envStack_, environBlobs);
+		blobOfEntry_.swap(blobOfEntry);
+
+		typename IoType::Out ioOut(filename, IoType::ACC_RDW);
+		ioOut.createGroup("IncrementalStacks");
+		ioOut.write(blobFile_, "IncrementalStacks/BlobFile");
+		ioOut.write(systemBlobs, "IncrementalStacks/system");
+		ioOut.write(environBlobs, "IncrementalStacks/environ");
+		ioOut.close();
+
+		Manifest& manifest = manifests_[filename];
+		manifest.blobFile = blobFile_;
+		manifest.blobs = systemBlobs;
+		manifest.blobs.insert(manifest.blobs.end(), environBlobs.begin(), environBlobs.end());
+
+		removeUnusedBlobFiles();
+
+		PsimagLite::OstringStream msg;
+		msg<<"Wrote "<<written<<" of "<<(systemBlobs.size() + environBlobs.size());
+		msg<<" stack entries to "<<blobFile_;
+		progress_.printline(msg, std::cout);
+		sayWritingDone();
+	}
+
+	// the blob files that this run has written to, and that still exist
+	VectorStringType blobFiles() const
+	{
+		VectorStringType files = blobFiles_;
+		if (restartBlobFile_ != "") files.push_back(restartBlobFile_);
+		return files;
+	}
+
 	// Not related to stacks
 	void write(const BasisWithOperatorsType &pS,
 	           const BasisWithOperatorsType &pE,
@@ -253,6 +323,15 @@ public:
 		                                                         shrinkInternal(systemStack_);
 	}
 
+	// Copies the stacks of other, see MettsChains=; a fork does not
+	// write its stacks to disk
+	void forkStacks(const Checkpoint& other)
+	{
+		isFork_ = true;
+		systemStack_.copyFrom(other.systemStack_);
+		envStack_.copyFrom(other.envStack_);
+	}
+
 	bool isRestart() const { return isRestart_; }
 
 	SizeType stackSize(typename ProgramGlobals::SysOrEnvEnum what) const
@@ -273,6 +352,16 @@ public:
 
 private:
 
+	typedef std::map<SizeType, SizeType> MapSizeType;
+
+	// IncrementalStacks of a recovery file, with all its blobs
+	struct Manifest {
+		PsimagLite::String blobFile;
+		VectorSizeType blobs;
+	};
+
+	typedef std::map<PsimagLite::String, Manifest> MapManifestType;
+
 	void sayAboutToWrite() const
 	{
 		PsimagLite::OstringStream msg;
@@ -402,6 +491,17 @@ private:
 
 	void loadStacksDiskToMemory()
 	{
+		PsimagLite::String blobFile;
+		try {
+			IoType::In ioIn(parameters_.checkpoint.filename());
+			ioIn.read(blobFile, "IncrementalStacks/BlobFile");
+		} catch (std::exception&) {}
+
+		if (blobFile != "") {
+			loadStacksFromBlobs(blobFile);
+			return;
+		}
+
 		DiskStackType systemDisk(parameters_.checkpoint.filename(),
 		                         isRestart_,
 		                         "system",
@@ -418,6 +518,173 @@ private:
 		DiskOrMemoryStackType::loadStack(envStack_, envDisk);
 	}
 
+	void loadStacksFromBlobs(PsimagLite::String blobFile)
+	{
+		VectorSizeType systemBlobs;
+		VectorSizeType environBlobs;
+
+		{
+			IoType::In ioIn(parameters_.checkpoint.filename());
+			ioIn.read(systemBlobs, "IncrementalStacks/system");
+			ioIn.read(environBlobs, "IncrementalStacks/environ");
+		}
+
+		PsimagLite::OstringStream msg;
+		msg<<"Loading sys. and env. stacks from "<<blobFile<<"...";
+		progress_.printline(msg,std::cout);
+
+		IoType::In ioBlobs(blobFile);
+		loadFromBlobs(systemStack_, systemBlobs, ioBlobs);
+		loadFromBlobs(envStack_, environBlobs, ioBlobs);
+
+		if (blobFile.find(blobFilePrefix()) != 0) return;
+
+		// this run appends to the same blob file; older recovery files
+		// may use it, so it is not deleted while the run is going
+		ioBlobs.read(blobsInFile_, "Blobs/Size");
+		blobFile_ = blobFile;
+		restartBlobFile_ = blobFile;
+		rememberBlobs(blobOfEntry_, systemStack_, systemBlobs);
+		rememberBlobs(blobOfEntry_, envStack_, environBlobs);
+	}
+
+	void loadFromBlobs(DiskOrMemoryStackType& stack,
+	                   const VectorSizeType& blobs,
+	                   IoType::In& ioBlobs) const
+	{
+		for (SizeType i = 0; i < blobs.size(); ++i) {
+			BasisWithOperatorsType b(ioBlobs, "Blobs/" + ttos(blobs[i]), isObserveCode_);
+			stack.push(b);
+		}
+	}
+
+	// starts a new blob file, named as the output file but ending in
+	// Blobs<n>.hd5, with the smallest n of a file that does not exist;
+	// existing files, maybe of other runs, are never overwritten
+	void openBlobs() const
+	{
+		const PsimagLite::String prefix = blobFilePrefix();
+		PsimagLite::String file;
+		for (SizeType n = 0; ; ++n) {
+			file = prefix + ttos(n) + ".hd5";
+			if (!std::ifstream(file.c_str()).good()) break;
+		}
+
+		if (blobFile_ != "") {
+			PsimagLite::OstringStream msg;
+			msg<<"Only "<<usedBlobs()<<" of the "<<blobsInFile_<<" blobs of ";
+			msg<<blobFile_<<" are in use; starting "<<file;
+			progress_.printline(msg, std::cout);
+		}
+
+		blobFile_ = file;
+		blobsInFile_ = 0;
+		blobOfEntry_.clear();
+		blobFiles_.push_back(file);
+		typename IoType::Out ioOut(file, IoType::ACC_TRUNC);
+		ioOut.createGroup("Blobs");
+		ioOut.write(blobsInFile_, "Blobs/Size");
+		ioOut.close();
+	}
+
+	// output file without its extension, followed by Blobs
+	PsimagLite::String blobFilePrefix() const
+	{
+		const PsimagLite::String& filename = parameters_.filename;
+		size_t slash = filename.find_last_of("/");
+		size_t dot = filename.find_last_of(".");
+		if (dot == PsimagLite::String::npos || (slash != PsimagLite::String::npos && dot < slash))
+			dot = filename.length();
+
+		return filename.substr(0, dot) + "Blobs";
+	}
+
+	// the blobs of the blob file that a manifest or the current stacks use
+	SizeType usedBlobs() const
+	{
+		std::set<SizeType> used;
+		typename MapManifestType::const_iterator it = manifests_.begin();
+		for (; it != manifests_.end(); ++it) {
+			if (it->second.blobFile != blobFile_) continue;
+			used.insert(it->second.blobs.begin(), it->second.blobs.end());
+		}
+
+		insertUsedBlobs(used, systemStack_);
+		insertUsedBlobs(used, envStack_);
+		return used.size();
+	}
+
+	void insertUsedBlobs(std::set<SizeType>& used, const DiskOrMemoryStackType& stack) const
+	{
+		for (SizeType i = 0; i < stack.size(); ++i) {
+			typename MapSizeType::const_iterator it = blobOfEntry_.find(stack.id(i));
+			if (it != blobOfEntry_.end()) used.insert(it->second);
+		}
+	}
+
+	// more than half of the blobs are unused
+	bool blobsMostlyUnused() const
+	{
+		return (blobsInFile_ > 2*usedBlobs());
+	}
+
+	// deletes the blob files started by this run that no manifest uses
+	void removeUnusedBlobFiles() const
+	{
+		VectorStringType kept;
+		for (SizeType i = 0; i < blobFiles_.size(); ++i) {
+			const PsimagLite::String& file = blobFiles_[i];
+			bool used = (file == blobFile_);
+			typename MapManifestType::const_iterator it = manifests_.begin();
+			for (; !used && it != manifests_.end(); ++it)
+				used = (it->second.blobFile == file);
+
+			if (used)
+				kept.push_back(file);
+			else
+				unlink(file.c_str());
+		}
+
+		blobFiles_.swap(kept);
+	}
+
+	// blobs[i] is the blob of entry i, 0 being the bottom of the stack;
+	// returns the number of entries written
+	SizeType writeBlobs(VectorSizeType& blobs,
+	                    const DiskOrMemoryStackType& stack,
+	                    typename IoType::Out& ioBlobs) const
+	{
+		const SizeType total = stack.size();
+		blobs.resize(total);
+		SizeType written = 0;
+		for (SizeType i = 0; i < total; ++i) {
+			typename MapSizeType::const_iterator it = blobOfEntry_.find(stack.id(i));
+			if (it != blobOfEntry_.end()) {
+				blobs[i] = it->second;
+				continue;
+			}
+
+			blobs[i] = blobsInFile_++;
+			blobOfEntry_[stack.id(i)] = blobs[i];
+			stack.entry(i).write(ioBlobs,
+			                     "Blobs/" + ttos(blobs[i]),
+			                     IoType::Out::Serializer::NO_OVERWRITE,
+			                     BasisWithOperatorsType::SaveEnum::ALL);
+			++written;
+		}
+
+		return written;
+	}
+
+	static void rememberBlobs(MapSizeType& blobOfEntry,
+	                          const DiskOrMemoryStackType& stack,
+	                          const VectorSizeType& blobs)
+	{
+		assert(blobs.size() == stack.size());
+		for (SizeType i = 0; i < blobs.size(); ++i)
+			blobOfEntry[stack.id(i)] = blobs[i];
+	}
+
 	void loadStacksMemoryToDisk()
 	{
 		const bool needsToRead = false;
@@ -456,6 +723,13 @@ private:
 	PsimagLite::ProgressIndicator progress_;
 	RealType energyFromFile_;
 	BasisWithOperatorsType dummyBwo_;
+	mutable PsimagLite::String blobFile_;
+	mutable SizeType blobsInFile_;
+	mutable MapSizeType blobOfEntry_;
+	mutable MapManifestType manifests_;
+	mutable VectorStringType blobFiles_;
+	PsimagLite::String restartBlobFile_;
+	bool isFork_;
 }; // class Checkpoint
 } // namespace Dmrg
 
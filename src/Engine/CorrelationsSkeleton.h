@@ -146,6 +146,26 @@ public:
 		}
 	}
 
+	// Odest, grown by growDirectly with transform up to from, is grown
+	// up to ns, as growDirectly(Odest, Osrc, i, fermionicSign, ns, true) does
+	// Used to extend the growth one site at a time
+	void growDirectlyFrom(SparseMatrixType& Odest,
+	                      SizeType i,
+	                      ProgramGlobals::FermionOrBosonEnum fermionicSign,
+	                      SizeType from,
+	                      SizeType ns) const
+	{
+		const SizeType nt = (i > 0) ? i - 1 : 0;
+		assert(from >= nt);
+		for (SizeType s = from; s < ns; ++s) {
+			const GrowDirection growOption = growthDirection(s, nt, i, s);
+			SparseMatrixType Onew(helper_.cols(s),helper_.cols(s));
+
+			fluffUp(Onew, Odest, fermionicSign, growOption, false, s);
+			helper_.transform(Odest, Onew, s);
+		}
+	}
+
 	GrowDirection growthDirection(SizeType s,
 	                              int nt,
 	                              SizeType i,
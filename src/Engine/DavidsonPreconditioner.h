@@ -0,0 +1,197 @@
+#ifndef DAVIDSON_PRECONDITIONER_H
+#define DAVIDSON_PRECONDITIONER_H
+#include "Vector.h"
+#include "Matrix.h"
+#include "BLAS.h"
+#include "PsimagLite.h"
+#include <algorithm>
+
+// Preconditioner M(theta) ~ (H - theta)^{-1} for the Davidson solver
+// DIAGONAL: uses the diagonal of H
+// PATCH: for each Kronecker patch uses the exact inverse of
+//        (HL_p x 1 + 1 x HR_p + s_p - theta), where HL_p and HR_p are the
+//        diagonal blocks of the left and right Hamiltonians in the patch,
+//        and s_p is the mean of the diagonal of the connections in the patch;
+//        patches that are too large use the diagonal instead
+// The matrix-vector classes fill this object, see
+// MatrixVectorKron::fillPreconditioner
+namespace Dmrg {
+
+template<typename ComplexOrRealType>
+class DavidsonPreconditioner {
+
+public:
+
+	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
+	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+
+	enum class ModeEnum {NONE, DIAGONAL, PATCH};
+
+	struct Patch {
+
+		// index into the vector of the sector of element (ileft, iright)
+		// is index[iright + ileft*sizeRight]
+		VectorSizeType index;
+		SizeType sizeLeft;
+		SizeType sizeRight;
+		MatrixType uLeftConj; // complex conjugate of the eigenvectors of HL_p
+		MatrixType uRight; // eigenvectors of HR_p
+		VectorRealType eigsLeft;
+		VectorRealType eigsRight;
+		RealType shift;
+	};
+
+	static const SizeType MAX_PATCH_SIDE = 512;
+
+	DavidsonPreconditioner(PsimagLite::String mode)
+	    : mode_(modeFromString(mode)),
+	      filled_(false),
+	      lowest_(0)
+	{}
+
+	~DavidsonPreconditioner()
+	{
+		for (SizeType i = 0; i < patches_.size(); ++i) {
+			delete patches_[i];
+			patches_[i] = 0;
+		}
+	}
+
+	ModeEnum mode() const { return mode_; }
+
+	bool usePatches() const { return (mode_ == ModeEnum::PATCH); }
+
+	bool enabled() const { return (mode_ != ModeEnum::NONE && filled_); }
+
+	void setDiagonal(const VectorRealType& d)
+	{
+		diagonal_ = d;
+		filled_ = (mode_ != ModeEnum::NONE);
+		if (d.size() > 0)
+			lowest_ = *std::min_element(d.begin(), d.end());
+	}
+
+	// takes ownership of patch
+	void addPatch(Patch* patch)
+	{
+		assert(patch);
+		patches_.push_back(patch);
+		if (patch->uRight.rows() == 0) return;
+		RealType e0 = patch->eigsLeft[0] + patch->eigsRight[0] + patch->shift;
+		if (e0 < lowest_) lowest_ = e0;
+	}
+
+	// lowest eigenvalue of the model operator that M inverts
+	// theta is clamped to it, so that far from convergence M does not steer
+	// the search towards excited states
+	RealType lowest() const { return lowest_; }
+
+	// with distributed vectors, the lowest over all MPI ranks
+	void lowest(RealType value) { lowest_ = value; }
+
+	// t = M(theta) r
+	void operator()(VectorType& t, const VectorType& r, RealType theta) const
+	{
+		assert(filled_);
+		assert(r.size() == diagonal_.size());
+		t.resize(r.size());
+		for (SizeType i = 0; i < r.size(); ++i)
+			t[i] = r[i]/denominator(diagonal_[i] - theta);
+
+		if (mode_ != ModeEnum::PATCH) return;
+
+		for (SizeType i = 0; i < patches_.size(); ++i)
+			applyPatch(t, r, theta, *patches_[i]);
+	}
+
+	static PsimagLite::String toString(ModeEnum mode)
+	{
+		switch (mode) {
+		case ModeEnum::NONE:
+			return "none";
+		case ModeEnum::DIAGONAL:
+			return "diagonal";
+		case ModeEnum::PATCH:
+			return "patch";
+		}
+
+		return "UNKNOWN";
+	}
+
+private:
+
+	DavidsonPreconditioner(const DavidsonPreconditioner&);
+
+	DavidsonPreconditioner& operator=(const DavidsonPreconditioner&);
+
+	static ModeEnum modeFromString(PsimagLite::String mode)
+	{
+		if (mode == "none") return ModeEnum::NONE;
+		if (mode == "diagonal") return ModeEnum::DIAGONAL;
+		if (mode == "patch") return ModeEnum::PATCH;
+		err("DavidsonPreconditioner=" + mode + " not valid; use none, diagonal or patch\n");
+		return ModeEnum::NONE;
+	}
+
+	static RealType denominator(RealType x)
+	{
+		static const RealType eps = 1e-8;
+		if (fabs(x) >= eps) return x;
+		return (x < 0) ? -eps : eps;
+	}
+
+	// t(patch) = (UL x UR) D^{-1} (UL^dagger x UR^dagger) r(patch)
+	// done as two pairs of gemms on the sizeRight x sizeLeft matrix of the patch
+	void applyPatch(VectorType& t,
+	                const VectorType& r,
+	                RealType theta,
+	                const Patch& patch) const
+	{
+		const SizeType sL = patch.sizeLeft;
+		const SizeType sR = patch.sizeRight;
+		if (patch.uRight.rows() == 0) return; // too large; diagonal already applied
+
+		MatrixType v(sR, sL);
+		for (SizeType il = 0; il < sL; ++il)
+			for (SizeType ir = 0; ir < sR; ++ir)
+				v(ir, il) = r[patch.index[ir + il*sR]];
+
+		MatrixType tmp(sR, sL);
+		const ComplexOrRealType one = 1.0;
+		const ComplexOrRealType zero = 0.0;
+
+		// tmp = UR^dagger v
+		psimag::BLAS::GEMM('C', 'N', sR, sL, sR, one, &(patch.uRight(0, 0)), sR,
+		                   &(v(0, 0)), sR, zero, &(tmp(0, 0)), sR);
+		// v = tmp conj(UL)
+		psimag::BLAS::GEMM('N', 'N', sR, sL, sL, one, &(tmp(0, 0)), sR,
+		                   &(patch.uLeftConj(0, 0)), sL, zero, &(v(0, 0)), sR);
+
+		for (SizeType a = 0; a < sL; ++a)
+			for (SizeType b = 0; b < sR; ++b)
+				v(b, a) /= denominator(patch.eigsLeft[a] + patch.eigsRight[b] +
+				                       patch.shift - theta);
+
+		// tmp = UR v
+		psimag::BLAS::GEMM('N', 'N', sR, sL, sR, one, &(patch.uRight(0, 0)), sR,
+		                   &(v(0, 0)), sR, zero, &(tmp(0, 0)), sR);
+		// v = tmp UL^T = tmp conj(UL)^dagger
+		psimag::BLAS::GEMM('N', 'C', sR, sL, sL, one, &(tmp(0, 0)), sR,
+		                   &(patch.uLeftConj(0, 0)), sL, zero, &(v(0, 0)), sR);
+
+		for (SizeType il = 0; il < sL; ++il)
+			for (SizeType ir = 0; ir < sR; ++ir)
+				t[patch.index[ir + il*sR]] = v(ir, il);
+	}
+
+	ModeEnum mode_;
+	bool filled_;
+	RealType lowest_;
+	VectorRealType diagonal_;
+	typename PsimagLite::Vector<Patch*>::Type patches_;
+};
+}
+#endif // DAVIDSON_PRECONDITIONER_H
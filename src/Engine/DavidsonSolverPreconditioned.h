@@ -0,0 +1,239 @@
+#ifndef DAVIDSON_SOLVER_PRECONDITIONED_H
+#define DAVIDSON_SOLVER_PRECONDITIONED_H
+#include "Vector.h"
+#include "Matrix.h"
+#include "PsimagLite.h"
+#include "ProgressIndicator.h"
+#include "DavidsonPreconditioner.h"
+
+// Davidson for the lowest eigenpair of the superblock sector
+// with correction t = M(theta) r, where M is a DavidsonPreconditioner,
+// plus the Olsen term
+// The subspace is restarted with the current and previous Ritz vectors
+// once it reaches maxSubspace vectors
+// Non-convergence, after maxIterations or on stagnation, is reported
+// and can be queried with converged()
+// MatrixVectorType may hold only the rows of this MPI rank, see
+// MatrixVectorLocal; dot products are then summed over ranks
+namespace Dmrg {
+
+template<typename MatrixVectorType, typename VectorType>
+class DavidsonSolverPreconditioned {
+
+	typedef typename VectorType::value_type ComplexOrRealType;
+	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
+	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+
+public:
+
+	typedef DavidsonPreconditioner<ComplexOrRealType> PreconditionerType;
+
+	DavidsonSolverPreconditioned(const MatrixVectorType& h,
+	                             const PreconditionerType& precond,
+	                             SizeType maxIterations,
+	                             RealType residualTolerance,
+	                             SizeType maxSubspace = 20)
+	    : h_(h),
+	      precond_(precond),
+	      maxIterations_(maxIterations),
+	      tolerance_(residualTolerance),
+	      maxSubspace_(std::max(maxSubspace, static_cast<SizeType>(3))),
+	      iterations_(0),
+	      matvecs_(0),
+	      residual_(0),
+	      converged_(false),
+	      progress_("DavidsonSolverPreconditioned")
+	{}
+
+	void computeOneState(RealType& energy,
+	                     VectorType& z,
+	                     const VectorType& initialVector,
+	                     SizeType excited)
+	{
+		if (excited > 0)
+			err("DavidsonSolverPreconditioned: only the lowest state is supported\n");
+
+		const SizeType n = h_.rows();
+		VectorVectorType v;
+		VectorVectorType w;
+
+		VectorType t = initialVector;
+		VectorType u(n, 0.0);
+		VectorType hu(n, 0.0);
+		VectorType uOld;
+		VectorType huOld;
+		RealType theta = 0;
+		iterations_ = matvecs_ = 0;
+		converged_ = false;
+
+		for (; iterations_ < maxIterations_; ++iterations_) {
+			if (!appendOrthonormal(v, w, t)) break;
+
+			SizeType k = v.size();
+			MatrixType hs(k, k);
+			for (SizeType i = 0; i < k; ++i)
+				for (SizeType j = 0; j < k; ++j)
+					hs(i, j) = dot(v[i], w[j]);
+
+			VectorRealType eigs(k);
+			PsimagLite::diag(hs, eigs, 'V');
+			theta = eigs[0];
+
+			uOld = u;
+			huOld = hu;
+			combine(u, v, hs);
+			combine(hu, w, hs);
+
+			VectorType r(n);
+			for (SizeType i = 0; i < n; ++i)
+				r[i] = hu[i] - theta*u[i];
+
+			residual_ = norm(r);
+			if (residual_ < tolerance_) {
+				converged_ = true;
+				++iterations_;
+				break;
+			}
+
+			// Olsen correction, t = M r - epsilon M u, so that a nearly
+			// exact preconditioner does not return t parallel to u
+			const RealType shift = std::min(theta, precond_.lowest());
+			precond_(t, r, shift);
+			VectorType mu;
+			precond_(mu, u, shift);
+			ComplexOrRealType den = dot(u, mu);
+			if (PsimagLite::norm(den) > 1e-12) {
+				ComplexOrRealType epsilon = dot(u, t)/den;
+				for (SizeType i = 0; i < n; ++i)
+					t[i] -= epsilon*mu[i];
+			}
+
+			if (k < maxSubspace_) continue;
+
+			// restart with u and the previous Ritz vector
+			v.clear();
+			w.clear();
+			v.push_back(u);
+			w.push_back(hu);
+			appendOrthonormalNoMatvec(v, w, uOld, huOld);
+		}
+
+		energy = theta;
+		z = u;
+
+		if (converged_) return;
+
+		PsimagLite::OstringStream msg;
+		msg<<"WARNING: not converged after "<<iterations_<<" iterations, residual=";
+		msg<<residual_<<" tolerance="<<tolerance_;
+		progress_.printline(msg, std::cout);
+	}
+
+	SizeType iterations() const { return iterations_; }
+
+	bool converged() const { return converged_; }
+
+	SizeType matvecs() const { return matvecs_; }
+
+	RealType residual() const { return residual_; }
+
+private:
+
+	ComplexOrRealType dot(const VectorType& a, const VectorType& b) const
+	{
+		ComplexOrRealType sum = 0;
+		for (SizeType i = 0; i < a.size(); ++i)
+			sum += PsimagLite::conj(a[i])*b[i];
+		h_.sumOverRanks(sum);
+		return sum;
+	}
+
+	RealType norm(const VectorType& a) const
+	{
+		return sqrt(PsimagLite::real(dot(a, a)));
+	}
+
+	// u = sum_i v[i] c(i, 0)
+	static void combine(VectorType& u, const VectorVectorType& v, const MatrixType& c)
+	{
+		const SizeType n = v[0].size();
+		u.resize(n);
+		for (SizeType j = 0; j < n; ++j)
+			u[j] = 0.0;
+
+		for (SizeType i = 0; i < v.size(); ++i)
+			for (SizeType j = 0; j < n; ++j)
+				u[j] += v[i][j]*c(i, 0);
+	}
+
+	// Gram-Schmidt twice; returns the norm of what remains of t
+	RealType orthogonalize(VectorType& t, const VectorVectorType& v) const
+	{
+		for (SizeType pass = 0; pass < 2; ++pass) {
+			for (SizeType i = 0; i < v.size(); ++i) {
+				ComplexOrRealType c = dot(v[i], t);
+				for (SizeType j = 0; j < t.size(); ++j)
+					t[j] -= c*v[i][j];
+			}
+		}
+
+		return norm(t);
+	}
+
+	bool appendOrthonormal(VectorVectorType& v, VectorVectorType& w, VectorType& t)
+	{
+		RealType norma = orthogonalize(t, v);
+		if (norma < 1e-12) return false;
+		for (SizeType j = 0; j < t.size(); ++j)
+			t[j] /= norma;
+
+		v.push_back(t);
+		VectorType ht(t.size(), 0.0);
+		h_.matrixVectorProduct(ht, t);
+		++matvecs_;
+		w.push_back(ht);
+		return true;
+	}
+
+	// appends t (with H t = ht already known) orthonormalized against v
+	bool appendOrthonormalNoMatvec(VectorVectorType& v,
+	                               VectorVectorType& w,
+	                               VectorType t,
+	                               VectorType ht) const
+	{
+		if (t.size() == 0) return false;
+		for (SizeType i = 0; i < v.size(); ++i) {
+			ComplexOrRealType c = dot(v[i], t);
+			for (SizeType j = 0; j < t.size(); ++j) {
+				t[j] -= c*v[i][j];
+				ht[j] -= c*w[i][j];
+			}
+		}
+
+		RealType norma = norm(t);
+		if (norma < 1e-6) return false;
+		for (SizeType j = 0; j < t.size(); ++j) {
+			t[j] /= norma;
+			ht[j] /= norma;
+		}
+
+		v.push_back(t);
+		w.push_back(ht);
+		return true;
+	}
+
+	const MatrixVectorType& h_;
+	const PreconditionerType& precond_;
+	SizeType maxIterations_;
+	RealType tolerance_;
+	SizeType maxSubspace_;
+	SizeType iterations_;
+	SizeType matvecs_;
+	RealType residual_;
+	bool converged_;
+	PsimagLite::ProgressIndicator progress_;
+};
+}
+#endif // DAVIDSON_SOLVER_PRECONDITIONED_H
@@ -102,13 +102,24 @@ public:
 	struct Params {
 
 		Params(bool u, ProgramGlobals::DirectionEnum d, bool de, bool enablePersistentSvd_)
-		    : useSvd(u), direction(d), debug(de), enablePersistentSvd(enablePersistentSvd_)
+		    : useSvd(u),
+		      direction(d),
+		      debug(de),
+		      enablePersistentSvd(enablePersistentSvd_),
+		      randomizedSvd(false),
+		      randomizedSvdCompare(false),
+		      keptStates(0),
+		      perturbation(0)
 		{}
 
 		bool useSvd;
 		ProgramGlobals::DirectionEnum direction;
 		bool debug;
 		bool enablePersistentSvd;
+		bool randomizedSvd;
+		bool randomizedSvdCompare;
+		SizeType keptStates; // requested; the randomized SVD targets it
+		RealType perturbation; // weight of the density matrix perturbation
 	};
 
 	typedef typename BlockDiagonalMatrixType::BuildingBlockType BuildingBlockType;
@@ -120,6 +131,20 @@ public:
 
 	virtual void diag(typename PsimagLite::Vector<RealType>::Type&, char) = 0;
 
+	// Partial diagonalization: eigenvalues first, then eigenvectors
+	// only for the kept states; see Truncation::changeBasis
+	virtual bool canDiagPartially() const { return false; }
+
+	virtual void eigenvalues(VectorRealType&)
+	{
+		err("DensityMatrixBase::eigenvalues(): not supported\n");
+	}
+
+	virtual void diagKept(const typename PsimagLite::Vector<SizeType>::Type&)
+	{
+		err("DensityMatrixBase::diagKept(): not supported\n");
+	}
+
 	virtual const typename PsimagLite::Vector<MatrixType>::Type& vts() const
 	{
 		return vtsEmpty_;
@@ -75,11 +75,14 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "TypeToString.h"
 #include "BlockDiagonalMatrix.h"
 #include "DensityMatrixBase.h"
+#include "DensityMatrixPerturbation.h"
 #include "ParallelDensityMatrix.h"
 #include "NoPthreads.h"
 #include "Concurrency.h"
-#include "Parallelizer.h"
+#include "ParallelizerPool.h"
 #include "DiagBlockDiagMatrix.h"
+#include "BLAS.h"
+#include <algorithm>
 
 namespace Dmrg {
 
@@ -98,6 +101,9 @@ class DensityMatrixLocal : public DensityMatrixBase<TargetingType> {
 	typedef PsimagLite::ProgressIndicator ProgressIndicatorType;
 	typedef typename PsimagLite::Real<DensityMatrixElementType>::Type RealType;
 	typedef typename DensityMatrixBase<TargetingType>::Params ParamsType;
+	typedef typename DensityMatrixBase<TargetingType>::BuildingBlockType MatrixType;
+	typedef DensityMatrixPerturbation<BasisWithOperatorsType, MatrixType>
+	DensityMatrixPerturbationType;
 
 public:
 
@@ -106,7 +112,7 @@ public:
 	typedef ParallelDensityMatrix<BlockDiagonalMatrixType,
 	BasisWithOperatorsType,
 	TargetVectorType> ParallelDensityMatrixType;
-	typedef PsimagLite::Parallelizer<ParallelDensityMatrixType> ParallelizerType;
+	typedef ParallelizerPool<ParallelDensityMatrixType> ParallelizerType;
 
 	DensityMatrixLocal(const TargetingType& target,
 	                   const LeftRightSuperType& lrs,
@@ -165,6 +171,9 @@ public:
 			// set this matrix block into data_
 			data_.setBlock(m,pBasis.partition(m),matrixBlock);
 		}
+
+		if (p.perturbation > 0) addPerturbation(pBasis, p.perturbation);
+
 		{
 			PsimagLite::OstringStream msg;
 			msg<<"Done with init partition";
@@ -183,6 +192,18 @@ public:
 		DiagBlockDiagMatrix<BlockDiagonalMatrixType>::diagonalise(data_,eigs,jobz);
 	}
 
+	bool canDiagPartially() const { return true; }
+
+	void eigenvalues(typename PsimagLite::Vector<RealType>::Type& eigs)
+	{
+		DiagBlockDiagMatrix<BlockDiagonalMatrixType>::eigenvalues(data_, eigs);
+	}
+
+	void diagKept(const typename PsimagLite::Vector<SizeType>::Type& removedIndices)
+	{
+		DiagBlockDiagMatrix<BlockDiagonalMatrixType>::diagonaliseKept(data_, removedIndices);
+	}
+
 	friend std::ostream& operator<<(std::ostream& os,
 	                                const DensityMatrixLocal& dm)
 	{
@@ -197,6 +218,78 @@ public:
 
 private:
 
+	// see DensityMatrixPerturbation.h
+	void addPerturbation(const BasisWithOperatorsType& pBasis, RealType alpha)
+	{
+		DensityMatrixPerturbationType perturb(pBasis, direction_);
+		const SizeType blocks = data_.blocks();
+
+		typename PsimagLite::Vector<BuildingBlockType>::Type delta(blocks);
+		for (SizeType m = 0; m < blocks; ++m) {
+			SizeType bs = pBasis.partition(m + 1) - pBasis.partition(m);
+			delta[m].resize(bs, bs);
+			delta[m].setTo(0.0);
+		}
+
+		for (SizeType iop = 0; iop < perturb.operators(); ++iop)
+			for (SizeType m = 0; m < blocks; ++m)
+				addOneOperator(delta[m], perturb, iop, m);
+
+		RealType traceRho = 0;
+		RealType traceDelta = 0;
+		for (SizeType m = 0; m < blocks; ++m) {
+			for (SizeType i = 0; i < delta[m].rows(); ++i) {
+				traceRho += PsimagLite::real(data_(m)(i, i));
+				traceDelta += PsimagLite::real(delta[m](i, i));
+			}
+		}
+
+		PsimagLite::OstringStream msg;
+		msg<<"Perturbation alpha="<<alpha<<" with "<<perturb.operators()<<" operators";
+		progress_.printline(msg, std::cout);
+
+		if (traceDelta <= 0) return;
+
+		const RealType factor = alpha*traceRho/traceDelta;
+		const RealType norm = 1.0/(1.0 + alpha);
+		for (SizeType m = 0; m < blocks; ++m) {
+			BuildingBlockType block = data_(m);
+			for (SizeType j = 0; j < block.cols(); ++j)
+				for (SizeType i = 0; i < block.rows(); ++i)
+					block(i, j) = norm*(block(i, j) + factor*delta[m](i, j));
+
+			data_.setBlock(m, pBasis.partition(m), block);
+		}
+	}
+
+	// delta += O(m, m') rho(m') O(m, m')^dagger summed over the blocks m'
+	// that O connects to block m; rho is block diagonal, and so is the result
+	void addOneOperator(BuildingBlockType& delta,
+	                    const DensityMatrixPerturbationType& perturb,
+	                    SizeType iop,
+	                    SizeType m) const
+	{
+		typename DensityMatrixPerturbationType::VectorSizeType sources;
+		typename DensityMatrixPerturbationType::VectorMatrixType opBlocks;
+		perturb(sources, opBlocks, iop, m);
+
+		const SizeType bs = delta.rows();
+		const DensityMatrixElementType one = 1.0;
+		const DensityMatrixElementType zero = 0.0;
+		for (SizeType s = 0; s < sources.size(); ++s) {
+			const BuildingBlockType& opBlock = opBlocks[s];
+			const SizeType bsPrime = opBlock.cols();
+			if (bs == 0 || bsPrime == 0) continue;
+
+			// tmp = O(m, m') rho(m'), then delta += tmp O(m, m')^dagger
+			BuildingBlockType tmp(bs, bsPrime);
+			psimag::BLAS::GEMM('N', 'N', bs, bsPrime, bsPrime, one, &(opBlock(0, 0)), bs,
+			                   &(data_(sources[s])(0, 0)), bsPrime, zero, &(tmp(0, 0)), bs);
+			psimag::BLAS::GEMM('N', 'C', bs, bs, bsPrime, one, &(tmp(0, 0)), bs,
+			                   &(opBlock(0, 0)), bs, one, &(delta(0, 0)), bs);
+		}
+	}
+
 	void initPartition(BuildingBlockType& matrixBlock,
 	                   BasisWithOperatorsType const &pBasis,
 	                   SizeType m,
@@ -214,7 +307,7 @@ private:
 		                                   m,
 		                                   weight,
 		                                   matrixBlock);
-		ParallelizerType threadedDm(ConcurrencyType::codeSectionParams);
+		ParallelizerType threadedDm(ConcurrencyType::codeSectionParams, "DensityMatrixLocal");
 		threadedDm.loopCreate(helperDm);
 
 	}
@@ -0,0 +1,127 @@
+#ifndef DENSITY_MATRIX_PERTURBATION_H
+#define DENSITY_MATRIX_PERTURBATION_H
+#include "Vector.h"
+#include "ProgramGlobals.h"
+#include <algorithm>
+
+/* PSIDOC DensityMatrixPerturbation
+With DensityMatrixPerturbation=alpha in the input, and alpha positive,
+the density matrix of the enlarged block is replaced by
+\begin{equation}
+\hat{\rho}' = \frac{1}{1+\alpha}\left(\hat{\rho} + \alpha\frac{{\rm tr}\hat{\rho}}
+{{\rm tr}\Delta}\Delta\right),\,\,\Delta = \sum_O O\hat{\rho}O^\dagger,
+\end{equation}
+where the sum is over the operators of the site most recently added
+to the block (White, PRB 72, 180403 (2005)).
+The states that these operators connect to are kept even if
+the targeted states do not have weight on them yet, which lets the
+1-site algorithm escape from bad bases.
+
+The value is a comma-separated list with one alpha per finite loop,
+for example DensityMatrixPerturbation=1e-4,1e-4,1e-5,0; the last value
+applies to all remaining finite loops, and the infinite loop is never perturbed.
+Use small values, such as 1e-4, and end with a zero,
+so that the last finite loops do not add the perturbation to the truncation error.
+
+With truncationNoSvd the density matrix is perturbed as above.
+With the SVD truncation, the default, the matrix $M$ of each symmetry sector of
+$\psi$, with $\hat{\rho}=MM^\dagger$, is given the additional columns $OM$, scaled so
+that $M'M'^\dagger=\hat{\rho}'$; this is the subspace expansion of
+Hubig et al., PRB 91, 155115 (2015), and no density matrix is built.
+
+The finite sweeps are 1-site by default: the growing block gains
+one site and the other block is taken unexpanded from the stack, so that
+the superblock has dimension $m\,d\,m$ instead of the $m\,d\,d\,m$ of
+twositedmrg. The perturbation restores the convergence that
+the 1-site sweeps lack, so it is meant to be used without twositedmrg.
+It cannot be used with wftAccelSvd, which would be given the
+expanded singular vectors, nor with SU(2).
+*/
+namespace Dmrg {
+
+// The operators of the site most recently added to a block, and their dense
+// blocks O(m, m') between the symmetry sectors m and m' of the block
+template<typename BasisWithOperatorsType, typename MatrixType>
+class DensityMatrixPerturbation {
+
+	typedef typename BasisWithOperatorsType::BasisType BasisType;
+	typedef typename BasisWithOperatorsType::SparseMatrixType SparseMatrixType;
+
+public:
+
+	typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename PsimagLite::Vector<MatrixType>::Type VectorMatrixType;
+
+	DensityMatrixPerturbation(const BasisWithOperatorsType& pBasis,
+	                          ProgramGlobals::DirectionEnum direction)
+	    : pBasis_(pBasis), blockOfIndex_(pBasis.size())
+	{
+		if (BasisType::useSu2Symmetry())
+			err("DensityMatrixPerturbation not supported with SU(2)\n");
+
+		const SizeType total = pBasis.numberOfOperators();
+		const SizeType mostRecent = std::min(pBasis.operatorsPerSite(0), total);
+		const SizeType start = (direction == ProgramGlobals::DirectionEnum::EXPAND_SYSTEM) ?
+		            total - mostRecent : 0;
+
+		for (SizeType k = start; k < start + mostRecent; ++k) {
+			const SparseMatrixType& op = pBasis.getOperatorByIndex(k).data;
+			if (op.rows() != pBasis.size()) continue; // hollowed out
+			ops_.push_back(k);
+		}
+
+		for (SizeType m = 0; m < blocks(); ++m)
+			for (SizeType i = pBasis.partition(m); i < pBasis.partition(m + 1); ++i)
+				blockOfIndex_[i] = m;
+	}
+
+	SizeType operators() const { return ops_.size(); }
+
+	SizeType blocks() const { return pBasis_.partition() - 1; }
+
+	// the blocks m' that operator iop connects block m to, and O(m, m') for each
+	void operator()(VectorSizeType& sources,
+	                VectorMatrixType& opBlocks,
+	                SizeType iop,
+	                SizeType m) const
+	{
+		assert(iop < ops_.size());
+		const SparseMatrixType& op = pBasis_.getOperatorByIndex(ops_[iop]).data;
+		const SizeType offset = pBasis_.partition(m);
+		const SizeType bs = pBasis_.partition(m + 1) - offset;
+
+		sources.clear();
+		for (SizeType i = offset; i < offset + bs; ++i) {
+			for (int k = op.getRowPtr(i); k < op.getRowPtr(i + 1); ++k) {
+				SizeType mprime = blockOfIndex_[op.getCol(k)];
+				if (std::find(sources.begin(), sources.end(), mprime) == sources.end())
+					sources.push_back(mprime);
+			}
+		}
+
+		opBlocks.resize(sources.size());
+		for (SizeType s = 0; s < sources.size(); ++s) {
+			const SizeType mprime = sources[s];
+			const SizeType offsetPrime = pBasis_.partition(mprime);
+			const SizeType bsPrime = pBasis_.partition(mprime + 1) - offsetPrime;
+			MatrixType& opBlock = opBlocks[s];
+			opBlock.resize(bs, bsPrime);
+			opBlock.setTo(0.0);
+			for (SizeType i = 0; i < bs; ++i) {
+				for (int k = op.getRowPtr(i + offset); k < op.getRowPtr(i + offset + 1); ++k) {
+					SizeType col = op.getCol(k);
+					if (blockOfIndex_[col] != mprime) continue;
+					opBlock(i, col - offsetPrime) = op.getValue(k);
+				}
+			}
+		}
+	}
+
+private:
+
+	const BasisWithOperatorsType& pBasis_;
+	VectorSizeType ops_;
+	VectorSizeType blockOfIndex_;
+};
+}
+#endif // DENSITY_MATRIX_PERTURBATION_H
@@ -73,11 +73,15 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Profiling.h"
 #include "TypeToString.h"
 #include "DensityMatrixBase.h"
+#include "DensityMatrixPerturbation.h"
 #include "NoPthreads.h"
 #include "Concurrency.h"
 #include "MatrixVectorKron/GenIjPatch.h"
 #include "PersistentSvd.h"
 #include "Svd.h"
+#include "RandomizedSvd.h"
+#include "ParallelizerPool.h"
+#include "BLAS.h"
 
 namespace Dmrg {
 
@@ -108,6 +112,8 @@ class DensityMatrixSvd : public DensityMatrixBase<TargetingType> {
 	typedef typename BasisType::QnType QnType;
 	typedef typename BasisWithOperatorsType::VectorQnType VectorQnType;
 	typedef typename PsimagLite::Vector<VectorRealType>::Type VectorVectorRealType;
+	typedef DensityMatrixPerturbation<BasisWithOperatorsType, MatrixType>
+	DensityMatrixPerturbationType;
 
 	class GroupsStruct {
 
@@ -186,6 +192,47 @@ class DensityMatrixSvd : public DensityMatrixBase<TargetingType> {
 			}
 		}
 
+		bool hasGroup(SizeType igroup) const
+		{
+			return (std::find(seenGroups_.begin(), seenGroups_.end(), igroup) !=
+			        seenGroups_.end());
+		}
+
+		// appends columns to the matrix of igroup, creating the group if
+		// needed; only after all targets have been split
+		void appendColumns(SizeType igroup, const MatrixType& extra)
+		{
+			if (hasGroup(igroup)) {
+				concatColumns(matrix(igroup), extra);
+				return;
+			}
+
+			seenGroups_.push_back(igroup);
+			m_.push_back(new MatrixType(extra));
+		}
+
+		static void concatColumns(MatrixType& dest, const MatrixType& extra)
+		{
+			if (dest.cols() == 0) {
+				dest = extra;
+				return;
+			}
+
+			assert(dest.rows() == extra.rows());
+			const SizeType rows = dest.rows();
+			const SizeType cols = dest.cols();
+			MatrixType both(rows, cols + extra.cols());
+			for (SizeType j = 0; j < cols; ++j)
+				for (SizeType i = 0; i < rows; ++i)
+					both(i, j) = dest(i, j);
+
+			for (SizeType j = 0; j < extra.cols(); ++j)
+				for (SizeType i = 0; i < rows; ++i)
+					both(i, j + cols) = extra(i, j);
+
+			dest = both;
+		}
+
 		// TODO: Move matrix out
 		MatrixType& matrix(SizeType igroup)
 		{
@@ -360,11 +407,19 @@ class DensityMatrixSvd : public DensityMatrixBase<TargetingType> {
 		ParallelSvd(BlockDiagonalMatrixType& blockDiagonalMatrix,
 		            GroupsStructType& allTargets,
 		            VectorRealType& eigs,
-		            PersistentSvdType& additionalStorage)
+		            PersistentSvdType& additionalStorage,
+		            const ParamsType& params)
 		    : blockDiagonalMatrix_(blockDiagonalMatrix),
 		      allTargets_(allTargets),
 		      eigs_(eigs),
-		      persistentSvd_(additionalStorage)
+		      persistentSvd_(additionalStorage),
+		      params_(params),
+		      sampled_(allTargets.size(), 0),
+		      fallbacks_(allTargets.size(), 0),
+		      missedWeight_(allTargets.size(), 0.0),
+		      millisRandomized_(allTargets.size(), 0.0),
+		      millisExact_(allTargets.size(), 0.0),
+		      maxError_(allTargets.size(), 0.0)
 		{
 			SizeType oneSide = allTargets.basis().size();
 			eigs_.resize(oneSide);
@@ -379,8 +434,13 @@ class DensityMatrixSvd : public DensityMatrixBase<TargetingType> {
 			MatrixType& vt = persistentSvd_.vts(igroup);
 			VectorRealType& eigsOnePatch = persistentSvd_.s(igroup);
 
-			PsimagLite::Svd<ComplexOrRealType> svd;
-			svd('A', m, eigsOnePatch, vt);
+			bool done = (params_.randomizedSvd && !params_.enablePersistentSvd &&
+			             randomizedSvd(ipatch, m, eigsOnePatch, vt));
+
+			if (!done) {
+				PsimagLite::Svd<ComplexOrRealType> svd;
+				svd('A', m, eigsOnePatch, vt);
+			}
 
 			persistentSvd_.qns(igroup) = allTargets_.basis().qnEx(igroup);
 			const BasisType& basis = allTargets_.basis();
@@ -404,12 +464,141 @@ class DensityMatrixSvd : public DensityMatrixBase<TargetingType> {
 		// needed for WFT
 		const PersistentSvdType& additionalStorage() const { return persistentSvd_; }
 
+		bool usedRandomized() const
+		{
+			return (std::find_if(sampled_.begin(),
+			                     sampled_.end(),
+			                     [](SizeType x) { return x > 0; }) != sampled_.end());
+		}
+
+		// Columns of a randomized block beyond the sample are placeholders
+		// to be removed by the truncation; if fewer than the kept states
+		// have nonzero weight some of them would be kept, so complete the
+		// sampled vectors to an orthonormal basis instead
+		void completeIfNeeded()
+		{
+			SizeType nonZero = 0;
+			for (SizeType i = 0; i < eigs_.size(); ++i)
+				if (eigs_[i] > 0) ++nonZero;
+
+			if (nonZero >= params_.keptStates) return;
+
+			for (SizeType ipatch = 0; ipatch < sampled_.size(); ++ipatch) {
+				if (sampled_[ipatch] == 0) continue;
+				SizeType igroup = allTargets_.groupFromIndex(ipatch);
+				SizeType offset = allTargets_.basis().partition(igroup);
+				MatrixType m = blockDiagonalMatrix_(igroup);
+				SubspaceIterationDiag<MatrixType>::orthonormalize(m);
+				blockDiagonalMatrix_.setBlock(igroup, offset, m);
+			}
+		}
+
+		void printStats(const ProgressIndicatorType& progress) const
+		{
+			SizeType randomized = 0;
+			SizeType fallbacks = 0;
+			RealType missed = 0;
+			RealType millisRandomized = 0;
+			RealType millisExact = 0;
+			RealType maxError = 0;
+			for (SizeType i = 0; i < sampled_.size(); ++i) {
+				if (sampled_[i] > 0) ++randomized;
+				fallbacks += fallbacks_[i];
+				missed = std::max(missed, missedWeight_[i]);
+				millisRandomized += millisRandomized_[i];
+				millisExact += millisExact_[i];
+				maxError = std::max(maxError, maxError_[i]);
+			}
+
+			PsimagLite::OstringStream msg;
+			msg<<"Randomized "<<randomized<<" of "<<sampled_.size();
+			msg<<" groups, fallbacks to exact="<<fallbacks;
+			msg<<", max weight missed by the sample="<<missed;
+			progress.printline(msg, std::cout);
+			if (!params_.randomizedSvdCompare || randomized == 0) return;
+
+			PsimagLite::OstringStream msg2;
+			msg2<<"Randomized "<<millisRandomized<<" ms, exact ";
+			msg2<<millisExact<<" ms, speedup="<<millisExact/std::max(millisRandomized, 1e-3);
+			msg2<<", max |s^2 - s_exact^2| on kept="<<maxError;
+			progress.printline(msg2, std::cout);
+		}
+
 	private:
 
+		// Leaves in m the rows x rows transform with the sampled left singular
+		// vectors first and unit vectors after them, which the truncation
+		// removes since their weight is zero
+		bool randomizedSvd(SizeType ipatch,
+		                   MatrixType& m,
+		                   VectorRealType& s,
+		                   MatrixType& vt)
+		{
+			RandomizedSvd<MatrixType> rsvd(m, params_.keptStates);
+			if (!rsvd.worthIt()) return false;
+
+			MatrixType u;
+			VectorRealType s2;
+			const PsimagLite::MemoryUsage::TimeHandle time1 = PsimagLite::ProgressIndicator::time();
+			bool ok = rsvd(u, s2, 1e-10);
+			const PsimagLite::MemoryUsage::TimeHandle time2 = PsimagLite::ProgressIndicator::time();
+			missedWeight_[ipatch] = rsvd.missedWeight();
+			if (!ok) {
+				++fallbacks_[ipatch];
+				return false;
+			}
+
+			millisRandomized_[ipatch] = (time2 - time1).millis();
+			if (params_.randomizedSvdCompare)
+				compareWithExact(ipatch, m, s2);
+
+			const SizeType rows = m.rows();
+			const SizeType l = u.cols();
+			m.resize(rows, rows);
+			m.setTo(0.0);
+			for (SizeType j = 0; j < l; ++j)
+				for (SizeType i = 0; i < rows; ++i)
+					m(i, j) = u(i, j);
+
+			for (SizeType j = l; j < rows; ++j)
+				m(j, j) = 1.0;
+
+			s.resize(l);
+			for (SizeType j = 0; j < l; ++j)
+				s[j] = sqrt(s2[j]);
+
+			vt = MatrixType();
+			sampled_[ipatch] = l;
+			return true;
+		}
+
+		void compareWithExact(SizeType ipatch, const MatrixType& m, const VectorRealType& s2)
+		{
+			MatrixType copy = m;
+			MatrixType vt;
+			VectorRealType s;
+			const PsimagLite::MemoryUsage::TimeHandle time1 = PsimagLite::ProgressIndicator::time();
+			PsimagLite::Svd<ComplexOrRealType> svd;
+			svd('A', copy, s, vt);
+			const PsimagLite::MemoryUsage::TimeHandle time2 = PsimagLite::ProgressIndicator::time();
+			millisExact_[ipatch] = (time2 - time1).millis();
+
+			SizeType k = std::min(params_.keptStates, std::min(s.size(), s2.size()));
+			for (SizeType i = 0; i < k; ++i)
+				maxError_[ipatch] = std::max(maxError_[ipatch], fabs(s[i]*s[i] - s2[i]));
+		}
+
 		BlockDiagonalMatrixType& blockDiagonalMatrix_;
 		GroupsStructType& allTargets_;
 		VectorRealType& eigs_;
 		PersistentSvdType persistentSvd_;
+		const ParamsType& params_;
+		VectorSizeType sampled_;
+		VectorSizeType fallbacks_;
+		VectorRealType missedWeight_;
+		VectorRealType millisRandomized_;
+		VectorRealType millisExact_;
+		VectorRealType maxError_;
 	};
 
 public:
@@ -459,6 +648,8 @@ public:
 		for (SizeType x = 0; x < targets; ++x)
 			addThisTarget(x, target);
 
+		if (p.perturbation > 0) addPerturbation(p.perturbation);
+
 		PsimagLite::OstringStream msg;
 		msg<<"Found "<<allTargets_.size()<<" groups on left or right";
 		profiling.end(msg.str());
@@ -472,13 +663,21 @@ public:
 	void diag(VectorRealType& eigs, char jobz)
 	{
 		PsimagLite::Profiling profiling("DensityMatrixSvdDiag", std::cout);
-		typedef PsimagLite::Parallelizer<ParallelSvd> ParallelizerType;
-		ParallelizerType threaded(PsimagLite::Concurrency::codeSectionParams);
+		typedef ParallelizerPool<ParallelSvd> ParallelizerType;
+		ParallelizerType threaded(PsimagLite::Concurrency::codeSectionParams, "DensityMatrixSvd::diag");
 		ParallelSvd parallelSvd(data_,
 		                        allTargets_,
 		                        eigs,
-		                        persistentSvd_);
+		                        persistentSvd_,
+		                        params_);
 		threaded.loopCreate(parallelSvd);
+		if (params_.randomizedSvd) {
+			if (parallelSvd.usedRandomized())
+				parallelSvd.completeIfNeeded();
+			ProgressIndicatorType progress("DensityMatrixSvd");
+			parallelSvd.printStats(progress);
+		}
+
 		for (SizeType i = 0; i < data_.blocks(); ++i) {
 			SizeType n = data_(i).rows();
 			if (n > 0) continue;
@@ -528,6 +727,81 @@ public:
 
 private:
 
+	// Appends to the matrix M of each group the columns O(m, m') M(m') of
+	// the operators O of the most recently added site, so that the squares
+	// of the singular values are the eigenvalues of the perturbed density
+	// matrix; see DensityMatrixPerturbation.h
+	void addPerturbation(RealType alpha)
+	{
+		DensityMatrixPerturbationType perturb(allTargets_.basis(), params_.direction);
+		const SizeType blocks = perturb.blocks();
+		typename DensityMatrixPerturbationType::VectorMatrixType extra(blocks);
+		typename DensityMatrixPerturbationType::VectorSizeType sources;
+		typename DensityMatrixPerturbationType::VectorMatrixType opBlocks;
+		const ComplexOrRealType one = 1.0;
+		const ComplexOrRealType zero = 0.0;
+		RealType traceDelta = 0;
+		for (SizeType iop = 0; iop < perturb.operators(); ++iop) {
+			for (SizeType m = 0; m < blocks; ++m) {
+				perturb(sources, opBlocks, iop, m);
+				for (SizeType s = 0; s < sources.size(); ++s) {
+					if (!allTargets_.hasGroup(sources[s])) continue;
+					const MatrixType& mPrime = allTargets_.matrix(sources[s]);
+					const MatrixType& opBlock = opBlocks[s];
+					const SizeType rows = opBlock.rows();
+					const SizeType cols = mPrime.cols();
+					if (rows == 0 || cols == 0) continue;
+					MatrixType tmp(rows, cols);
+					psimag::BLAS::GEMM('N', 'N', rows, cols, opBlock.cols(), one,
+					                   &(opBlock(0, 0)), rows, &(mPrime(0, 0)),
+					                   mPrime.rows(), zero, &(tmp(0, 0)), rows);
+					traceDelta += normSquared(tmp);
+					GroupsStructType::concatColumns(extra[m], tmp);
+				}
+			}
+		}
+
+		RealType traceRho = 0;
+		for (SizeType i = 0; i < allTargets_.size(); ++i)
+			traceRho += normSquared(allTargets_.matrix(allTargets_.groupFromIndex(i)));
+
+		PsimagLite::OstringStream msg;
+		msg<<"Perturbation alpha="<<alpha<<" with "<<perturb.operators()<<" operators";
+		msg<<" as subspace expansion";
+		ProgressIndicatorType progress("DensityMatrixSvd");
+		progress.printline(msg, std::cout);
+
+		if (traceDelta <= 0) return;
+
+		const RealType oldFactor = 1.0/sqrt(1.0 + alpha);
+		const RealType newFactor = sqrt(alpha*traceRho/(traceDelta*(1.0 + alpha)));
+		for (SizeType i = 0; i < allTargets_.size(); ++i)
+			scale(allTargets_.matrix(allTargets_.groupFromIndex(i)), oldFactor);
+
+		for (SizeType m = 0; m < blocks; ++m) {
+			if (extra[m].cols() == 0) continue;
+			scale(extra[m], newFactor);
+			allTargets_.appendColumns(m, extra[m]);
+		}
+	}
+
+	static RealType normSquared(const MatrixType& m)
+	{
+		RealType sum = 0;
+		for (SizeType j = 0; j < m.cols(); ++j)
+			for (SizeType i = 0; i < m.rows(); ++i)
+				sum += PsimagLite::real(m(i, j)*PsimagLite::conj(m(i, j)));
+
+		return sum;
+	}
+
+	static void scale(MatrixType& m, RealType factor)
+	{
+		for (SizeType j = 0; j < m.cols(); ++j)
+			for (SizeType i = 0; i < m.rows(); ++i)
+				m(i, j) *= factor;
+	}
+
 	void addThisTarget(SizeType x,
 	                   const TargetingType& target)
 
@@ -552,8 +826,8 @@ private:
 			SizeType m = v.sector(sector);
 			const QnType& qn = super.qnEx(m);
 			GenIjPatchType genIjPatch(lrs_, qn);
-			typedef PsimagLite::Parallelizer<ParallelPsiSplit> ParallelizerType;
-			ParallelizerType threaded(PsimagLite::Concurrency::codeSectionParams);
+			typedef ParallelizerPool<ParallelPsiSplit> ParallelizerType;
+			ParallelizerType threaded(PsimagLite::Concurrency::codeSectionParams, "DensityMatrixSvd::psiSplit");
 			ParallelPsiSplit parallelPsiSplit(lrs_,
 			                                  genIjPatch,
 			                                  v,
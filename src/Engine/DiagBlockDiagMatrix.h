@@ -1,6 +1,7 @@
 #ifndef DIAGBLOCKDIAGMATRIX_H
 #define DIAGBLOCKDIAGMATRIX_H
 #include "EnforcePhase.h"
+#include "ProgressIndicator.h"
 
 namespace Dmrg {
 
@@ -10,6 +11,9 @@ class DiagBlockDiagMatrix {
 	typedef typename BlockDiagonalMatrixType::BuildingBlockType BuildingBlockType;
 	typedef typename BuildingBlockType::value_type ComplexOrRealType;
 	typedef typename BlockDiagonalMatrixType::VectorRealType VectorRealType;
+	typedef typename BlockDiagonalMatrixType::VectorSizeType VectorSizeType;
+
+	enum class TaskEnum {DIAG, EIGENVALUES, KEPT};
 
 	class LoopForDiag {
 
@@ -17,14 +21,20 @@ class DiagBlockDiagMatrix {
 
 	public:
 
+		// removedPerBlock is used only by TaskEnum::KEPT
 		LoopForDiag(BlockDiagonalMatrixType& C1,
 		            VectorRealType& eigs1,
-		            char option1)
+		            char option1,
+		            TaskEnum task1 = TaskEnum::DIAG,
+		            const VectorSizeType& removedPerBlock1 = VectorSizeType())
 		    : C(C1),
 		      eigs(eigs1),
 		      option(option1),
+		      task(task1),
+		      removedPerBlock(removedPerBlock1),
 		      eigsForGather(C.blocks()),
-		      weights(C.blocks())
+		      weights(C.blocks()),
+		      partial(C.blocks(), 0)
 		{
 
 			for (SizeType m=0;m<C.blocks();m++) {
@@ -33,6 +43,7 @@ class DiagBlockDiagMatrix {
 			}
 
 			assert(C.rows() == C.cols());
+			assert(task != TaskEnum::KEPT || removedPerBlock.size() == C.blocks());
 			eigs.resize(C.rows());
 		}
 
@@ -42,8 +53,17 @@ class DiagBlockDiagMatrix {
 		{
 			assert(C.rows() == C.cols());
 			SizeType m = taskNumber;
+			if (task == TaskEnum::KEPT) {
+				doKept(m);
+				return;
+			}
+
 			VectorRealType eigsTmp;
-			C.diagAndEnforcePhase(m, eigsTmp, option);
+			if (task == TaskEnum::EIGENVALUES)
+				C.eigenvaluesOfBlock(m, eigsTmp);
+			else
+				C.diagAndEnforcePhase(m, eigsTmp, option);
+
 			for (SizeType j = C.offsetsRows(m); j < C.offsetsRows(m+1); ++j)
 				eigsForGather[m][j-C.offsetsRows(m)] = eigsTmp[j-C.offsetsRows(m)];
 
@@ -58,13 +78,40 @@ class DiagBlockDiagMatrix {
 			}
 		}
 
+		// blocks that were diagonalized only for the kept states
+		SizeType partialBlocks() const
+		{
+			SizeType sum = 0;
+			for (SizeType m = 0; m < partial.size(); ++m)
+				sum += partial[m];
+			return sum;
+		}
+
 	private:
 
+		// removedPerBlock[m] is the number of removed states of block m if
+		// they are the lowest of the block, or the block size plus one if
+		// the block must be fully diagonalized
+		void doKept(SizeType m)
+		{
+			const SizeType size = C.offsetsRows(m+1) - C.offsetsRows(m);
+			if (removedPerBlock[m] > size) {
+				VectorRealType eigsTmp;
+				C.diagAndEnforcePhase(m, eigsTmp, 'V');
+				return;
+			}
+
+			if (C.diagTopAndEnforcePhase(m, size - removedPerBlock[m])) partial[m] = 1;
+		}
+
 		BlockDiagonalMatrixType& C;
 		VectorRealType& eigs;
 		char option;
+		TaskEnum task;
+		VectorSizeType removedPerBlock;
 		typename PsimagLite::Vector<VectorRealType>::Type eigsForGather;
 		typename PsimagLite::Vector<SizeType>::Type weights;
+		typename PsimagLite::Vector<SizeType>::Type partial;
 	};
 
 public:
@@ -77,19 +124,66 @@ public:
 	                        VectorRealType& eigs,
 	                        char option)
 	{
-		typedef PsimagLite::NoPthreadsNg<LoopForDiag> ParallelizerType;
-		typedef PsimagLite::Concurrency ConcurrencyType;
-		SizeType savedNpthreads = ConcurrencyType::codeSectionParams.npthreads;
-		ConcurrencyType::codeSectionParams.npthreads = 1;
-		ParallelizerType threadObject(ConcurrencyType::codeSectionParams);
-
 		LoopForDiag helper(C,eigs,option);
+		runLoop(helper);
+		helper.gather();
+	}
 
-		threadObject.loopCreate(helper); // FIXME: needs weights
-
+	// Eigenvalues only; C is not changed
+	static void eigenvalues(BlockDiagonalMatrixType& C, VectorRealType& eigs)
+	{
+		LoopForDiag helper(C, eigs, 'N', TaskEnum::EIGENVALUES);
+		runLoop(helper);
 		helper.gather();
+	}
+
+	// Eigenvectors only for the columns not in removedIndices (sorted);
+	// eigenvalues within a block are ascending, so the kept ones are the
+	// last columns of the block, unless there are ties at the cut, and then
+	// the block is fully diagonalized
+	static void diagonaliseKept(BlockDiagonalMatrixType& C,
+	                            const VectorSizeType& removedIndices)
+	{
+		assert(C.rows() == C.cols());
+		VectorSizeType removedPerBlock(C.blocks(), 0);
+		typename VectorSizeType::const_iterator it = removedIndices.begin();
+		for (SizeType m = 0; m < C.blocks(); ++m) {
+			const SizeType start = C.offsetsRows(m);
+			const SizeType end = C.offsetsRows(m+1);
+			SizeType removed = 0;
+			bool lowest = true;
+			for (; it != removedIndices.end() && *it < end; ++it) {
+				assert(*it >= start);
+				if (*it != start + removed) lowest = false;
+				++removed;
+			}
+
+			removedPerBlock[m] = (lowest) ? removed : end - start + 1;
+		}
+
+		VectorRealType eigsUnused;
+		LoopForDiag helper(C, eigsUnused, 'V', TaskEnum::KEPT, removedPerBlock);
+		runLoop(helper);
 
-		ConcurrencyType::codeSectionParams.npthreads = savedNpthreads;
+		PsimagLite::OstringStream msg;
+		msg<<helper.partialBlocks()<<" of "<<C.blocks();
+		msg<<" blocks diagonalized only for kept states";
+		PsimagLite::ProgressIndicator progress("DiagBlockDiagMatrix");
+		progress.printline(msg, std::cout);
+	}
+
+private:
+
+	static void runLoop(LoopForDiag& helper)
+	{
+		typedef PsimagLite::NoPthreadsNg<LoopForDiag> ParallelizerType;
+		typedef PsimagLite::Concurrency ConcurrencyType;
+		// a copy, since METTS chains (MettsChains=) may run this concurrently
+		PsimagLite::CodeSectionParams codeSectionParams = ConcurrencyType::codeSectionParams;
+		codeSectionParams.npthreads = 1;
+		ParallelizerType threadObject(codeSectionParams);
+
+		threadObject.loopCreate(helper); // FIXME: needs weights
 	}
 }; // class DiagBlockDiagMatrix
 
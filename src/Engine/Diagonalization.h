@@ -83,9 +83,14 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "ProgramGlobals.h"
 #include "LanczosSolver.h"
 #include "DavidsonSolver.h"
+#include "DavidsonSolverPreconditioned.h"
+#include "MatrixVectorLocal.h"
+#include "BlockDavidsonSolver.h"
 #include "ParametersForSolver.h"
+#include "AdaptiveSolverTolerance.h"
 #include "Concurrency.h"
 #include "Profiling.h"
+#include "AsyncOutputWriter.h"
 
 namespace Dmrg {
 
@@ -126,6 +131,12 @@ public:
 	typedef PsimagLite::LanczosSolver<ParametersForSolverType,
 	MatrixVectorType,
 	TargetVectorType> LanczosSolverType;
+	typedef DavidsonSolverPreconditioned<MatrixVectorType,
+	TargetVectorType> DavidsonSolverPreconditionedType;
+	typedef typename DavidsonSolverPreconditionedType::PreconditionerType
+	DavidsonPreconditionerType;
+	typedef BlockDavidsonSolver<MatrixVectorType, TargetVectorType> BlockDavidsonSolverType;
+	typedef AdaptiveSolverTolerance<RealType> AdaptiveSolverToleranceType;
 
 	Diagonalization(const ParametersType& parameters,
 	                const ModelType& model,
@@ -143,8 +154,25 @@ public:
 	      progress_("Diag."),
 	      quantumSector_(quantumSector),
 	      wft_(waveFunctionTransformation),
-	      oldEnergy_(oldEnergy)
-	{}
+	      oldEnergy_(oldEnergy),
+	      davidsonPreconditioner_("patch"),
+	      adaptiveTolerance_(parameters.options.find("adaptiveSolverTolerance") !=
+	        PsimagLite::String::npos, parameters.finiteLoop.size()),
+	      asyncWriter_(0)
+	{
+		try {
+			io.readline(davidsonPreconditioner_, "DavidsonPreconditioner=");
+		} catch (std::exception&) {}
+	}
+
+	~Diagonalization()
+	{
+		if (!adaptiveTolerance_.enabled()) return;
+		PsimagLite::OstringStream msg;
+		msg<<"AdaptiveSolverTolerance: total matvecs="<<adaptiveTolerance_.matvecs();
+		msg<<" estimated matvecs saved="<<adaptiveTolerance_.matvecsSaved();
+		progress_.printline(msg, std::cout);
+	}
 
 	//!PTEX_LABEL{Diagonalization}
 	RealType operator()(TargetingType& target,
@@ -173,13 +201,37 @@ public:
 		PsimagLite::Profiling profiling("Diagonalization", std::cout);
 		assert(direction != ProgramGlobals::DirectionEnum::INFINITE);
 
-		RealType gsEnergy = internalMain_(target,direction,loopIndex,block);
+		RealType gsEnergy = 0;
+		{
+			// the serializer of the previous step is written meanwhile;
+			// nothing here may use HDF5, see AsyncOutputWriter.h
+			AsyncOutputWriter::Window window(asyncWriter_);
+			gsEnergy = internalMain_(target,direction,loopIndex,block);
+		}
+
+		adaptiveTolerance_.recordEnergy(gsEnergy, loopIndex);
 		//  targeting:
 		target.evolve(gsEnergy,direction,block,block,loopIndex);
 		wft_.triggerOff(target.lrs());
 		return gsEnergy;
 	}
 
+	// Used by SolverOptions=asyncWrite
+	void setAsyncWriter(AsyncOutputWriter* asyncWriter)
+	{
+		asyncWriter_ = asyncWriter;
+	}
+
+	// Used by SolverOptions=adaptiveSolverTolerance
+	void setTruncationError(RealType error)
+	{
+		adaptiveTolerance_.setTruncationError(error);
+	}
+
+	// Energies of levels 0 to Excited of the last step, in the sector
+	// of lowest energy; empty unless SolverOptions=blockDavidson
+	const VectorRealType& levels() const { return levels_; }
+
 private:
 
 	void targetedSymmetrySectors(VectorSizeType& mVector,
@@ -269,6 +321,7 @@ private:
 
 		typename PsimagLite::Vector<RealType>::Type energySaved(totalSectors);
 		typename PsimagLite::Vector<TargetVectorType>::Type vecSaved(totalSectors);
+		typename PsimagLite::Vector<VectorRealType>::Type levelsSaved(totalSectors);
 
 		for (SizeType j = 0; j < totalSectors; ++j) {
 			SizeType i = sectors[j];
@@ -295,6 +348,7 @@ private:
 				progress_.printline(msg,std::cout);
 			} else {
 				vecSaved[j].resize(initialVectorBySector.size());
+				levels_.clear();
 				diagonaliseOneBlock(i,
 				                    vecSaved[j],
 				                    gsEnergy,
@@ -302,6 +356,7 @@ private:
 				                    target.time(),
 				                    initialVectorBySector,
 				                    loopIndex);
+				levelsSaved[j] = levels_;
 			}
 
 			energySaved[j] = gsEnergy;
@@ -311,8 +366,12 @@ private:
 		if (verbose_ && PsimagLite::Concurrency::root())
 			std::cerr<<"About to calc gs energy\n";
 		gsEnergy=1e6;
-		for (SizeType i = 0; i < totalSectors; ++i)
-			if (energySaved[i] < gsEnergy) gsEnergy = energySaved[i];
+		levels_.clear();
+		for (SizeType i = 0; i < totalSectors; ++i) {
+			if (energySaved[i] >= gsEnergy) continue;
+			gsEnergy = energySaved[i];
+			levels_ = levelsSaved[i];
+		}
 
 		PsimagLite::OstringStream msg3;
 		msg3<<"Ground state energy= "<<gsEnergy;
@@ -452,10 +511,60 @@ private:
 		}
 
 		ParametersForSolverType params(io_, "Lanczos", loopIndex);
+		const RealType toleranceInput = params.tolerance;
+		if (adaptiveTolerance_(params.tolerance, params.steps, loopIndex)) {
+			PsimagLite::OstringStream msg;
+			msg<<"AdaptiveSolverTolerance: tolerance="<<params.tolerance;
+			msg<<" steps="<<params.steps<<" (input tolerance="<<toleranceInput<<")";
+			progress_.printline(msg, std::cout);
+		}
+
+		diagonaliseWithSolver(tmpVec, energyTmp, lanczosHelper, params, initialVector);
+
+		if (!adaptiveTolerance_.enabled()) return;
+		adaptiveTolerance_.recordMatvecs(lanczosHelper.matvecs(),
+		                                 params.tolerance,
+		                                 toleranceInput);
+		PsimagLite::OstringStream msg;
+		msg<<"AdaptiveSolverTolerance: matvecs="<<lanczosHelper.matvecs();
+		msg<<" estimated matvecs saved so far="<<adaptiveTolerance_.matvecsSaved();
+		progress_.printline(msg, std::cout);
+	}
+
+	void diagonaliseWithSolver(TargetVectorType& tmpVec,
+	                           RealType &energyTmp,
+	                           const typename LanczosOrDavidsonBaseType::MatrixType& lanczosHelper,
+	                           const ParametersForSolverType& params,
+	                           const TargetVectorType& initialVector)
+	{
 		LanczosOrDavidsonBaseType* lanczosOrDavidson = 0;
 
+		bool useBlockDavidson = (parameters_.options.find("blockDavidson") !=
+		        PsimagLite::String::npos);
+		if (useBlockDavidson &&
+		        lanczosHelper.rows() > parameters_.excited &&
+		        !reflectionOperator_.isEnabled()) {
+			diagonaliseWithBlockDavidson(tmpVec,
+			                             energyTmp,
+			                             lanczosHelper,
+			                             params,
+			                             initialVector);
+			return;
+		}
+
 		bool useDavidson = (parameters_.options.find("useDavidson") !=
 		        PsimagLite::String::npos);
+		if (useDavidson &&
+		        parameters_.excited == 0 &&
+		        lanczosHelper.rows() > 0 &&
+		        !reflectionOperator_.isEnabled() &&
+		        diagonaliseWithPreconditioner(tmpVec,
+		                                      energyTmp,
+		                                      lanczosHelper,
+		                                      params,
+		                                      initialVector))
+			return;
+
 		if (useDavidson) {
 			lanczosOrDavidson = new DavidsonSolverType(lanczosHelper, params);
 		} else {
@@ -479,29 +588,168 @@ private:
 		try {
 			energyTmp = computeLevel(*lanczosOrDavidson,tmpVec,initialVector);
 		} catch (std::exception& e) {
-			PsimagLite::OstringStream msg0;
-			msg0<<e.what()<<"\n";
-			msg0<<"Lanczos or Davidson solver failed, ";
-			msg0<<"trying with exact diagonalization...";
-			progress_.printline(msg0,std::cout);
-			progress_.printline(msg0,std::cerr);
-
-			VectorRealType eigs(lanczosHelper.rows());
-			PsimagLite::Matrix<ComplexOrRealType> fm;
-			lanczosHelper.fullDiag(eigs,fm);
-			for (SizeType j = 0; j < eigs.size(); ++j)
-				tmpVec[j] = fm(j, 0);
-			energyTmp = eigs[0];
-
-			PsimagLite::OstringStream msg1;
-			msg1<<"Found lowest eigenvalue= "<<energyTmp<<" ";
-			progress_.printline(msg1,std::cout);
+			diagonaliseExactly(tmpVec, energyTmp, lanczosHelper, e, "Lanczos or Davidson");
 		}
 
 		if (lanczosOrDavidson) delete lanczosOrDavidson;
 	}
 
-	RealType computeLevel(LanczosOrDavidsonBaseType& object,
+	void diagonaliseExactly(TargetVectorType& tmpVec,
+	                        RealType &energyTmp,
+	                        const typename LanczosOrDavidsonBaseType::MatrixType& lanczosHelper,
+	                        const std::exception& e,
+	                        PsimagLite::String solverName)
+	{
+		PsimagLite::OstringStream msg0;
+		msg0<<e.what()<<"\n";
+		msg0<<solverName<<" solver failed, ";
+		msg0<<"trying with exact diagonalization...";
+		progress_.printline(msg0,std::cout);
+		progress_.printline(msg0,std::cerr);
+
+		VectorRealType eigs(lanczosHelper.rows());
+		PsimagLite::Matrix<ComplexOrRealType> fm;
+		lanczosHelper.fullDiag(eigs,fm);
+		for (SizeType j = 0; j < eigs.size(); ++j)
+			tmpVec[j] = fm(j, 0);
+		energyTmp = eigs[0];
+
+		PsimagLite::OstringStream msg1;
+		msg1<<"Found lowest eigenvalue= "<<energyTmp<<" ";
+		progress_.printline(msg1,std::cout);
+	}
+
+	// Davidson with the preconditioner given by DavidsonPreconditioner=
+	// Returns false if the matrix-vector class could not fill the
+	// preconditioner, and then the caller falls back to PsimagLite's solvers
+	bool diagonaliseWithPreconditioner(TargetVectorType& tmpVec,
+	                                   RealType &energyTmp,
+	                                   const MatrixVectorType& lanczosHelper,
+	                                   const ParametersForSolverType& params,
+	                                   const TargetVectorType& initialVector)
+	{
+		DavidsonPreconditionerType prec(davidsonPreconditioner_);
+		if (prec.mode() == DavidsonPreconditionerType::ModeEnum::NONE)
+			return false;
+
+		lanczosHelper.fillPreconditioner(prec);
+		if (!prec.enabled()) return false;
+
+		if (lanczosHelper.distributed()) {
+			diagonaliseDistributed(tmpVec, energyTmp, lanczosHelper, prec, params, initialVector);
+			return true;
+		}
+
+		DavidsonSolverPreconditionedType davidson(lanczosHelper,
+		                                          prec,
+		                                          params.steps,
+		                                          sqrt(params.tolerance));
+
+		try {
+			energyTmp = computeLevel(davidson, tmpVec, initialVector);
+		} catch (std::exception& e) {
+			diagonaliseExactly(tmpVec, energyTmp, lanczosHelper, e, "Preconditioned Davidson");
+			return true;
+		}
+
+		printDavidson(davidson, prec, "");
+		return true;
+	}
+
+	// SolverOptions=KronMpi: the Davidson vectors hold the out patches of
+	// this MPI rank only; the full vector is assembled for the result
+	void diagonaliseDistributed(TargetVectorType& tmpVec,
+	                            RealType &energyTmp,
+	                            const MatrixVectorType& lanczosHelper,
+	                            const DavidsonPreconditionerType& prec,
+	                            const ParametersForSolverType& params,
+	                            const TargetVectorType& initialVector)
+	{
+		typedef MatrixVectorLocal<MatrixVectorType> MatrixVectorLocalType;
+		typedef DavidsonSolverPreconditioned<MatrixVectorLocalType, TargetVectorType>
+		        DavidsonSolverLocalType;
+
+		MatrixVectorLocalType localHelper(lanczosHelper);
+		DavidsonSolverLocalType davidson(localHelper,
+		                                 prec,
+		                                 params.steps,
+		                                 sqrt(params.tolerance));
+
+		// each rank takes its slice of the guess, so that a random guess
+		// needs not be the same on all ranks
+		TargetVectorType init = initialVector;
+		if (fabs(PsimagLite::norm(init)) < 1e-12) {
+			PsimagLite::OstringStream msg;
+			msg<<"WARNING: diagonaliseDistributed: Norm of guess vector is zero, ";
+			msg<<"ignoring guess\n";
+			progress_.printline(msg, std::cout);
+			PsimagLite::fillRandom(init);
+		}
+
+		TargetVectorType initLocal;
+		lanczosHelper.toLocal(initLocal, init);
+		TargetVectorType gsLocal;
+		davidson.computeOneState(energyTmp, gsLocal, initLocal, 0);
+		lanczosHelper.fromLocal(tmpVec, gsLocal);
+
+		printDavidson(davidson, prec, " distributed");
+	}
+
+	template<typename SomeDavidsonType>
+	void printDavidson(const SomeDavidsonType& davidson,
+	                   const DavidsonPreconditionerType& prec,
+	                   PsimagLite::String label) const
+	{
+		PsimagLite::OstringStream msg;
+		msg<<"Davidson"<<label<<" preconditioner=";
+		msg<<DavidsonPreconditionerType::toString(prec.mode());
+		msg<<" iterations="<<davidson.iterations();
+		msg<<" matvecs="<<davidson.matvecs();
+		msg<<" residual="<<davidson.residual();
+		if (!davidson.converged()) msg<<" NOT CONVERGED";
+		progress_.printline(msg,std::cout);
+	}
+
+	// Levels 0 to Excited together, in one subspace; uses the preconditioner
+	// given by DavidsonPreconditioner= if the matrix-vector class can fill it,
+	// except with KronMpi on more than one rank, where the preconditioner
+	// would hold only the out patches of this rank, but the block Davidson
+	// vectors are replicated
+	void diagonaliseWithBlockDavidson(TargetVectorType& tmpVec,
+	                                  RealType &energyTmp,
+	                                  const MatrixVectorType& lanczosHelper,
+	                                  const ParametersForSolverType& params,
+	                                  const TargetVectorType& initialVector)
+	{
+		DavidsonPreconditionerType prec(davidsonPreconditioner_);
+		if (prec.mode() != DavidsonPreconditionerType::ModeEnum::NONE &&
+		        !lanczosHelper.distributed())
+			lanczosHelper.fillPreconditioner(prec);
+
+		BlockDavidsonSolverType davidson(lanczosHelper,
+		                                 (prec.enabled()) ? &prec : 0,
+		                                 params.steps,
+		                                 sqrt(params.tolerance));
+
+		energyTmp = computeLevel(davidson, tmpVec, initialVector);
+		levels_ = davidson.energies();
+
+		PsimagLite::OstringStream msg;
+		msg<<"BlockDavidson preconditioner=";
+		msg<<DavidsonPreconditionerType::toString((prec.enabled()) ? prec.mode() :
+		                                          DavidsonPreconditionerType::ModeEnum::NONE);
+		msg<<" iterations="<<davidson.iterations();
+		msg<<" matvecs="<<davidson.matvecs();
+		msg<<" residual="<<davidson.residual();
+		msg<<" energies=";
+		for (SizeType i = 0; i < levels_.size(); ++i)
+			msg<<levels_[i]<<" ";
+		if (!davidson.converged()) msg<<" NOT CONVERGED";
+		progress_.printline(msg,std::cout);
+	}
+
+	template<typename SolverType>
+	RealType computeLevel(SolverType& object,
 	                      TargetVectorType& gsVector,
 	                      const TargetVectorType& initialVector) const
 	{
@@ -570,6 +818,10 @@ private:
 	const typename QnType::VectorQnType& quantumSector_;
 	WaveFunctionTransfType& wft_;
 	RealType oldEnergy_;
+	PsimagLite::String davidsonPreconditioner_;
+	AdaptiveSolverToleranceType adaptiveTolerance_;
+	VectorRealType levels_;
+	AsyncOutputWriter* asyncWriter_;
 }; // class Diagonalization
 } // namespace Dmrg
 
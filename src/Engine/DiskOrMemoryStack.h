@@ -1,8 +1,10 @@
 #ifndef DISKORMEMORYSTACK_H
 #define DISKORMEMORYSTACK_H
 #include "Stack.h"
+#include "Vector.h"
 #include "DiskStackNg.h"
 #include "Io/IoNg.h"
+#include <atomic>
 
 namespace Dmrg {
 
@@ -13,6 +15,7 @@ public:
 
 	typedef typename PsimagLite::Stack<BasisWithOperatorsType>::Type MemoryStackType;
 	typedef DiskStack<BasisWithOperatorsType> DiskStackType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
 
 	DiskOrMemoryStack(bool onDisk,
 	                  const PsimagLite::String filename,
@@ -52,6 +55,8 @@ public:
 		} else {
 			memory_.push(b);
 		}
+
+		ids_.push_back(nextId_++);
 	}
 
 	void pop()
@@ -63,6 +68,19 @@ public:
 		} else {
 			memory_.pop();
 		}
+
+		assert(ids_.size() > 0);
+		ids_.pop_back();
+	}
+
+	// copy of the entries of other, which must be in memory, and of their identifiers
+	void copyFrom(const DiskOrMemoryStack& other)
+	{
+		if (diskR_ || other.diskR_)
+			err("DiskOrMemoryStack::copyFrom(): stacks on disk cannot be copied\n");
+
+		memory_ = other.memory_;
+		ids_ = other.ids_;
 	}
 
 	bool onDisk() const { return (diskR_); }
@@ -77,6 +95,22 @@ public:
 		return (diskR_) ? diskR_->top() : memory_.top();
 	}
 
+	// entry index, 0 being the bottom of the stack; on disk, the reference
+	// is valid until the next call to entry()
+	const BasisWithOperatorsType& entry(SizeType index) const
+	{
+		return (diskR_) ? diskR_->entry(index) : memory_.entry(index);
+	}
+
+	// identifier of entry index; each push gets an identifier not used
+	// before by any stack of this process, so that entries with the same
+	// identifier are the same, because entries cannot be changed in place
+	SizeType id(SizeType index) const
+	{
+		assert(index < ids_.size());
+		return ids_[index];
+	}
+
 	void toDisk(DiskStackType& disk) const
 	{
 		if (diskR_) {
@@ -103,17 +137,33 @@ public:
 
 private:
 
+	class MemoryStackWithEntries : public MemoryStackType {
+
+	public:
+
+		const BasisWithOperatorsType& entry(SizeType index) const
+		{
+			assert(index < this->c.size());
+			return this->c[index];
+		}
+	};
+
 	DiskOrMemoryStack(const DiskOrMemoryStack&);
 
 	DiskOrMemoryStack& operator=(const DiskOrMemoryStack&);
 
 	static bool createFile_;
-	MemoryStackType memory_;
+	static std::atomic<SizeType> nextId_;
+	MemoryStackWithEntries memory_;
 	DiskStackType *diskW_;
 	DiskStackType *diskR_;
+	VectorSizeType ids_;
 };
 
 template<typename BasisWithOperatorsType>
 bool DiskOrMemoryStack<BasisWithOperatorsType>::createFile_ = true;
+
+template<typename BasisWithOperatorsType>
+std::atomic<SizeType> DiskOrMemoryStack<BasisWithOperatorsType>::nextId_(0);
 }
 #endif // DISKORMEMORYSTACK_H
@@ -98,7 +98,8 @@ public:
 	      isObserveCode_(isObserveCode),
 	      total_(0),
 	      progress_("DiskStack"),
-	      dt_(0)
+	      dt_(0),
+	      entry_(0)
 	{
 		if (!needsToRead) {
 			ioOut_->createGroup(label_);
@@ -116,6 +117,8 @@ public:
 	{
 		delete dt_;
 		dt_ = 0;
+		delete entry_;
+		entry_ = 0;
 		delete ioIn_;
 		ioIn_ = 0;
 		delete ioOut_;
@@ -192,6 +195,22 @@ public:
 		return *dt_;
 	}
 
+	// entry index, 0 being the bottom of the stack; the reference is valid
+	// until the next call to entry(), and is not invalidated by top()
+	const DataType& entry(SizeType index) const
+	{
+		if (!ioIn_)
+			err("DiskStack::entry() called with ioIn_ as nullptr\n");
+
+		assert(index < SizeType(total_));
+		delete entry_;
+		entry_ = 0;
+		entry_ = new DataType(*ioIn_,
+		                      label_ + "/" + ttos(index),
+		                      isObserveCode_);
+		return *entry_;
+	}
+
 	SizeType size() const { return total_; }
 
 private:
@@ -207,6 +226,7 @@ private:
 	int total_;
 	PsimagLite::ProgressIndicator progress_;
 	mutable DataType* dt_;
+	mutable DataType* entry_;
 }; // class DiskStack
 
 } // namespace Dmrg
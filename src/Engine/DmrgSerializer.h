@@ -121,18 +121,22 @@ public:
 	{}
 
 	// used only by IoNg:
+	// without withTransform, cols(), rows(), and transform() cannot be used
 	template<typename IoInputType>
 	DmrgSerializer(IoInputType& io,
 	               PsimagLite::String prefix,
 	               bool bogus,
 	               bool isObserveCode,
+	               bool withTransform = true,
 	               typename PsimagLite::EnableIf<
 	               PsimagLite::IsInputLike<IoInputType>::True, int>::Type = 0)
 	    : fS_(io, prefix + "/fS", bogus),
 	      fE_(io, prefix + "/fE", bogus),
-	      lrs_(io, prefix, isObserveCode),
-	      transform_(io, prefix + "/transform")
+	      lrs_(io, prefix, isObserveCode)
 	{
+		if (withTransform)
+			transform_ = BlockDiagonalMatrixType(io, prefix + "/transform");
+
 		if (bogus) return;
 
 		wavefunction_.read(io, prefix + "/WaveFunction");
@@ -147,6 +151,20 @@ public:
 	           SizeType counter,
 	           typename PsimagLite::EnableIf<
 	           PsimagLite::IsOutputLike<SomeIoOutType>::True, int>::Type = 0) const
+	{
+		writeLeftRightSuper(io, prefix, option, numberOfSites, counter);
+		writeOwned(io, prefix, counter);
+	}
+
+	// write() is writeLeftRightSuper() followed by writeOwned()
+	// lrs is not owned by this object, since copies of LeftRightSuper share
+	// the bases, so this part must be written before the bases change
+	template<typename SomeIoOutType>
+	void writeLeftRightSuper(SomeIoOutType& io,
+	                         PsimagLite::String prefix,
+	                         typename BasisWithOperatorsType::SaveEnum option,
+	                         SizeType numberOfSites,
+	                         SizeType counter) const
 	{
 		if (counter == 0) io.createGroup(prefix);
 
@@ -159,11 +177,20 @@ public:
 
 		io.createGroup(prefix);
 
-		fS_.write(io, prefix + "/fS");
-		fE_.write(io, prefix + "/fE");
 		bool minimizeWrite = (lrs_.super().block().size() == numberOfSites);
 		lrs_.write(io, prefix, option, minimizeWrite);
+	}
 
+	// the signs, the wave function, and the transform, which are copies
+	template<typename SomeIoOutType>
+	void writeOwned(SomeIoOutType& io,
+	                PsimagLite::String prefix,
+	                SizeType counter) const
+	{
+		prefix += ("/" + ttos(counter));
+
+		fS_.write(io, prefix + "/fS");
+		fE_.write(io, prefix + "/fE");
 		wavefunction_.write(io, prefix + "/WaveFunction");
 
 		transform_.write(prefix + "/transform", io);
@@ -207,8 +234,17 @@ public:
 
 	void transform(SparseMatrixType& ret, const SparseMatrixType& O) const
 	{
-		BlockOffDiagMatrixType m(O, transform_.offsetsRows());
-		m.transform(transform_);
+		transform(ret, O, transform_);
+	}
+
+	// f is a BlockDiagonalMatrix, or a view with the same interface
+	template<typename SomeBlockDiagonalType>
+	static void transform(SparseMatrixType& ret,
+	                      const SparseMatrixType& O,
+	                      const SomeBlockDiagonalType& f)
+	{
+		BlockOffDiagMatrixType m(O, f.offsetsRows());
+		m.transform(f);
 		m.toSparse(ret);
 	}
 
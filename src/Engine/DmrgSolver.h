@@ -88,11 +88,19 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Recovery.h"
 #include "Truncation.h"
 #include "ObservablesInSitu.h"
+#include "InSituCorrelations.h"
 #include "TargetSelector.h"
 #include "PsiBase64.h"
 #include "PrinterInDetail.h"
 #include "Io/IoSelector.h"
 #include "TargetingBase.h"
+#include "AsyncOutputWriter.h"
+#include "ResourcePlanner.h"
+#include "ParallelizerPool.h"
+#include "SynchronizedLines.h"
+#include "InputCheck.h"
+#include "InputNg.h"
+#include <memory>
 
 namespace Dmrg {
 
@@ -107,6 +115,7 @@ class DmrgSolver {
 	typedef typename OperatorsType::OperatorType OperatorType;
 	typedef ObservablesInSitu<typename TargetingType::TargetVectorType>
 	ObservablesInSituType;
+	typedef InSituCorrelations<TargetingType> InSituCorrelationsType;
 
 public:
 
@@ -135,10 +144,13 @@ public:
 	typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef typename TargetingType::LanczosSolverType LanczosSolverType;
 	typedef PrinterInDetail<LeftRightSuperType> PrinterInDetailType;
+	typedef ResourcePlanner<LeftRightSuperType> ResourcePlannerType;
 	typedef typename DiagonalizationType::BasisWithOperatorsType BasisWithOperatorsType;
 	typedef typename BasisWithOperatorsType::BlockDiagonalMatrixType BlockDiagonalMatrixType;
 	typedef typename BasisWithOperatorsType::QnType QnType;
 	typedef typename QnType::PairSizeType PairSizeType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef typename PsimagLite::Vector<VectorRealType>::Type VectorVectorRealType;
 
 	DmrgSolver(ModelType const &model,
 	           InputValidatorType& ioIn)
@@ -148,7 +160,10 @@ public:
 	      appInfo_("DmrgSolver:"),
 	      verbose_(false),
 	      lrs_("pSprime", "pEprime", "pSE"),
-	      ioOut_(parameters_.filename, PsimagLite::IoSelector::ACC_TRUNC),
+	      ioOutOwned_(new PsimagLite::IoSelector::Out(parameters_.filename,
+	                                                 PsimagLite::IoSelector::ACC_TRUNC)),
+	      ioOut_(*ioOutOwned_),
+	      asyncWriter_(ioOut_, parameters_.options.find("asyncWrite") != PsimagLite::String::npos),
 	      progress_("DmrgSolver"),
 	      stepCurrent_(0),
 	      checkpoint_(parameters_, ioIn, model, false),
@@ -171,8 +186,17 @@ public:
 	                model.geometry(),
 	                ioOut_),
 	      energy_(0.0),
-	      saveData_(parameters_.options.find("noSaveData") == PsimagLite::String::npos)
+	      inSituCorrelations_(model),
+	      resourcePlanner_(parameters_.options.find("resourcePlanner") != PsimagLite::String::npos),
+	      saveData_(parameters_.options.find("noSaveData") == PsimagLite::String::npos),
+	      serializerCounter_(0),
+	      energyCounter_(0),
+	      levelsCounter_(0),
+	      isFork_(false)
 	{
+		// each DmrgSolver writes to a new file
+		QnType::modalStructWritten = false;
+
 		std::cout<<appInfo_;
 		PsimagLite::OstringStream msg;
 		msg<<"Turning the engine on";
@@ -193,8 +217,63 @@ public:
 
 	}
 
+	// A METTS chain of MettsChains=, which continues from the state of
+	// parent after the infinite loop; see runMettsChains()
+	// It reads its own copy of the input, ioIn, and writes to no file
+	DmrgSolver(const DmrgSolver& parent, InputValidatorType& ioIn)
+	    : model_(parent.model_),
+	      parameters_(model_.params()),
+	      ioIn_(ioIn),
+	      appInfo_("DmrgSolver:"),
+	      verbose_(parent.verbose_),
+	      lrs_("pSprime", "pEprime", "pSE"),
+	      ioOutOwned_(0),
+	      ioOut_(parent.ioOut_),
+	      asyncWriter_(ioOut_, false),
+	      progress_("DmrgSolver"),
+	      quantumSector_(parent.quantumSector_),
+	      stepCurrent_(0),
+	      checkpoint_(parameters_, ioIn, model_, false),
+	      wft_(parameters_),
+	      sitesIndices_(parent.sitesIndices_),
+	      reflectionOperator_(lrs_,
+	                          model_.hilbertSize(0),
+	                          parameters_.useReflectionSymmetry,
+	                          ProgramGlobals::DirectionEnum::EXPAND_SYSTEM),
+	      diagonalization_(parameters_,
+	                       model_,
+	                       verbose_,
+	                       reflectionOperator_,
+	                       ioIn,
+	                       quantumSector_,
+	                       wft_,
+	                       checkpoint_.energy()),
+	      truncate_(reflectionOperator_,
+	                wft_,
+	                parameters_,
+	                model_.geometry(),
+	                ioOut_),
+	      energy_(parent.energy_),
+	      inSituCorrelations_(model_),
+	      resourcePlanner_(false),
+	      saveData_(false),
+	      serializerCounter_(0),
+	      energyCounter_(0),
+	      levelsCounter_(0),
+	      isFork_(true)
+	{
+		lrs_.copyFrom(parent.lrs_);
+		checkpoint_.forkStacks(parent.checkpoint_);
+		wft_.fork(parent.wft_);
+	}
+
 	~DmrgSolver()
 	{
+		if (isFork_) return;
+
+		asyncWriter_.wait();
+		asyncWriter_.printStats(std::cout);
+
 		SizeType site = 0; // FIXME FOR IMMM
 		typename BasisWithOperatorsType::VectorBoolType oddElectrons;
 		model_.findOddElectronsOfOneSite(oddElectrons, site);
@@ -203,6 +282,8 @@ public:
 		appInfo_.finalize();
 		ioOut_.write(appInfo_, "ApplicationInfo");
 		ioOut_.close();
+		delete ioOutOwned_;
+		ioOutOwned_ = 0;
 
 		PsimagLite::OstringStream msg2;
 		msg2<<"Turning off the engine.";
@@ -230,6 +311,8 @@ public:
 		                                             quantumSector_,
 		                                             ioIn_);
 		TargetingType& psi = targetSelector();
+		psi.setAsyncWriter(&asyncWriter_);
+		diagonalization_.setAsyncWriter(&asyncWriter_);
 
 		ioIn_.printUnused(std::cerr);
 
@@ -250,6 +333,19 @@ public:
 			infiniteDmrgLoop(X,Y,E,pS,pE,psi);
 		}
 
+		if (resourcePlanner_.enabled()) {
+			resourcePlanner_.print(std::cout,
+			                       ioIn_,
+			                       parameters_.finiteLoop,
+			                       geometry.numberOfSites());
+			return;
+		}
+
+		if (parameters_.mettsChains > 1) {
+			runMettsChains(pS, pE, psi);
+			return;
+		}
+
 		RecoveryType recovery(sitesIndices_, ioOut_, checkpoint_, wft_, pS, pE);
 		finiteDmrgLoops(pS, pE, psi, recovery);
 
@@ -265,6 +361,120 @@ public:
 
 private:
 
+	// One METTS chain per task, see runMettsChains()
+	class MettsChainsHelper {
+
+		typedef PsimagLite::InputNg<InputCheck>::Writeable InputWriteableType;
+
+	public:
+
+		MettsChainsHelper(const DmrgSolver& parent,
+		                  const MyBasisWithOperators& pS,
+		                  const MyBasisWithOperators& pE,
+		                  const TargetingType& psi,
+		                  VectorVectorRealType& energies)
+		    : parent_(parent), pS_(pS), pE_(pE), psi_(psi), energies_(energies)
+		{}
+
+		SizeType tasks() const { return energies_.size(); }
+
+		// the input is read again for each chain, because
+		// InputValidatorType cannot be read by two threads at once
+		void doTask(SizeType chain, SizeType)
+		{
+			SynchronizedLines::Tag tag("MettsChain" + ttos(chain) + ": ");
+			InputCheck inputCheck;
+			InputWriteableType ioWriteable(parent_.ioIn_.data(), inputCheck);
+			InputValidatorType ioIn(ioWriteable);
+
+			DmrgSolver solver(parent_, ioIn);
+			solver.runChain(chain, pS_, pE_, psi_);
+			energies_[chain] = solver.energies_;
+		}
+
+	private:
+
+		const DmrgSolver& parent_;
+		const MyBasisWithOperators& pS_;
+		const MyBasisWithOperators& pE_;
+		const TargetingType& psi_;
+		VectorVectorRealType& energies_;
+	};
+
+	/* PSIDOC DmrgSolverMettsChains
+		With MettsChains=n and MettsTargeting, the infinite loop runs once,
+		and then n METTS chains run the finite loops, each starting from
+		the state after the infinite loop: stacks, bases, WFT and METTS
+		vectors. The infinite loop uses the seed TSPRngSeed, and chain c
+		uses TSPRngSeed + 1 + c. With SolverOptions=threadPool the chains
+		run concurrently on the thread pool, one chain per thread, and
+		otherwise one after the other, each with all threads.
+		The chains do not write to the data file while they run; their
+		energies are written at the end to MettsChains/c/Energy, and their
+		measurements are in standard output, one whole line at a time,
+		each line of chain c starting with MettsChain$c$: and the lines of
+		different chains interleaved. The scripts of Metts.pm separate the
+		chains before reading their measurements.
+	*/
+	void runMettsChains(const MyBasisWithOperators& pS,
+	                    const MyBasisWithOperators& pE,
+	                    const TargetingType& psi)
+	{
+		const SizeType chains = parameters_.mettsChains;
+		VectorVectorRealType energies(chains);
+		MettsChainsHelper helper(*this, pS, pE, psi, energies);
+
+		{
+			SynchronizedLines synchronizedCout(std::cout);
+			if (ThreadPoolEngine::enabled()) {
+				ParallelizerPool<MettsChainsHelper> parallelizer(PsimagLite::Concurrency::
+				                                                 codeSectionParams,
+				                                                 "DmrgSolver::mettsChains");
+				parallelizer.loopCreate(helper);
+			} else {
+				for (SizeType chain = 0; chain < chains; ++chain)
+					helper.doTask(chain, 0);
+			}
+		}
+
+		PsimagLite::OstringStream msg;
+		msg<<chains<<" METTS chains done";
+		progress_.printline(msg, std::cout);
+
+		if (!saveData_) return;
+
+		ioOut_.createGroup("MettsChains");
+		ioOut_.write(chains, "MettsChains/Size");
+		for (SizeType chain = 0; chain < chains; ++chain) {
+			PsimagLite::String prefix("MettsChains/" + ttos(chain));
+			ioOut_.createGroup(prefix);
+			ioOut_.write(energies[chain], prefix + "/Energy");
+		}
+	}
+
+	void runChain(SizeType chain,
+	              const MyBasisWithOperators& pS0,
+	              const MyBasisWithOperators& pE0,
+	              const TargetingType& psi0)
+	{
+		PsimagLite::OstringStream msg;
+		msg<<"MettsChain="<<chain<<" of "<<parameters_.mettsChains<<" starts";
+		progress_.printline(msg, std::cout);
+
+		TargetSelector<TargetingType> targetSelector(lrs_,
+		                                             model_,
+		                                             wft_,
+		                                             quantumSector_,
+		                                             ioIn_);
+		TargetingType& psi = targetSelector();
+		psi.fork(psi0, chain);
+
+		MyBasisWithOperators pS(pS0);
+		MyBasisWithOperators pE(pE0);
+		RecoveryType recovery(sitesIndices_, ioOut_, checkpoint_, wft_, pS, pE);
+		finiteDmrgLoops(pS, pE, psi, recovery);
+	}
+
 	/* PSIDOC DmrgSolverInfiniteDmrgLoop
 		I shall give a procedural description of the DMRG method in the following.
 		We start with an initial block $S$ (the initial system) and $E$ (the initial environment).
@@ -362,13 +572,17 @@ obtain ordered
 			lrs_.setToProduct(quantumSector_[0], initialSizeOfHashTable);
 
 			const BlockType& ystep = findRightBlock(Y,step,E);
+			resourcePlanner_.startStep();
 			energy_ = diagonalization_(psi,
 			                           ProgramGlobals::DirectionEnum::INFINITE,
 			                           X[step],
 			                           ystep);
+			resourcePlanner_.measureSuper(lrs_, quantumSector_[0], psi.gs());
 			printEnergy(energy_);
 
 			truncate_.changeBasisInfinite(pS, pE, psi, parameters_.keptStatesInfinite);
+			resourcePlanner_.measureStack(pS);
+			diagonalization_.setTruncationError(truncate_.error());
 
 			if (needsRightPush) {
 				if (!twoSiteDmrg) checkpoint_.push(pS,pE);
@@ -447,14 +661,21 @@ obtain ordered
 
 			finiteStep(pS, pE, i, psi);
 
+			if (inSituCorrelations_.enabled(i))
+				inSituCorrelations_.print(std::cout);
+
 			if (psi.end()) break;
 
-			if (recovery.byLoop(i))
+			if (recovery.byLoop(i)) {
+				asyncWriter_.flush();
 				recovery.write(psi, i + 1, stepCurrent_, lastSign, ioOut_);
+			}
 		}
 
 		if (!saveData_) return;
 
+		asyncWriter_.flush();
+
 		checkpoint_.write(pS, pE, ioOut_);
 
 		ioOut_.createGroup("FinalPsi");
@@ -551,6 +772,7 @@ obtain ordered
 			printEnergy(energy_);
 
 			changeTruncateAndSerialize(pS,pE,target,keptStates,direction,loopIndex);
+			diagonalization_.setTruncationError(truncate_.error());
 
 			if (finalStep(stepLength, stepFinal)) break;
 
@@ -580,7 +802,13 @@ obtain ordered
 
 		FermionSignType fsE(pE.signs());
 
-		truncate_.changeBasisFinite(pS, pE, target, keptStates, direction);
+		truncate_.changeBasisFinite(pS, pE, target, keptStates, direction, loopIndex);
+
+		inSituCorrelations_(target,
+		                    sitesIndices_[stepCurrent_][0],
+		                    direction,
+		                    loopIndex,
+		                    truncate_.transform(direction));
 
 		if (direction == ProgramGlobals::DirectionEnum::EXPAND_SYSTEM)
 			checkpoint_.push((twoSiteDmrg) ? lrs_.left() : pS,
@@ -598,8 +826,6 @@ obtain ordered
 	           ProgramGlobals::DirectionEnum direction,
 	           SizeType loopIndex)
 	{
-		static SizeType counter = 0;
-
 		if (!saveData_) return;
 
 		int saveOption = parameters_.finiteLoop[loopIndex].saveOption;
@@ -624,12 +850,19 @@ obtain ordered
 		        : BasisWithOperatorsType::SaveEnum::PARTIAL;
 		SizeType numberOfSites = model_.geometry().numberOfSites();
 		PsimagLite::String prefix("Serializer");
-		ds->write(ioOut_, prefix, saveOption2, numberOfSites, counter);
-		PsimagLite::String prefixForTarget = TargetingType::buildPrefix(ioOut_, counter);
+		asyncWriter_.flush();
+		PsimagLite::String prefixForTarget = TargetingType::buildPrefix(ioOut_,
+		                                                                serializerCounter_);
 		target.write(sitesIndices_[stepCurrent_], ioOut_, prefixForTarget);
-		++counter;
-		delete ds;
-		ds = 0;
+
+		// the bases are shared with lrs_, and change in the next step, so they
+		// are written now; with asyncWrite the rest, which ds owns, is written
+		// during the next diagonalization
+		SizeType counter = serializerCounter_++;
+		ds->writeLeftRightSuper(ioOut_, prefix, saveOption2, numberOfSites, counter);
+		std::shared_ptr<DmrgSerializerType> dsShared(ds);
+		asyncWriter_.push([dsShared, prefix, counter](PsimagLite::IoSelector::Out& io)
+		{ dsShared->writeOwned(io, prefix, counter); });
 	}
 
 	bool finalStep(int stepLength,int stepFinal)
@@ -653,19 +886,36 @@ obtain ordered
 
 	void printEnergy(RealType energy)
 	{
+		if (isFork_) energies_.push_back(energy);
 		if (!saveData_) return;
-		static SizeType counter = 0;
-		if (counter == 0) {
+		asyncWriter_.flush();
+		if (energyCounter_ == 0) {
 			try {
 				PsimagLite::IoSelector::In ioIn(ioOut_.filename());
 				SizeType x = 0;
 				ioIn.read(x, "Energy/Size");
 				ioIn.close();
-				counter = x;
+				energyCounter_ = x;
+			} catch (...) {}
+		}
+
+		ioOut_.writeVectorEntry(energy, "Energy", energyCounter_++);
+
+		// all levels up to Excited, with SolverOptions=blockDavidson; only steps
+		// solved by block Davidson have them, so Levels has its own counter
+		const typename DiagonalizationType::VectorRealType& levels = diagonalization_.levels();
+		if (levels.size() == 0) return;
+		if (levelsCounter_ == 0) {
+			try {
+				PsimagLite::IoSelector::In ioIn(ioOut_.filename());
+				SizeType x = 0;
+				ioIn.read(x, "Levels/Size");
+				ioIn.close();
+				levelsCounter_ = x;
 			} catch (...) {}
 		}
 
-		ioOut_.writeVectorEntry(energy, "Energy", counter++);
+		ioOut_.writeVectorEntry(levels, "Levels", levelsCounter_++);
 	}
 
 	const BlockType& findRightBlock(const VectorBlockType& y,
@@ -683,7 +933,9 @@ obtain ordered
 	PsimagLite::ApplicationInfo appInfo_;
 	bool verbose_;
 	LeftRightSuperType lrs_;
-	PsimagLite::IoSelector::Out ioOut_;
+	PsimagLite::IoSelector::Out* ioOutOwned_;
+	PsimagLite::IoSelector::Out& ioOut_;
+	AsyncOutputWriter asyncWriter_;
 	PsimagLite::ProgressIndicator progress_;
 	typename QnType::VectorQnType quantumSector_;
 	int stepCurrent_;
@@ -695,7 +947,14 @@ obtain ordered
 	TruncationType truncate_;
 	ObservablesInSituType inSitu_;
 	RealType energy_;
+	InSituCorrelationsType inSituCorrelations_;
+	ResourcePlannerType resourcePlanner_;
 	bool saveData_;
+	SizeType serializerCounter_;
+	SizeType energyCounter_;
+	SizeType levelsCounter_;
+	bool isFork_;
+	VectorRealType energies_;
 }; //class DmrgSolver
 } // namespace Dmrg
 
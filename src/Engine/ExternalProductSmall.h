@@ -0,0 +1,209 @@
+#ifndef EXTERNAL_PRODUCT_SMALL_H
+#define EXTERNAL_PRODUCT_SMALL_H
+#include "Vector.h"
+#include "CrsMatrix.h"
+
+// Outer products of an operator with an identity, as PsimagLite::externalProduct,
+// for one-site dimensions D = 2, 3, 4, and 16 known at compile time
+// The product basis has index i + alpha*nrow, i of basis2 and alpha of basis3;
+// order is true for operators of basis2, and false for operators of basis3,
+// which get the signs of basis2
+// Either the operator or the identity has size D, depending on whether a site
+// is added to the system or to the environment; the small factor is copied
+// into fixed size arrays and the output is written in place
+namespace Dmrg {
+
+template<typename SparseMatrixType, SizeType D>
+class ExternalProductSmall {
+
+	typedef typename SparseMatrixType::value_type ComplexOrRealType;
+
+public:
+
+	// returns false if neither A nor the identity has size D
+	template<typename VectorRealType>
+	static bool apply(SparseMatrixType& B,
+	                  const SparseMatrixType& A,
+	                  SizeType n,
+	                  const VectorRealType& signs,
+	                  bool order)
+	{
+		if (A.rows() == D) {
+			if (order)
+				siteTimesIdentity(B, A, n);
+			else
+				identityTimesSite(B, A, n, signs);
+			return true;
+		}
+
+		if (n != D) return false;
+
+		if (order)
+			blockTimesIdentity(B, A);
+		else
+			identityTimesBlock(B, A, signs);
+		return true;
+	}
+
+private:
+
+	struct SmallMatrix {
+
+		SmallMatrix(const SparseMatrixType& A)
+		    : nonZeros(0)
+		{
+			for (SizeType i = 0; i < D; ++i) {
+				counts[i] = 0;
+				for (int k = A.getRowPtr(i); k < A.getRowPtr(i + 1); ++k) {
+					assert(counts[i] < D);
+					cols[i][counts[i]] = A.getCol(k);
+					values[i][counts[i]] = A.getValue(k);
+					++counts[i];
+				}
+
+				nonZeros += counts[i];
+			}
+		}
+
+		SizeType counts[D];
+		SizeType cols[D][D];
+		ComplexOrRealType values[D][D];
+		SizeType nonZeros;
+	};
+
+	// B(i + alpha*D, j + alpha*D) = A(i, j), A of size D
+	static void siteTimesIdentity(SparseMatrixType& B,
+	                              const SparseMatrixType& A,
+	                              SizeType n)
+	{
+		const SmallMatrix a(A);
+		B.clear();
+		B.resize(n*D, n*D, n*a.nonZeros);
+		SizeType ptr = 0;
+		for (SizeType alpha = 0; alpha < n; ++alpha) {
+			const SizeType offset = alpha*D;
+			for (SizeType i = 0; i < D; ++i) {
+				B.setRow(i + offset, ptr);
+				for (SizeType k = 0; k < a.counts[i]; ++k) {
+					B.setCol(ptr + k, a.cols[i][k] + offset);
+					B.setValues(ptr + k, a.values[i][k]);
+				}
+
+				ptr += a.counts[i];
+			}
+		}
+
+		B.setRow(n*D, ptr);
+		B.checkValidity();
+	}
+
+	// B(alpha + i*n, alpha + j*n) = A(i, j) signs[alpha], A of size D
+	template<typename VectorRealType>
+	static void identityTimesSite(SparseMatrixType& B,
+	                              const SparseMatrixType& A,
+	                              SizeType n,
+	                              const VectorRealType& signs)
+	{
+		assert(signs.size() == n);
+		const SmallMatrix a(A);
+		B.clear();
+		B.resize(n*D, n*D, n*a.nonZeros);
+		SizeType ptr = 0;
+		for (SizeType i = 0; i < D; ++i) {
+			SizeType cols[D];
+			for (SizeType k = 0; k < a.counts[i]; ++k)
+				cols[k] = a.cols[i][k]*n;
+
+			for (SizeType alpha = 0; alpha < n; ++alpha) {
+				B.setRow(alpha + i*n, ptr);
+				for (SizeType k = 0; k < a.counts[i]; ++k) {
+					B.setCol(ptr + k, cols[k] + alpha);
+					B.setValues(ptr + k, a.values[i][k]*signs[alpha]);
+				}
+
+				ptr += a.counts[i];
+			}
+		}
+
+		B.setRow(n*D, ptr);
+		B.checkValidity();
+	}
+
+	// B(i + alpha*nrow, j + alpha*nrow) = A(i, j), identity of size D
+	static void blockTimesIdentity(SparseMatrixType& B, const SparseMatrixType& A)
+	{
+		const SizeType nrow = A.rows();
+		const SizeType start = A.getRowPtr(0);
+		const SizeType nonZeros = A.getRowPtr(nrow) - start;
+		B.clear();
+		B.resize(nrow*D, nrow*D, nonZeros*D);
+		for (SizeType alpha = 0; alpha < D; ++alpha) {
+			const SizeType offset = alpha*nrow;
+			const SizeType ptrOffset = alpha*nonZeros;
+			for (SizeType i = 0; i < nrow; ++i)
+				B.setRow(i + offset, A.getRowPtr(i) - start + ptrOffset);
+
+			for (SizeType k = 0; k < nonZeros; ++k) {
+				B.setCol(k + ptrOffset, A.getCol(k + start) + offset);
+				B.setValues(k + ptrOffset, A.getValue(k + start));
+			}
+		}
+
+		B.setRow(nrow*D, nonZeros*D);
+		B.checkValidity();
+	}
+
+	// B(alpha + i*D, alpha + j*D) = A(i, j) signs[alpha], identity of size D
+	template<typename VectorRealType>
+	static void identityTimesBlock(SparseMatrixType& B,
+	                               const SparseMatrixType& A,
+	                               const VectorRealType& signs)
+	{
+		assert(signs.size() == D);
+		const SizeType nrow = A.rows();
+		const SizeType start = A.getRowPtr(0);
+		const SizeType nonZeros = A.getRowPtr(nrow) - start;
+		typename VectorRealType::value_type s[D];
+		for (SizeType alpha = 0; alpha < D; ++alpha)
+			s[alpha] = signs[alpha];
+
+		B.clear();
+		B.resize(nrow*D, nrow*D, nonZeros*D);
+		SizeType ptr = 0;
+		for (SizeType i = 0; i < nrow; ++i) {
+			const SizeType kstart = A.getRowPtr(i);
+			const SizeType count = A.getRowPtr(i + 1) - kstart;
+			for (SizeType alpha = 0; alpha < D; ++alpha) {
+				B.setRow(alpha + i*D, ptr);
+				for (SizeType k = 0; k < count; ++k) {
+					B.setCol(ptr + k, A.getCol(kstart + k)*D + alpha);
+					B.setValues(ptr + k, A.getValue(kstart + k)*s[alpha]);
+				}
+
+				ptr += count;
+			}
+		}
+
+		B.setRow(nrow*D, ptr);
+		B.checkValidity();
+	}
+};
+
+// Uses ExternalProductSmall if the operator or the identity has
+// size 2, 3, 4, or 16, and PsimagLite::externalProduct otherwise
+template<typename SparseMatrixType, typename VectorRealType>
+void externalProductSmall(SparseMatrixType& B,
+                          const SparseMatrixType& A,
+                          SizeType n,
+                          const VectorRealType& signs,
+                          bool order)
+{
+	if (ExternalProductSmall<SparseMatrixType, 2>::apply(B, A, n, signs, order)) return;
+	if (ExternalProductSmall<SparseMatrixType, 4>::apply(B, A, n, signs, order)) return;
+	if (ExternalProductSmall<SparseMatrixType, 3>::apply(B, A, n, signs, order)) return;
+	if (ExternalProductSmall<SparseMatrixType, 16>::apply(B, A, n, signs, order)) return;
+
+	PsimagLite::externalProduct(B, A, n, signs, order);
+}
+}
+#endif // EXTERNAL_PRODUCT_SMALL_H
@@ -116,6 +116,17 @@ public:
 	                     SizeType i3,
 	                     SizeType i4,
 	                     const BraketType& braket) const
+	{
+		checkFourPoint(i1, i2, i3, i4);
+
+		SparseMatrixType O2gt;
+
+		firstStage(O2gt,'N',i1,'N',i2,braket,0,1);
+
+		return secondStage(O2gt, i2, 'C', i3, 'C', i4, braket, 2, 3);
+	}
+
+	static void checkFourPoint(SizeType i1, SizeType i2, SizeType i3, SizeType i4)
 	{
 		if (i1>i2 || i3>i4 || i2>i3)
 			throw PsimagLite::RuntimeError("calcCorrelation: FourPoint needs ordered points\n");
@@ -125,12 +136,6 @@ public:
 			throw PsimagLite::RuntimeError("calcCorrelation: FourPoint needs distinct points\n");
 		if (i2==i3 || i1==i4)
 			throw PsimagLite::RuntimeError("calcCorrelation: FourPoint needs distinct points\n");
-
-		SparseMatrixType O2gt;
-
-		firstStage(O2gt,'N',i1,'N',i2,braket,0,1);
-
-		return secondStage(O2gt, i2, 'C', i3, 'C', i4, braket, 2, 3);
 	}
 
 	//! 3-point: these are expensive and uncached!!!
@@ -241,6 +246,43 @@ public:
 	                      const BraketType& braket,
 	                      SizeType index0,
 	                      SizeType index1) const
+	{
+		int ns = i3 - 1;
+		if (ns<0) ns = 0;
+		SparseMatrixType Otmp;
+		if (index0 == 0) err("secondStage\n");
+
+		growDirectly4p(Otmp,O2gt,i2+1,braket.op(index0 - 1).fermionOrBoson,ns);
+
+		return secondStageGrown(Otmp, mod3, i3, mod4, i4, braket, index0, index1);
+	}
+
+	// Quadruples that share i1, i2 and the first two operators share O2gt,
+	// and the growth of O2gt in secondStage, which depends only on i3
+	// Going through them with i3 non decreasing, O2grown starts as O2gt
+	// with grownTo = i2, and growTowards extends it from one i3 to the next;
+	// secondStageGrown then does the rest of secondStage
+	void growTowards(SparseMatrixType& O2grown,
+	                 SizeType& grownTo,
+	                 SizeType i3,
+	                 ProgramGlobals::FermionOrBosonEnum fermionS) const
+	{
+		int ns = i3 - 1;
+		if (ns<0) ns = 0;
+		assert(SizeType(ns) >= grownTo);
+		growDirectly4pFrom(O2grown, fermionS, grownTo, ns);
+		grownTo = ns;
+	}
+
+	//! requires i2<i3<i4, with O2grown grown up to i3 - 1, see growTowards
+	FieldType secondStageGrown(const SparseMatrixType& O2grown,
+	                           char mod3,
+	                           SizeType i3,
+	                           char mod4,
+	                           SizeType i4,
+	                           const BraketType& braket,
+	                           SizeType index0,
+	                           SizeType index1) const
 	{
 		// Take care of modifiers
 		SparseMatrixType O3m,O4m;
@@ -251,15 +293,12 @@ public:
 		int ns = i3 - 1;
 		if (ns<0) ns = 0;
 		SparseMatrixType Otmp;
-		if (index0 == 0) err("secondStage\n");
-
-		growDirectly4p(Otmp,O2gt,i2+1,braket.op(index0 - 1).fermionOrBoson,ns);
 
 		SparseMatrixType O3g,O4g;
 		if (i4 == skeleton_.numberOfSites() - 1) {
 			if (i3<i4-1) { // still not tested (2018-02-27)
 				const SizeType ptr = skeleton_.dmrgMultiply(O3g,
-				                                            Otmp,
+				                                            O2grown,
 				                                            O3m,
 				                                            braket.op(index0).fermionOrBoson,
 				                                            ns);
@@ -280,7 +319,7 @@ public:
 				                                    braket.ket());
 			}
 
-			return skeleton_.bracketRightCorner(Otmp,
+			return skeleton_.bracketRightCorner(O2grown,
 			                                    O3m,
 			                                    O4m,
 			                                    braket.op(index1).fermionOrBoson,
@@ -289,7 +328,7 @@ public:
 			                                    braket.ket());
 		}
 
-		skeleton_.dmrgMultiply(O3g,Otmp,O3m,braket.op(index0).fermionOrBoson,ns);
+		skeleton_.dmrgMultiply(O3g,O2grown,O3m,braket.op(index0).fermionOrBoson,ns);
 
 		SparseMatrixType O3gt;
 		helper.transform(O3gt, O3g, ns);
@@ -393,9 +432,18 @@ private:
 		int nt=i-1;
 		if (nt<0) nt=0;
 
+		growDirectly4pFrom(Odest, fermionicSign, nt, ns);
+	}
+
+	// continues growDirectly4p from s = from
+	void growDirectly4pFrom(SparseMatrixType& Odest,
+	                        ProgramGlobals::FermionOrBosonEnum fermionicSign,
+	                        SizeType from,
+	                        SizeType ns) const
+	{
 		const ObserverHelperType& helper = skeleton_.helper();
 
-		for (SizeType s = nt; s < ns; ++s) {
+		for (SizeType s = from; s < ns; ++s) {
 			SparseMatrixType Onew(helper.cols(s), helper.cols(s));
 			skeleton_.fluffUp(Onew,
 			                  Odest,
@@ -86,6 +86,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Vector.h"
 #include "VerySparseMatrix.h"
 #include "ProgressIndicator.h"
+#include "LinkTableCache.h"
 
 namespace Dmrg {
 
@@ -116,6 +117,8 @@ public:
 	typedef typename LeftRightSuperType::KroneckerDumperType KroneckerDumperType;
 	typedef typename PsimagLite::Vector<LinkType>::Type VectorLinkType;
 	typedef typename ModelLinksType::HermitianEnum HermitianEnum;
+	typedef LinkTableCache<LinkType, RealType> LinkTableCacheType;
+	typedef typename LinkTableCacheType::LinkTable LinkTableType;
 
 	HamiltonianConnection(SizeType m,
 	                      const LeftRightSuperType& lrs,
@@ -132,17 +135,31 @@ public:
 	      systemBlock_(modelHelper_.leftRightSuper().left().block()),
 	      envBlock_(modelHelper_.leftRightSuper().right().block()),
 	      smax_(*std::max_element(systemBlock_.begin(),systemBlock_.end())),
-	      emin_(*std::min_element(envBlock_.begin(),envBlock_.end())),
-	      hamAbstract_(superGeometry_,
-	                   smax_,
-	                   emin_,
-	                   modelHelper_.leftRightSuper().super().block()),
-	      totalOnes_(hamAbstract_.items())
+	      emin_(*std::min_element(envBlock_.begin(),envBlock_.end()))
 	{
-		lps_.reserve(ProgramGlobals::MAX_LPS);
-		SizeType nitems = hamAbstract_.items();
-		for (SizeType x = 0; x < nitems; ++x)
-			totalOnes_[x] = cacheConnections(x);
+		const VectorSizeType& superBlock = modelHelper_.leftRightSuper().super().block();
+		typename LinkTableCacheType::Key key(&geometry, smax_, emin_, superBlock, targetTime_);
+		linkTable_ = LinkTableCacheType::find(key);
+		if (!linkTable_) {
+			HamiltonianAbstractType hamAbstract(superGeometry_, smax_, emin_, superBlock);
+			LinkTableType* table = new LinkTableType;
+			table->links.reserve(ProgramGlobals::MAX_LPS);
+			SizeType nitems = hamAbstract.items();
+			table->totalOnes.resize(nitems);
+			for (SizeType x = 0; x < nitems; ++x)
+				table->totalOnes[x] = cacheConnections(table->links, hamAbstract.item(x));
+
+			linkTable_.reset(table);
+			LinkTableCacheType::insert(key, linkTable_);
+		}
+
+		const VectorLinkType& lps = linkTable_->links;
+		for (SizeType x = 0; ModelHelperType::isSu2() && x < lps.size(); ++x) {
+			SparseMatrixType const* A = 0;
+			SparseMatrixType const* B = 0;
+			const LinkType& link2 = getKron(&A, &B, x);
+			modelHelper_.cacheOperators(*A, *B, link2);
+		}
 
 		SizeType last = lrs.super().block().size();
 		assert(last > 0);
@@ -156,12 +173,12 @@ public:
 			return; // <-- CONDITIONAL EARLY EXIT HERE
 
 		PsimagLite::OstringStream msg;
-		msg<<"LinkProductStructSize="<<lps_.size();
+		msg<<"LinkProductStructSize="<<lps.size();
 		progress_.printline(msg,std::cout);
 
 		PsimagLite::OstringStream msg2;
 		// add left and right contributions
-		msg2<<"PthreadsTheoreticalLimitForThisPart="<<(lps_.size() + 2);
+		msg2<<"PthreadsTheoreticalLimitForThisPart="<<(lps.size() + 2);
 
 		// The theoretical maximum number of pthreads that are useful
 		// is equal to C + 2, where
@@ -190,12 +207,13 @@ public:
 	{
 		SizeType matrixRank = matrix.rows();
 		VerySparseMatrixType matrix2(matrixRank, matrixRank);
-		SizeType nitems = totalOnes_.size();
+		const VectorSizeType& totalOnes = linkTable_->totalOnes;
+		SizeType nitems = totalOnes.size();
 
 		SizeType x = 0;
 		for (SizeType xx = 0; xx < nitems; ++xx) {
 			SparseMatrixType matrixBlock(matrixRank, matrixRank);
-			for (SizeType i = 0; i < totalOnes_[xx]; ++i) {
+			for (SizeType i = 0; i < totalOnes[xx]; ++i) {
 				SparseMatrixType mBlock;
 				SparseMatrixType const* A = 0;
 				SparseMatrixType const* B = 0;
@@ -216,8 +234,8 @@ public:
 	                        const SparseMatrixType** B,
 	                        SizeType xx) const
 	{
-		assert(xx < lps_.size());
-		const LinkType& link2 = lps_[xx];
+		assert(xx < linkTable_->links.size());
+		const LinkType& link2 = linkTable_->links[xx];
 
 		assert(link2.type == ProgramGlobals::ConnectionEnum::SYSTEM_ENVIRON ||
 		       link2.type == ProgramGlobals::ConnectionEnum::ENVIRON_SYSTEM);
@@ -266,13 +284,15 @@ public:
 
 	const ModelHelperType& modelHelper() const { return modelHelper_; }
 
-	SizeType tasks() const {return lps_.size(); }
+	SizeType tasks() const {return linkTable_->links.size(); }
+
+	// the model links have changed
+	static void clearCache() { LinkTableCacheType::clear(); }
 
 private:
 
-	SizeType cacheConnections(SizeType x)
+	SizeType cacheConnections(VectorLinkType& lps, const VectorSizeType& hItems) const
 	{
-		const VectorSizeType& hItems = hamAbstract_.item(x);
 		assert(superGeometry_.connected(smax_, emin_, hItems));
 
 		ProgramGlobals::ConnectionEnum type = superGeometry_.connectionKind(smax_, hItems);
@@ -318,7 +338,7 @@ private:
 				        oneLink.category);
 
 				++totalOne;
-				lps_.push_back(link2);
+				lps.push_back(link2);
 
 				// add h.c. parts if needed
 				if (connectionIsHermitian(link2)) continue;
@@ -333,7 +353,7 @@ private:
 				link2.mods.second = saved;
 
 				++totalOne;
-				lps_.push_back(link2);
+				lps.push_back(link2);
 
 			}
 		}
@@ -382,19 +402,17 @@ private:
 		return (isHermit1 && isHermit2);
 	}
 
-	const ModelHelperType modelHelper_;
+	ModelHelperType modelHelper_;
 	SuperGeometryType superGeometry_;
 	const ModelLinksType& lpb_;
 	RealType targetTime_;
 	mutable KroneckerDumperType kroneckerDumper_;
 	PsimagLite::ProgressIndicator progress_;
-	VectorLinkType lps_;
 	const VectorSizeType& systemBlock_;
 	const VectorSizeType& envBlock_;
 	SizeType smax_;
 	SizeType emin_;
-	HamiltonianAbstractType hamAbstract_;
-	VectorSizeType totalOnes_;
+	typename LinkTableCacheType::LinkTablePtrType linkTable_;
 }; // class HamiltonianConnection
 } // namespace Dmrg
 
@@ -0,0 +1,332 @@
+#ifndef INSITU_CORRELATIONS_H
+#define INSITU_CORRELATIONS_H
+#include "Vector.h"
+#include "PsimagLite.h"
+#include "Matrix.h"
+#include "PackIndices.h"
+#include "GetBraOrKet.h"
+#include "Braket.h"
+#include "FermionSign.h"
+#include "ChangeOfBasis.h"
+#include "ProgramGlobals.h"
+
+namespace Dmrg {
+
+/* PSIDOC InSituCorrelations
+	With InSituCorrelations=braket1,braket2,... in the input, where each braket
+	is a two-point braket such as <gs|c?0';c?0|gs>, with bare operators,
+	the correlations $\langle A_i B_j\rangle$ for $i\le j$ are computed during
+	the last finite loop, which must expand the system (positive stepLength),
+	and printed to the standard output at the end of that loop.
+	For each braket, the operator $A_i$ of each site $i$ visited in that loop
+	is grown with the system block and changed to each new basis,
+	so that no data needs to be saved and no observe pass is needed.
+	Only the sites that are the center site in that loop are included.
+	Each braket needs one $m\times m$ operator per visited site.
+	Not supported with SU(2) symmetry.
+	*/
+template<typename TargetingType>
+class InSituCorrelations {
+
+	typedef typename TargetingType::ModelType ModelType;
+	typedef typename TargetingType::LeftRightSuperType LeftRightSuperType;
+	typedef typename TargetingType::BasisWithOperatorsType BasisWithOperatorsType;
+	typedef typename TargetingType::ComplexOrRealType ComplexOrRealType;
+	typedef typename TargetingType::VectorWithOffsetType VectorWithOffsetType;
+	typedef typename VectorWithOffsetType::VectorType VectorType;
+	typedef Braket<ModelType> BraketType;
+	typedef typename BraketType::AlgebraType OperatorType;
+	typedef typename OperatorType::StorageType SparseMatrixType;
+	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+	typedef PsimagLite::PackIndices PackIndicesType;
+	typedef PsimagLite::Vector<bool>::Type VectorBoolType;
+	typedef PsimagLite::Vector<PsimagLite::String>::Type VectorStringType;
+
+	// operator A of site, in the basis of the system block
+	struct GrownOperator {
+
+		GrownOperator(SizeType site_) : site(site_) {}
+
+		SizeType site;
+		SparseMatrixType data;
+	};
+
+	typedef typename PsimagLite::Vector<GrownOperator>::Type VectorGrownOperatorType;
+
+	struct Correlation {
+
+		Correlation(const ModelType& model, PsimagLite::String label, SizeType sites)
+		    : braket(model, label), values(sites, sites)
+		{
+			values.setTo(0.0);
+		}
+
+		BraketType braket;
+		VectorGrownOperatorType grown;
+		MatrixType values;
+	};
+
+	typedef typename PsimagLite::Vector<Correlation>::Type VectorCorrelationType;
+
+public:
+
+	InSituCorrelations(const ModelType& model)
+	    : model_(model), loop_(0)
+	{
+		VectorStringType labels;
+		PsimagLite::split(labels, model.params().insituCorrelations, ",");
+		if (labels.size() == 0) return;
+
+		if (BasisWithOperatorsType::useSu2Symmetry())
+			err("FATAL: InSituCorrelations= not supported with SU(2)\n");
+
+		const SizeType loops = model.params().finiteLoop.size();
+		if (loops == 0 || model.params().finiteLoop[loops - 1].stepLength <= 0)
+			err("FATAL: InSituCorrelations= needs a last finite loop with positive stepLength\n");
+
+		loop_ = loops - 1;
+		const SizeType sites = model.geometry().numberOfSites();
+		for (SizeType i = 0; i < labels.size(); ++i) {
+			correlations_.push_back(Correlation(model, labels[i], sites));
+			if (correlations_[i].braket.points() != 2)
+				err("FATAL: InSituCorrelations= " + labels[i] + " is not a two-point braket\n");
+		}
+	}
+
+	bool enabled(SizeType loopIndex) const
+	{
+		return (correlations_.size() > 0 && loopIndex == loop_);
+	}
+
+	// Measures for the center site, and then changes the grown operators,
+	// and the one of site, to the basis given by transform, which
+	// must be the truncation of target.lrs().left()
+	template<typename BlockDiagonalMatrixType>
+	void operator()(const TargetingType& target,
+	                SizeType site,
+	                ProgramGlobals::DirectionEnum direction,
+	                SizeType loopIndex,
+	                const BlockDiagonalMatrixType& transform)
+	{
+		if (!enabled(loopIndex)) return;
+
+		if (direction != ProgramGlobals::DirectionEnum::EXPAND_SYSTEM)
+			err("InSituCorrelations: internal error, expected EXPAND_SYSTEM\n");
+
+		typedef ChangeOfBasis<SparseMatrixType,
+		        typename BlockDiagonalMatrixType::BuildingBlockType> ChangeOfBasisType;
+
+		const LeftRightSuperType& lrs = target.lrs();
+		VectorBoolType oddElectrons;
+		model_.findOddElectronsOfOneSite(oddElectrons, site);
+		FermionSign fs(lrs.left(), oddElectrons);
+
+		for (SizeType c = 0; c < correlations_.size(); ++c) {
+			Correlation& correlation = correlations_[c];
+			measure(correlation, target, fs, site);
+
+			VectorGrownOperatorType& grown = correlation.grown;
+			for (SizeType i = 0; i < grown.size(); ++i) {
+				SparseMatrixType lifted;
+				liftBlockOperator(lifted, grown[i].data, lrs);
+				ChangeOfBasisType::changeBasis(lifted, transform);
+				grown[i].data = lifted;
+			}
+
+			grown.push_back(GrownOperator(site));
+			liftSiteOperator(grown.back().data, correlation.braket.op(0), lrs, fs);
+			ChangeOfBasisType::changeBasis(grown.back().data, transform);
+		}
+	}
+
+	void print(std::ostream& os) const
+	{
+		for (SizeType c = 0; c < correlations_.size(); ++c) {
+			os<<"InSituCorrelations "<<correlations_[c].braket.toString()<<"\n";
+			os<<correlations_[c].values;
+		}
+	}
+
+private:
+
+	// values(i, site) = <bra|A_i B_site|ket> for all grown i, and i = site
+	void measure(Correlation& correlation,
+	             const TargetingType& target,
+	             const FermionSign& fs,
+	             SizeType site) const
+	{
+		const LeftRightSuperType& lrs = target.lrs();
+		const BraketType& braket = correlation.braket;
+		const VectorWithOffsetType& bra = getVector(target, braket.bra());
+		const VectorWithOffsetType& ket = getVector(target, braket.ket());
+
+		const SizeType total = lrs.super().permutationVector().size();
+		VectorType ketFull(total, 0.0);
+		for (SizeType ii = 0; ii < ket.sectors(); ++ii) {
+			SizeType i = ket.sector(ii);
+			SizeType offset = ket.offset(i);
+			for (SizeType k = 0; k < ket.effectiveSize(i); ++k)
+				ketFull[offset + k] = ket.fastAccess(i, k);
+		}
+
+		VectorType phi(total, 0.0);
+		applySiteOperator(phi, ketFull, braket.op(1), lrs, fs);
+
+		VectorType chi(total, 0.0);
+		applySiteOperator(chi, phi, braket.op(0), lrs, fs);
+		correlation.values(site, site) = dot(bra, chi);
+
+		const VectorGrownOperatorType& grown = correlation.grown;
+		for (SizeType i = 0; i < grown.size(); ++i)
+			correlation.values(grown[i].site, site) = dotBlock(bra, grown[i].data, phi, lrs);
+	}
+
+	static const VectorWithOffsetType& getVector(const TargetingType& target,
+	                                             PsimagLite::String braOrKet)
+	{
+		PsimagLite::GetBraOrKet getBraOrKet(braOrKet);
+		SizeType ind = getBraOrKet();
+		return (ind == 0) ? target.gs() : target(ind - 1);
+	}
+
+	// <bra|v>
+	static ComplexOrRealType dot(const VectorWithOffsetType& bra, const VectorType& v)
+	{
+		ComplexOrRealType sum = 0.0;
+		for (SizeType ii = 0; ii < bra.sectors(); ++ii) {
+			SizeType i = bra.sector(ii);
+			SizeType offset = bra.offset(i);
+			for (SizeType k = 0; k < bra.effectiveSize(i); ++k)
+				sum += PsimagLite::conj(bra.fastAccess(i, k))*v[offset + k];
+		}
+
+		return sum;
+	}
+
+	// <bra|(G x 1)|v>, with G in the basis of the block before the center site
+	static ComplexOrRealType dotBlock(const VectorWithOffsetType& bra,
+	                                  const SparseMatrixType& g,
+	                                  const VectorType& v,
+	                                  const LeftRightSuperType& lrs)
+	{
+		const SizeType ns = lrs.left().permutationVector().size();
+		const SizeType nprev = g.rows();
+		PackIndicesType pack1(ns);
+		PackIndicesType pack2(nprev);
+		ComplexOrRealType sum = 0.0;
+		for (SizeType ii = 0; ii < bra.sectors(); ++ii) {
+			SizeType i0 = bra.sector(ii);
+			SizeType offset = bra.offset(i0);
+			for (SizeType k = 0; k < bra.effectiveSize(i0); ++k) {
+				SizeType x = 0;
+				SizeType y = 0;
+				pack1.unpack(x, y, lrs.super().permutation(offset + k));
+				SizeType x0 = 0;
+				SizeType x1 = 0;
+				pack2.unpack(x0, x1, lrs.left().permutation(x));
+				ComplexOrRealType tmp = 0.0;
+				for (int kk = g.getRowPtr(x0); kk < g.getRowPtr(x0 + 1); ++kk) {
+					SizeType xprime = lrs.left().permutationInverse(g.getCol(kk) + x1*nprev);
+					tmp += g.getValue(kk)*v[lrs.super().permutationInverse(xprime + y*ns)];
+				}
+
+				sum += PsimagLite::conj(bra.fastAccess(i0, k))*tmp;
+			}
+		}
+
+		return sum;
+	}
+
+	// dest = (F x A) src, with A on the center site, and F the fermionic
+	// sign of the block before it if A is fermionic
+	static void applySiteOperator(VectorType& dest,
+	                              const VectorType& src,
+	                              const OperatorType& a,
+	                              const LeftRightSuperType& lrs,
+	                              const FermionSign& fs)
+	{
+		const SizeType ns = lrs.left().permutationVector().size();
+		const SizeType nprev = ns/a.data.rows();
+		const int fsign = (a.fermionOrBoson == ProgramGlobals::FermionOrBosonEnum::FERMION)
+		        ? -1 : 1;
+		PackIndicesType pack1(ns);
+		PackIndicesType pack2(nprev);
+		for (SizeType i = 0; i < dest.size(); ++i) {
+			SizeType x = 0;
+			SizeType y = 0;
+			pack1.unpack(x, y, lrs.super().permutation(i));
+			SizeType x0 = 0;
+			SizeType x1 = 0;
+			pack2.unpack(x0, x1, lrs.left().permutation(x));
+			ComplexOrRealType tmp = 0.0;
+			for (int k = a.data.getRowPtr(x1); k < a.data.getRowPtr(x1 + 1); ++k) {
+				SizeType xprime = lrs.left().permutationInverse(x0 + a.data.getCol(k)*nprev);
+				tmp += a.data.getValue(k)*src[lrs.super().permutationInverse(xprime + y*ns)];
+			}
+
+			dest[i] = tmp*static_cast<ComplexOrRealType>(fs(x0, fsign));
+		}
+	}
+
+	// result = G x 1 in the basis of lrs.left()
+	static void liftBlockOperator(SparseMatrixType& result,
+	                              const SparseMatrixType& g,
+	                              const LeftRightSuperType& lrs)
+	{
+		const SizeType ns = lrs.left().size();
+		const SizeType nprev = g.rows();
+		PackIndicesType pack(nprev);
+		result.resize(ns, ns);
+		SizeType counter = 0;
+		for (SizeType x = 0; x < ns; ++x) {
+			result.setRow(x, counter);
+			SizeType x0 = 0;
+			SizeType x1 = 0;
+			pack.unpack(x0, x1, lrs.left().permutation(x));
+			for (int k = g.getRowPtr(x0); k < g.getRowPtr(x0 + 1); ++k) {
+				result.pushCol(lrs.left().permutationInverse(g.getCol(k) + x1*nprev));
+				result.pushValue(g.getValue(k));
+				++counter;
+			}
+		}
+
+		result.setRow(ns, counter);
+		result.checkValidity();
+	}
+
+	// result = F x A in the basis of lrs.left(), as in applySiteOperator
+	static void liftSiteOperator(SparseMatrixType& result,
+	                             const OperatorType& a,
+	                             const LeftRightSuperType& lrs,
+	                             const FermionSign& fs)
+	{
+		const SizeType ns = lrs.left().size();
+		const SizeType nprev = ns/a.data.rows();
+		const int fsign = (a.fermionOrBoson == ProgramGlobals::FermionOrBosonEnum::FERMION)
+		        ? -1 : 1;
+		PackIndicesType pack(nprev);
+		result.resize(ns, ns);
+		SizeType counter = 0;
+		for (SizeType x = 0; x < ns; ++x) {
+			result.setRow(x, counter);
+			SizeType x0 = 0;
+			SizeType x1 = 0;
+			pack.unpack(x0, x1, lrs.left().permutation(x));
+			const int sign = fs(x0, fsign);
+			for (int k = a.data.getRowPtr(x1); k < a.data.getRowPtr(x1 + 1); ++k) {
+				result.pushCol(lrs.left().permutationInverse(x0 + a.data.getCol(k)*nprev));
+				result.pushValue(a.data.getValue(k)*static_cast<ComplexOrRealType>(sign));
+				++counter;
+			}
+		}
+
+		result.setRow(ns, counter);
+		result.checkValidity();
+	}
+
+	const ModelType& model_;
+	SizeType loop_;
+	VectorCorrelationType correlations_;
+};
+}
+#endif // INSITU_CORRELATIONS_H
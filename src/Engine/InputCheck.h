@@ -206,6 +206,11 @@ public:
 		knownLabels_.push_back("ThreadsStackSize");
 		knownLabels_.push_back("RecoverySave");
 		knownLabels_.push_back("Intent");
+		knownLabels_.push_back("DavidsonPreconditioner");
+		knownLabels_.push_back("DensityMatrixPerturbation");
+		knownLabels_.push_back("KrylovRecycleTolerance");
+		knownLabels_.push_back("MettsChains");
+		knownLabels_.push_back("InSituCorrelations");
 		for (SizeType i = 0; i < 10; ++i)
 			knownLabels_.push_back("Term" + ttos(i));
 	}
@@ -298,6 +303,9 @@ public:
 			 \item[useSu2Symmetry] Use the SU(2) symmetry for the model, and
 			interpret quantum
 				 numbers in the line ``QNS'' appropriately.
+				 The Hamiltonian times vector is done on the fly, by dense
+				 patches of equal j and electrons; see Su2ReducedKron.h
+				 and su2NoKron
 
 			 \item[nofiniteloops]  Don't do finite loops, even if provided under
 			``FiniteLoops'' below.
@@ -306,12 +314,20 @@ public:
 			superblock
 			\item[exactdiag] Do exact diagonalization with LAPACK instead of Lanczos
 			\item[nodmrgtransform] Do not DMRG transform bases
-			\item[useDavidson] Use Davidson instead of Lanczos
+			\item[useDavidson] Use Davidson instead of Lanczos. For the ground state
+			the correction uses the preconditioner given by
+			DavidsonPreconditioner=, which can be none, diagonal, or patch
+			(the default). Patch inverts exactly, in each diagonal Kronecker
+			patch, the part of H due to the left and right Hamiltonians
 			\item[verbose] Enable verbose output
 			\item[nowft] Disable the Wave Function Transformation (WFT)
 			\item[useComplex] TBW
 			\item[inflate] TBW
 			\item[twositedmrg] Use 2-site DMRG. Default is 1-site DMRG
+			With 1-site DMRG, DensityMatrixPerturbation=alpha1,alpha2,...
+			adds, in finite loop i, the perturbation of the density matrix
+			due to the operators of the most recently added site, with weight
+			alpha i; see DensityMatrixPerturbation.h
 			\item[noloadwft] TBW
 			\item[ChebyshevSolver] Use ChebyshevSolver instead of Lanczos
 			\item[MatrixVectorStored] Store superblock sector of Hamiltonian matrix
@@ -323,7 +339,13 @@ public:
 			\item[CorrectionVectorTargeting] TBW
 			\item[CorrectionTargeting] TBW
 			\item[TargetingAncilla] TBW
-			\item[MettsTargeting] TBW
+			\item[MettsTargeting] METTS. With MettsChains=n, n chains
+			continue from one infinite loop, concurrently with threadPool;
+			chain c uses seed TSPRngSeed + 1 + c, and its energies are
+			written to MettsChains/c/Energy of the output file.
+			In standard output, each line of chain c starts with MettsChain$c$:
+			and the lines of different chains are interleaved; the lines of the
+			infinite loop have no prefix
 			\item[TargetingInSitu] TBW
 			\item[geometryallinsystem] During infinite algorithm make environment
 			contain always exactly one site
@@ -339,14 +361,57 @@ public:
 			\item [extendedPrint] TBW
 			\item [truncationNoSvd] Do not use SVD for truncation;
 									   use density matrix instead
+			\item [truncationRandomizedSvd] With SVD truncation (the default),
+			use a randomized range finder with oversampling and power iterations
+			for symmetry groups much larger than the requested kept states,
+			computing only the left singular vectors that the group can
+			contribute. Falls back to the exact SVD for a group when the weight
+			missed by the sample exceeds $10^{-10}$ of the group's weight.
+			Not used with EnablePersistentSvd
+			\item [truncationRandomizedSvdCompare] Also run the exact SVD for
+			the randomized groups, and print timing and accuracy versus exact
+			\item [truncationPartialDiag] With truncationNoSvd, compute
+			first only the eigenvalues of the density matrix blocks, and
+			then eigenvectors only for the kept states, by subspace iteration
+			for blocks much larger than their number of kept states
 			\item [KronNoLoadBalance] Disable load balancing for MatrixVectorKron
-			\item [setAffinities] TBW
+			\item [setAffinities] Pin threads to cpus, among those that the
+			process may run on. With MatrixVectorKron, threadPool, and more
+			than one thread, also moves the pages of the Kronecker output
+			vector to the NUMA node of the thread that computes each patch,
+			keeps each patch on its thread, and prints how many of those
+			pages are on the node of their thread and how many are on
+			other nodes (page placement, not memory traffic); with verbose,
+			also for each thread
 			\item [wftNoAccel] Disable WFT acceleration (but not the WFT itself)
 			\item [wftAccelPatches] Force WFT acceleration with patches, even
 			in twositedmrg
 			\item [BatchedGemm] Only meaningful with MatrixVectorKron. Enables
 								batched gemm and might need plugin sc
+			\item [adaptiveSolverTolerance] Loosen the tolerance and the
+			number of steps of Lanczos or Davidson when the truncation error,
+			or the change in energy between the last two finite loops, is large.
+			The last two finite loops use the tolerance in the input.
+			Prints the matvecs done and an estimate of the matvecs saved
+			\item [KronMpi] Only meaningful with MatrixVectorKron. Each MPI
+			rank owns a contiguous range of out patches of about equal weight,
+			builds only the Kronecker blocks of those patches, and receives
+			from other ranks only the in patches that its blocks connect to.
+			With useDavidson, Excited=0 and DavidsonPreconditioner= other
+			than none, the Davidson vectors hold the patches of each rank only;
+			with other solvers the vectors are replicated, and the slices that
+			each rank computes are exchanged after each product. With
+			blockDavidson on more than one rank, DavidsonPreconditioner= is
+			ignored, because the preconditioner would hold the patches of
+			one rank only. Uses
+			useLowerPart=false. Ignored with BatchedGemm, or if MPI is
+			disabled for KronMatrix
 			\item [KrylovNoAbridge] TBW
+			\item [KrylovRecycle] Only meaningful with time evolution with
+			Krylov. Reuses the Ritz vectors of the previous time step,
+			transformed with the WFT, as the subspace for the next step, and
+			falls back to a fresh Lanczos decomposition if the error bound
+			exceeds KrylovRecycleTolerance= (default 1e-7)
 			\item [fixLegacyBugs] TBW
 			\item [saveDensityMatrixEigenvalues] Save DensityMatrixEigenvalues
 												 to the data file.
@@ -357,6 +422,32 @@ public:
 			them for all sites. This is will use more RAM, but might be needed
 			to target expressions.
 			\item [calcAndPrintEntropies] Calculate entropies and print to cout file
+			\item [threadPool] Use one persistent thread pool with work stealing
+			for all threaded loops of the engine, instead of creating threads
+			at each loop. Per-loop statistics are printed at the end of the run.
+			\item [asyncWrite] Write the wave function, transform, and TimeSerializer
+			data of each finite step in a background thread, during the
+			diagonalization of the next step; the bases are written at once.
+			Needs -DUSE_PTHREADS; otherwise all data is written at once
+			\item [blockDavidson] Compute levels 0 to Excited together with a block
+			Davidson solver, preconditioned as set by DavidsonPreconditioner=
+			(not preconditioned with KronMpi on more than one rank).
+			The energies of all levels are written to the data file under Levels,
+			one entry for each step solved by block Davidson, and the targeted
+			vector is still the one of level Excited. Levels not converged are
+			reported with a WARNING
+			\item [resourcePlanner] Run the infinite loop only, and print a forecast
+			of memory (vectors, operators, stacks, data written) and of time for each
+			finite loop, extrapolated from the last infinite step. Cannot be used
+			with restart
+			\item [mappedTransforms] For observe only. Write the transforms of the
+			data file once to a flat file, named as the data file without its
+			extension but ending in Transforms.bin, and map it read-only instead of
+			reading the transforms into memory, so that observe processes on the
+			same data file share them. The flat file is written again when the
+			data file is modified or replaced
+			\item [su2NoKron] With useSu2Symmetry, do the Hamiltonian times vector
+			element by element, instead of by dense patches and GEMMs
 		\end{itemize}
 		*/
 	void check(const PsimagLite::String& label,
@@ -411,6 +502,9 @@ public:
 		registerOpts.push_back("doNotCheckTwoSiteDmrg");
 		registerOpts.push_back("extendedPrint");
 		registerOpts.push_back("truncationNoSvd");
+		registerOpts.push_back("truncationPartialDiag");
+		registerOpts.push_back("truncationRandomizedSvd");
+		registerOpts.push_back("truncationRandomizedSvdCompare");
 		registerOpts.push_back("KronNoLoadBalance");
 		registerOpts.push_back("setAffinities");
 		registerOpts.push_back("wftNoAccel");
@@ -423,6 +517,15 @@ public:
 		registerOpts.push_back("shrinkStacksOnDisk");
 		registerOpts.push_back("OperatorsChangeAll");
 		registerOpts.push_back("calcAndPrintEntropies");
+		registerOpts.push_back("threadPool");
+		registerOpts.push_back("KronMpi");
+		registerOpts.push_back("adaptiveSolverTolerance");
+		registerOpts.push_back("KrylovRecycle");
+		registerOpts.push_back("asyncWrite");
+		registerOpts.push_back("resourcePlanner");
+		registerOpts.push_back("blockDavidson");
+		registerOpts.push_back("mappedTransforms");
+		registerOpts.push_back("su2NoKron");
 
 		PsimagLite::Options::Writeable optWriteable(registerOpts,
 		                                            PsimagLite::Options::Writeable::PERMISSIVE);
@@ -438,6 +541,14 @@ public:
 			err("BatchedGemm needs -DPLUGIN_SC in Config.make\n");
 #endif
 		}
+
+		if (val.find("KronMpi") != PsimagLite::String::npos && notMvk)
+			err("FATAL: KronMpi only with MatrixVectorKron\n");
+
+		// the forecast is extrapolated from the infinite loop
+		if (val.find("resourcePlanner") != PsimagLite::String::npos &&
+		        val.find("restart") != PsimagLite::String::npos)
+			err("FATAL: resourcePlanner cannot be used with restart\n");
 	}
 
 	bool isSet(const PsimagLite::String& thisOption) const
@@ -171,6 +171,16 @@ public:
 		super_ = rls.super_;
 	}
 
+	// deep copy of the three bases of rls, for a LeftRightSuper that owns its bases
+	void copyFrom(const ThisType& rls)
+	{
+		left(rls.left());
+		right(rls.right());
+		assert(super_);
+		assert(rls.super_);
+		*super_ = *rls.super_;
+	}
+
 	void dontCopyOperators(const ThisType& rls)
 	{
 		assert(left_);
@@ -0,0 +1,106 @@
+#ifndef LINK_TABLE_CACHE_H
+#define LINK_TABLE_CACHE_H
+#include "Vector.h"
+#include <map>
+#include <memory>
+#include <mutex>
+
+// Process-wide cache of the links that HamiltonianConnection computes
+// for a system-environment boundary
+// The links depend on smax, emin, the sites of the superblock, the time
+// (through the geometry's vModifier), and the geometry and model links,
+// which are fixed for a process, until ModelBase::postCtor calls clear()
+// The cache is emptied when it reaches MAX_ENTRIES, so that runs with many
+// time values do not grow it without bound
+namespace Dmrg {
+
+template<typename LinkType, typename RealType>
+class LinkTableCache {
+
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+
+public:
+
+	typedef typename PsimagLite::Vector<LinkType>::Type VectorLinkType;
+
+	enum {MAX_ENTRIES = 1024};
+
+	struct LinkTable {
+		VectorLinkType links;
+		// number of links of each item of HamiltonianAbstract
+		VectorSizeType totalOnes;
+	};
+
+	typedef std::shared_ptr<const LinkTable> LinkTablePtrType;
+
+	struct Key {
+
+		Key(const void* geometry_,
+		    SizeType smax_,
+		    SizeType emin_,
+		    const VectorSizeType& superBlock_,
+		    RealType time_)
+		    : geometry(geometry_),
+		      smax(smax_),
+		      emin(emin_),
+		      superBlock(superBlock_),
+		      time(time_)
+		{}
+
+		bool operator<(const Key& other) const
+		{
+			if (geometry != other.geometry) return (geometry < other.geometry);
+			if (smax != other.smax) return (smax < other.smax);
+			if (emin != other.emin) return (emin < other.emin);
+			if (time != other.time) return (time < other.time);
+			return (superBlock < other.superBlock);
+		}
+
+		const void* geometry;
+		SizeType smax;
+		SizeType emin;
+		VectorSizeType superBlock;
+		RealType time;
+	};
+
+	// returns a null pointer if key is not cached
+	static LinkTablePtrType find(const Key& key)
+	{
+		Storage& s = storage();
+		std::unique_lock<std::mutex> lock(s.mutex);
+		typename MapType::const_iterator it = s.map.find(key);
+		return (it == s.map.end()) ? LinkTablePtrType() : it->second;
+	}
+
+	static void insert(const Key& key, const LinkTablePtrType& table)
+	{
+		Storage& s = storage();
+		std::unique_lock<std::mutex> lock(s.mutex);
+		if (s.map.size() >= MAX_ENTRIES) s.map.clear();
+		s.map[key] = table;
+	}
+
+	static void clear()
+	{
+		Storage& s = storage();
+		std::unique_lock<std::mutex> lock(s.mutex);
+		s.map.clear();
+	}
+
+private:
+
+	typedef std::map<Key, LinkTablePtrType> MapType;
+
+	struct Storage {
+		MapType map;
+		std::mutex mutex;
+	};
+
+	static Storage& storage()
+	{
+		static Storage s;
+		return s;
+	}
+};
+}
+#endif // LINK_TABLE_CACHE_H
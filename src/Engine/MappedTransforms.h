@@ -0,0 +1,330 @@
+#ifndef MAPPED_TRANSFORMS_H
+#define MAPPED_TRANSFORMS_H
+#include "Vector.h"
+#include "PsimagLite.h"
+#include "ProgressIndicator.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Read-only views of the transforms of all DmrgSerializers of a data file,
+// used by observe with SolverOptions=mappedTransforms
+// The blocks are stored column-major and aligned to ALIGNMENT bytes in a flat
+// file named as the data file, without its extension, but ending in
+// Transforms.bin, which is mapped read-only, so that observe processes reading
+// the same data file share the blocks through the page cache instead of each
+// holding a copy
+// The flat file is written by the first observe that does not find it, or
+// finds it stale; it is written to a temporary file and then renamed, so
+// that concurrent observe processes never map a partial file
+// The layout is that of the machine that writes it
+namespace Dmrg {
+
+template<typename BlockDiagonalMatrixType>
+class MappedTransforms {
+
+	typedef typename BlockDiagonalMatrixType::ComplexOrRealType ComplexOrRealType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+
+	enum {ALIGNMENT = 64};
+
+	struct Header {
+		char magic[8];
+		SizeType valueSize;
+		SizeType transforms;
+		SizeType indexOffset;
+		SizeType dataSize;
+		SizeType dataSeconds;
+		SizeType dataNanoseconds;
+		SizeType dataDevice;
+		SizeType dataInode;
+	};
+
+public:
+
+	// a dense column-major block of the mapped file
+	class MatrixView {
+
+	public:
+
+		typedef ComplexOrRealType value_type;
+
+		MatrixView(const ComplexOrRealType* data, SizeType rows, SizeType cols)
+		    : data_(data), rows_(rows), cols_(cols)
+		{}
+
+		SizeType rows() const { return rows_; }
+
+		SizeType cols() const { return cols_; }
+
+		const ComplexOrRealType& operator()(SizeType i, SizeType j) const
+		{
+			assert(i < rows_ && j < cols_);
+			return data_[i + j*rows_];
+		}
+
+	private:
+
+		const ComplexOrRealType* data_;
+		SizeType rows_;
+		SizeType cols_;
+	};
+
+	// what BlockOffDiagMatrix::transform needs of a BlockDiagonalMatrix
+	class BlockDiagonalView {
+
+	public:
+
+		typedef MatrixView BuildingBlockType;
+
+		SizeType rows() const
+		{
+			SizeType n = offsetsRows_.size();
+			return (n == 0) ? 0 : offsetsRows_[n - 1];
+		}
+
+		SizeType cols() const
+		{
+			SizeType n = offsetsCols_.size();
+			return (n == 0) ? 0 : offsetsCols_[n - 1];
+		}
+
+		const VectorSizeType& offsetsRows() const { return offsetsRows_; }
+
+		const VectorSizeType& offsetsCols() const { return offsetsCols_; }
+
+		SizeType blocks() const { return data_.size(); }
+
+		MatrixView operator()(SizeType i) const
+		{
+			assert(i < data_.size());
+			return MatrixView(data_[i], blockRows_[i], blockCols_[i]);
+		}
+
+	private:
+
+		friend class MappedTransforms;
+
+		VectorSizeType offsetsRows_;
+		VectorSizeType offsetsCols_;
+		VectorSizeType blockRows_;
+		VectorSizeType blockCols_;
+		typename PsimagLite::Vector<const ComplexOrRealType*>::Type data_;
+	};
+
+	template<typename IoInputType>
+	MappedTransforms(PsimagLite::String datafile, IoInputType& io)
+	    : filename_(flatFilename(datafile)),
+	      progress_("MappedTransforms"),
+	      base_(0),
+	      bytes_(0)
+	{
+		struct stat st;
+		if (stat(datafile.c_str(), &st) != 0)
+			err("MappedTransforms: cannot stat " + datafile + "\n");
+
+		Header header;
+		fillHeader(header, 0, st);
+		if (!isCurrent(header)) writeFlat(io, header);
+
+		mapFlat();
+	}
+
+	~MappedTransforms()
+	{
+		if (base_) munmap(const_cast<char*>(base_), bytes_);
+		base_ = 0;
+	}
+
+	SizeType size() const { return views_.size(); }
+
+	// transform of DmrgSerializer number ind of the data file
+	const BlockDiagonalView& operator()(SizeType ind) const
+	{
+		if (ind >= views_.size())
+			err("MappedTransforms: no transform " + ttos(ind) + " in " + filename_ + "\n");
+		return views_[ind];
+	}
+
+private:
+
+	MappedTransforms(const MappedTransforms&);
+
+	MappedTransforms& operator=(const MappedTransforms&);
+
+	// datafile without the extension of its basename, if any,
+	// followed by Transforms.bin
+	static PsimagLite::String flatFilename(PsimagLite::String datafile)
+	{
+		size_t slash = datafile.find_last_of("/");
+		size_t dot = datafile.find_last_of(".");
+		if (dot == PsimagLite::String::npos || (slash != PsimagLite::String::npos && dot < slash))
+			dot = datafile.length();
+
+		return datafile.substr(0, dot) + "Transforms.bin";
+	}
+
+	// the data file is identified by its device, inode, size, and modification
+	// time to the nanosecond, so that a data file rewritten within the same
+	// second, or replaced by another file, is not taken as current
+	static void fillHeader(Header& header, SizeType transforms, const struct stat& st)
+	{
+		memset(&header, 0, sizeof(Header));
+		memcpy(header.magic, "DMRGTRF2", 8);
+		header.valueSize = sizeof(ComplexOrRealType);
+		header.transforms = transforms;
+		header.dataSize = st.st_size;
+#ifdef __APPLE__
+		header.dataSeconds = st.st_mtimespec.tv_sec;
+		header.dataNanoseconds = st.st_mtimespec.tv_nsec;
+#else
+		header.dataSeconds = st.st_mtim.tv_sec;
+		header.dataNanoseconds = st.st_mtim.tv_nsec;
+#endif
+		header.dataDevice = st.st_dev;
+		header.dataInode = st.st_ino;
+	}
+
+	bool isCurrent(const Header& expected) const
+	{
+		std::ifstream fin(filename_.c_str(), std::ios::binary);
+		if (!fin) return false;
+
+		Header header;
+		fin.read(reinterpret_cast<char*>(&header), sizeof(Header));
+		if (!fin) return false;
+
+		return (memcmp(header.magic, expected.magic, 8) == 0 &&
+		        header.valueSize == expected.valueSize &&
+		        header.dataSize == expected.dataSize &&
+		        header.dataSeconds == expected.dataSeconds &&
+		        header.dataNanoseconds == expected.dataNanoseconds &&
+		        header.dataDevice == expected.dataDevice &&
+		        header.dataInode == expected.dataInode);
+	}
+
+	template<typename IoInputType>
+	void writeFlat(IoInputType& io, Header& header) const
+	{
+		SizeType total = 0;
+		io.read(total, "Serializer/Size");
+
+		PsimagLite::String tmp = filename_ + "." + ttos(getpid());
+		std::ofstream fout(tmp.c_str(), std::ios::binary);
+		if (!fout)
+			err("MappedTransforms: cannot write " + tmp + "\n");
+
+		fout.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+		// one transform in memory at a time
+		VectorSizeType index;
+		for (SizeType i = 0; i < total; ++i) {
+			BlockDiagonalMatrixType t(io, "Serializer/" + ttos(i) + "/transform");
+			appendVector(index, t.offsetsRows());
+			appendVector(index, t.offsetsCols());
+			index.push_back(t.blocks());
+			for (SizeType k = 0; k < t.blocks(); ++k) {
+				const typename BlockDiagonalMatrixType::BuildingBlockType& m = t(k);
+				pad(fout);
+				index.push_back(m.rows());
+				index.push_back(m.cols());
+				index.push_back(fout.tellp());
+				if (m.rows() == 0 || m.cols() == 0) continue;
+				fout.write(reinterpret_cast<const char*>(&(m(0, 0))),
+				           m.rows()*m.cols()*sizeof(ComplexOrRealType));
+			}
+		}
+
+		pad(fout);
+		header.transforms = total;
+		header.indexOffset = fout.tellp();
+		if (index.size() > 0)
+			fout.write(reinterpret_cast<const char*>(&(index[0])),
+			           index.size()*sizeof(SizeType));
+		fout.seekp(0);
+		fout.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		fout.close();
+		if (!fout)
+			err("MappedTransforms: error writing " + tmp + "\n");
+
+		if (rename(tmp.c_str(), filename_.c_str()) != 0)
+			err("MappedTransforms: cannot rename " + tmp + " to " + filename_ + "\n");
+
+		PsimagLite::OstringStream msg;
+		msg<<"Wrote "<<total<<" transforms to "<<filename_;
+		progress_.printline(msg, std::cout);
+	}
+
+	void mapFlat()
+	{
+		int fd = open(filename_.c_str(), O_RDONLY);
+		if (fd < 0)
+			err("MappedTransforms: cannot open " + filename_ + "\n");
+
+		struct stat st;
+		if (fstat(fd, &st) != 0 || SizeType(st.st_size) < sizeof(Header)) {
+			close(fd);
+			err("MappedTransforms: " + filename_ + " is too short\n");
+		}
+
+		bytes_ = st.st_size;
+		void* p = mmap(0, bytes_, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (p == MAP_FAILED)
+			err("MappedTransforms: cannot map " + filename_ + "\n");
+
+		base_ = static_cast<const char*>(p);
+
+		const Header& header = *reinterpret_cast<const Header*>(base_);
+		const SizeType* index = reinterpret_cast<const SizeType*>(base_ + header.indexOffset);
+		views_.resize(header.transforms);
+		for (SizeType i = 0; i < header.transforms; ++i) {
+			BlockDiagonalView& view = views_[i];
+			readVector(view.offsetsRows_, index);
+			readVector(view.offsetsCols_, index);
+			const SizeType blocks = *index++;
+			view.blockRows_.resize(blocks);
+			view.blockCols_.resize(blocks);
+			view.data_.resize(blocks);
+			for (SizeType k = 0; k < blocks; ++k) {
+				view.blockRows_[k] = *index++;
+				view.blockCols_[k] = *index++;
+				view.data_[k] = reinterpret_cast<const ComplexOrRealType*>(base_ + *index++);
+			}
+		}
+	}
+
+	static void pad(std::ofstream& fout)
+	{
+		SizeType rem = SizeType(fout.tellp()) % ALIGNMENT;
+		if (rem == 0) return;
+
+		const char zeros[ALIGNMENT] = {0};
+		fout.write(zeros, ALIGNMENT - rem);
+	}
+
+	static void appendVector(VectorSizeType& index, const VectorSizeType& v)
+	{
+		index.push_back(v.size());
+		index.insert(index.end(), v.begin(), v.end());
+	}
+
+	static void readVector(VectorSizeType& v, const SizeType*& index)
+	{
+		const SizeType n = *index++;
+		v.assign(index, index + n);
+		index += n;
+	}
+
+	PsimagLite::String filename_;
+	PsimagLite::ProgressIndicator progress_;
+	const char* base_;
+	SizeType bytes_;
+	typename PsimagLite::Vector<BlockDiagonalView>::Type views_;
+};
+}
+#endif // MAPPED_TRANSFORMS_H
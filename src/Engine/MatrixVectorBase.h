@@ -97,12 +97,40 @@ public:
 	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
 	typedef PsimagLite::Matrix<ComplexOrRealType> FullMatrixType;
 
+	MatrixVectorBase() : matvecs_(0) {}
+
+	// number of products done so far
+	SizeType matvecs() const { return matvecs_; }
+
 	SizeType reflectionSector() const { return 0; }
 
 	void reflectionSector(SizeType) {  }
 
 	void fullDiag(VectorRealType& eigs,FullMatrixType& fm) const;
 
+	// Vectors distributed over MPI ranks, see MatrixVectorKron and
+	// SolverOptions=KronMpi; not supported by default
+	bool distributed() const { return false; }
+
+	SizeType localRows() const { return 0; }
+
+	void toLocal(VectorType&, const VectorType&) const
+	{
+		err("MatrixVectorBase: distributed vectors not supported\n");
+	}
+
+	void fromLocal(VectorType&, const VectorType&) const
+	{
+		err("MatrixVectorBase: distributed vectors not supported\n");
+	}
+
+	void matrixVectorProductLocal(VectorType&, const VectorType&) const
+	{
+		err("MatrixVectorBase: distributed vectors not supported\n");
+	}
+
+	void sumOverRanks(ComplexOrRealType&) const {}
+
 	static void fullDiag(VectorRealType& eigs,
 	                     FullMatrixType& fm,
 	                     const SparseMatrixType& matrixStored,
@@ -133,6 +161,36 @@ public:
 		fm = matrixStored.toDense();
 		diag(fm,eigs,'V');
 	}
+	// Leaves the preconditioner disabled unless a stored matrix is available
+	template<typename PreconditionerType>
+	void fillPreconditioner(PreconditionerType&) const {}
+
+	// Diagonal of the stored matrix, if any
+	template<typename PreconditionerType>
+	static void fillPreconditioner(PreconditionerType& prec,
+	                               const SparseMatrixType& matrixStored)
+	{
+		SizeType n = matrixStored.rows();
+		if (n == 0) return;
+
+		VectorRealType d(n, 0.0);
+		for (SizeType i = 0; i < n; ++i) {
+			for (int k = matrixStored.getRowPtr(i); k < matrixStored.getRowPtr(i + 1); ++k) {
+				if (static_cast<SizeType>(matrixStored.getCol(k)) != i) continue;
+				d[i] += PsimagLite::real(matrixStored.getValue(k));
+			}
+		}
+
+		prec.setDiagonal(d);
+	}
+
+protected:
+
+	void countMatvec() const { ++matvecs_; }
+
+private:
+
+	mutable SizeType matvecs_;
 }; // class MatrixVectorBase
 } // namespace Dmrg
 
@@ -100,13 +100,17 @@ public:
 	typedef typename GenIjPatchType::BasisType BasisType;
 	typedef typename MatrixDenseOrSparseType::value_type ComplexOrRealType;
 	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+	typedef std::pair<SizeType, SizeType> PairSizeType;
 
+	// Only the rows ipatch in [rowPatches.first, rowPatches.second) are built;
+	// the others are left empty, see InitKronHamiltonian and KronMpi
 	ArrayOfMatStruct(const SparseMatrixType& sparse,
 	                 const GenIjPatchType& patchOld,
 	                 const GenIjPatchType& patchNew,
 	                 typename GenIjPatchType::LeftOrRightEnumType leftOrRight,
 	                 RealType threshold,
-	                 bool useLowerPart)
+	                 bool useLowerPart,
+	                 const PairSizeType& rowPatches)
 	    : data_(patchNew(leftOrRight).size(), patchOld(leftOrRight).size())
 	{
 		const BasisType& basisOld = (leftOrRight == GenIjPatchType::LEFT) ?
@@ -238,6 +242,12 @@ public:
 
             for(SizeType ipatch=0; ipatch < ipatchSize; ipatch++) {
 
+		if (ipatch < rowPatches.first || ipatch >= rowPatches.second) {
+			for(SizeType jpatch=0; jpatch < jpatchSize; ++jpatch)
+				data_(ipatch,jpatch) = 0;
+			continue;
+		}
+
 		// ------------------------------------------------------
 		// initialize  data structure to count number of nonzeros
 		// per row in sparse matrix of  data_(ipatch,jpatch)
@@ -104,6 +104,7 @@ public:
 	typedef typename PsimagLite::Vector<ArrayOfMatStructType*>::Type VectorArrayOfMatStructType;
 	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
 	typedef typename ArrayOfMatStructType::VectorSizeType VectorSizeType;
+	typedef typename ArrayOfMatStructType::PairSizeType PairSizeType;
 
 	enum WhatBasisEnum {OLD,  NEW};
 
@@ -128,6 +129,7 @@ public:
 		progress_.printline(msg, std::cout);
 
 		signsNew_ = lrs.left().signs();
+		rowPatches_ = PairSizeType(0, numberOfPatches(NEW));
 	}
 
 	~InitKronBase()
@@ -247,6 +249,13 @@ public:
 
 protected:
 
+	// out patches whose blocks are built by addOneConnection
+	void setRowPatches(const PairSizeType& rowPatches)
+	{
+		assert(xc_.size() == 0);
+		rowPatches_ = rowPatches;
+	}
+
 	void addOneConnection(const SparseMatrixType& A,
 	                      const SparseMatrixType& B,
 	                      const LinkType& link2)
@@ -311,19 +320,22 @@ protected:
 
 	// -------------------
 	// copy xout(:) to vout(:)
+	// xout holds the patches in [firstPatch, lastPatch) only
 	// -------------------
 	void copyOut(VectorType& vout,
 	             const VectorType& xout,
-	             const VectorSizeType& vstart) const
+	             const VectorSizeType& vstart,
+	             SizeType firstPatch,
+	             SizeType lastPatch) const
 	{
 		const VectorSizeType& permInverse = lrs(NEW).super().permutationInverse();
 		SizeType offset1 = offset(NEW);
 		SizeType nl = lrs(NEW).left().hamiltonian().rows();
-		SizeType npatches = patch(NEW, GenIjPatchType::LEFT).size();
 		const BasisType& left = lrs(NEW).left();
 		const BasisType& right = lrs(NEW).right();
+		assert(lastPatch <= patch(NEW, GenIjPatchType::LEFT).size());
 
-		for( SizeType ipatch=0; ipatch < npatches; ++ipatch) {
+		for( SizeType ipatch=firstPatch; ipatch < lastPatch; ++ipatch) {
 
 			SizeType igroup = patch(NEW, GenIjPatchType::LEFT)[ipatch];
 			SizeType jgroup = patch(NEW, GenIjPatchType::RIGHT)[ipatch];
@@ -351,7 +363,8 @@ protected:
 					SizeType r = permInverse[i + j*nl];
 					assert( !(  (r < offset1) || (r >= (offset1 + size(NEW))) ) );
 
-					SizeType ip = vstart[ipatch] + (iright + ileft * sizeRight);
+					SizeType ip = vstart[ipatch] - vstart[firstPatch] +
+					        (iright + ileft * sizeRight);
 					assert(ip < xout.size());
 
 					assert(r >= offset1 && ((r - offset1) < vout.size()) );
@@ -440,6 +453,7 @@ private:
 	GenIjPatchType ijpatchesOld_;
 	GenIjPatchType* ijpatchesNew_;
 	VectorSizeType weightsOfPatches_;
+	PairSizeType rowPatches_;
 	VectorArrayOfMatStructType xc_;
 	VectorArrayOfMatStructType yc_;
 	VectorBoolType signsNew_;
@@ -81,6 +81,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "InitKronBase.h"
 #include "Vector.h"
 #include "Profiling.h"
+#include "Concurrency.h"
+#include "MPI.h"
 
 namespace Dmrg {
 
@@ -106,6 +108,10 @@ public:
 	typedef typename PsimagLite::Vector<ArrayOfMatStructType*>::Type VectorArrayOfMatStructType;
 	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
 	typedef typename ArrayOfMatStructType::VectorSizeType VectorSizeType;
+	typedef typename BaseType::MatrixDenseOrSparseType MatrixDenseOrSparseType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+	typedef typename BaseType::PairSizeType PairSizeType;
 
 	InitKronHamiltonian(const ModelType& model,
 	                    const HamiltonianConnectionType& hc)
@@ -114,12 +120,23 @@ public:
 	               hc.modelHelper().quantumNumber(),
 	               model.params().denseSparseThreshold,
 	               model.params().options.find("KronNoUseLowerPart") == PsimagLite::String::npos
-	               && model.params().options.find("BatchedGemm") == PsimagLite::String::npos),
+	               && model.params().options.find("BatchedGemm") == PsimagLite::String::npos
+	               && !isDistributed(model)),
 	      model_(model),
 	      hc_(hc),
+	      distributed_(isDistributed(model)),
+	      mpiRange_(0, BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT).size()),
 	      vstart_(BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT).size() + 1),
 	      offsetForPatches_(BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT).size() + 1)
 	{
+		BaseType::setUpVstart(vstart_, BaseType::NEW);
+		assert(vstart_.size() > 0);
+
+		if (distributed_) {
+			mpiRange_ = mpiRangeOf(PsimagLite::MPI::commRank(PsimagLite::MPI::COMM_WORLD));
+			BaseType::setRowPatches(mpiRange_);
+		}
+
 		addHlAndHr();
 
 		{
@@ -128,13 +145,8 @@ public:
 			convertXcYcArrays();
 		}
 
-		BaseType::setUpVstart(vstart_, BaseType::NEW);
-		assert(vstart_.size() > 0);
-		SizeType nsize = vstart_[vstart_.size() - 1];
-		assert(nsize > 0);
-		yin_.resize(nsize, 0.0);
-		xout_.resize(nsize, 0.0);
 		BaseType::computeOffsets(offsetForPatches_, BaseType::NEW);
+		setInPatches();
 	}
 
 	bool isWft() const {return false; }
@@ -146,6 +158,7 @@ public:
 
 	// -------------------
 	// copy vin(:) to yin(:)
+	// and vout(:) to xout(:) for the out patches of this rank
 	// -------------------
 	void copyIn(const VectorType& vout,
 	            const VectorType& vin)
@@ -158,12 +171,13 @@ public:
 		SizeType nl = leftH.rows();
 
 		SizeType offset = BaseType::offset(BaseType::NEW);
-		SizeType npatches = BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT).size();
+		SizeType npatches = inPatches_.size();
 		const BasisType& left = BaseType::lrs(BaseType::NEW).left();
 		const BasisType& right = BaseType::lrs(BaseType::NEW).right();
 
-		for (SizeType ipatch=0; ipatch < npatches; ++ipatch) {
+		for (SizeType i=0; i < npatches; ++i) {
 
+			SizeType ipatch = inPatches_[i];
 			SizeType igroup = BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT)[ipatch];
 			SizeType jgroup = BaseType::patch(BaseType::NEW, GenIjPatchType::RIGHT)[ipatch];
 
@@ -176,6 +190,8 @@ public:
 			SizeType left_offset = left.partition(igroup);
 			SizeType right_offset = right.partition(jgroup);
 
+			const bool isOut = isOutPatch(ipatch);
+
 			for (SizeType ileft=0; ileft < sizeLeft; ++ileft) {
 				for (SizeType iright=0; iright < sizeRight; ++iright) {
 
@@ -192,34 +208,143 @@ public:
 					SizeType r = permInverse[ ij ];
 					assert(!((r < offset) || (r >= (offset + BaseType::size(BaseType::NEW)))));
 
-					SizeType ip = vstart_[ipatch] + (iright + ileft * sizeRight);
-					assert(ip < yin.size());
+					SizeType ip = iright + ileft * sizeRight;
+					assert(offsetsOld_[ipatch] + ip < yin.size());
 
 					assert( (r >= offset) && ((r-offset) < vin.size()) );
-					yin[ip] = vin[r-offset];
-					xout[ip] = vout[r-offset];
+					yin[offsetsOld_[ipatch] + ip] = vin[r-offset];
+					if (isOut)
+						xout[offsetsNew_[ipatch] + ip] = vout[r-offset];
 				}
 			}
 		}
 	}
 
 	// -------------------
-	// copy xout(:) to vout(:)
+	// copy xout(:) to vout(:) for the out patches of this rank
 	// -------------------
 	void copyOut(VectorType& vout) const
 	{
-		BaseType::copyOut(vout, xout_, vstart_);
+		BaseType::copyOut(vout, xout_, vstart_, mpiRange_.first, mpiRange_.second);
+	}
+
+	// vout(:) of the out patches [firstPatch, lastPatch), held in x in patch order
+	void copyOut(VectorType& vout,
+	             const VectorType& x,
+	             SizeType firstPatch,
+	             SizeType lastPatch) const
+	{
+		BaseType::copyOut(vout, x, vstart_, firstPatch, lastPatch);
+	}
+
+	// -------------------
+	// copy the elements of the out patches of this rank from full(:),
+	// in the order of the sector, to local(:), in patch order
+	// -------------------
+	void toLocal(VectorType& local, const VectorType& full) const
+	{
+		const VectorSizeType& permInverse = BaseType::lrs(BaseType::NEW).super().permutationInverse();
+		SizeType nl = BaseType::lrs(BaseType::NEW).left().hamiltonian().rows();
+		SizeType offset = BaseType::offset(BaseType::NEW);
+		const BasisType& left = BaseType::lrs(BaseType::NEW).left();
+		const BasisType& right = BaseType::lrs(BaseType::NEW).right();
+
+		local.resize(xout_.size());
+		for (SizeType ipatch = mpiRange_.first; ipatch < mpiRange_.second; ++ipatch) {
+			SizeType igroup = BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT)[ipatch];
+			SizeType jgroup = BaseType::patch(BaseType::NEW, GenIjPatchType::RIGHT)[ipatch];
+			SizeType sizeLeft =  left.partition(igroup+1) - left.partition(igroup);
+			SizeType sizeRight = right.partition(jgroup+1) - right.partition(jgroup);
+			SizeType leftOffset = left.partition(igroup);
+			SizeType rightOffset = right.partition(jgroup);
+
+			for (SizeType ileft = 0; ileft < sizeLeft; ++ileft) {
+				for (SizeType iright = 0; iright < sizeRight; ++iright) {
+					SizeType ij = ileft + leftOffset + (iright + rightOffset)*nl;
+					assert(ij < permInverse.size());
+					SizeType r = permInverse[ij];
+					assert(r >= offset && r - offset < full.size());
+					SizeType ip = offsetsNew_[ipatch] + iright + ileft*sizeRight;
+					assert(ip < local.size());
+					local[ip] = full[r - offset];
+				}
+			}
+		}
+	}
+
+	// x and y hold the out patches of this rank, in patch order;
+	// the in patches of other ranks are filled by KronMatrix
+	void copyInLocal(const VectorType& x, const VectorType& y)
+	{
+		assert(x.size() == xout_.size());
+		assert(y.size() == xout_.size());
+		xout_ = x;
+		std::copy(y.begin(), y.end(), yin_.begin());
 	}
 
 	const VectorType& yin() const { return yin_; }
 
+	VectorType& yin() { return yin_; }
+
+	const VectorType& xout() const { return xout_; }
+
 	VectorType& xout() { return xout_; }
 
-	const SizeType& offsetForPatches(typename BaseType::WhatBasisEnum,
+	// offset into xout (NEW) or yin (OLD) of a patch that this rank holds
+	const SizeType& offsetForPatches(typename BaseType::WhatBasisEnum what,
 	                                 SizeType ind) const
 	{
-		assert(ind < offsetForPatches_.size());
-		return  offsetForPatches_[ind];
+		const VectorSizeType& offsets = (what == BaseType::NEW) ? offsetsNew_
+		                                                        : offsetsOld_;
+		assert(ind < offsets.size());
+		assert(offsets[ind] <= ((what == BaseType::NEW) ? xout_.size() : yin_.size()));
+		return offsets[ind];
+	}
+
+	// in patches held in yin, those of this rank first
+	const VectorSizeType& inPatches() const { return inPatches_; }
+
+	// out patches of this rank, [first, second)
+	const PairSizeType& mpiRange() const { return mpiRange_; }
+
+	bool distributed() const { return distributed_; }
+
+	// Each rank gets a contiguous range of out patches of about equal weight;
+	// out patches are contiguous in xout, so each rank owns one slice of it
+	PairSizeType mpiRangeOf(SizeType rank) const
+	{
+		const SizeType mpiSize = PsimagLite::MPI::commSize(PsimagLite::MPI::COMM_WORLD);
+		const VectorSizeType& weights = BaseType::weightsOfPatchesNew();
+		const SizeType npatches = BaseType::numberOfPatches(BaseType::NEW);
+		assert(weights.size() == npatches);
+
+		long unsigned int total = 0;
+		for (SizeType i = 0; i < npatches; ++i)
+			total += weights[i] + 1;
+
+		// rank r owns the patches whose cumulative weight falls in
+		// [r*total/size, (r+1)*total/size)
+		long unsigned int sum = 0;
+		PairSizeType range(npatches, npatches);
+		for (SizeType i = 0; i < npatches; ++i) {
+			SizeType owner = (sum*mpiSize)/total;
+			sum += weights[i] + 1;
+			if (owner == rank && range.first == npatches) range.first = i;
+			if (owner > rank) {
+				range.second = i;
+				break;
+			}
+		}
+
+		if (range.first == npatches) range.second = npatches;
+		return range;
+	}
+
+	// size of the patches [firstPatch, lastPatch) in patch order
+	SizeType sizeOfPatches(SizeType firstPatch, SizeType lastPatch) const
+	{
+		assert(firstPatch <= lastPatch && lastPatch < offsetForPatches_.size());
+		return offsetForPatches_[lastPatch] - offsetForPatches_[firstPatch];
 	}
 
 	bool batchedGemm() const
@@ -227,8 +352,173 @@ public:
 		return (model_.params().options.find("BatchedGemm") != PsimagLite::String::npos);
 	}
 
+	bool setAffinities() const
+	{
+		return (model_.params().options.find("setAffinities") != PsimagLite::String::npos);
+	}
+
+	bool verbose() const
+	{
+		return (model_.params().options.find("verbose") != PsimagLite::String::npos);
+	}
+
+	// Diagonal of H in the sector: sum over connections of diag(A) x diag(B)
+	// restricted to the diagonal patches
+	// In patch mode also HL_p = xc(0)(p, p) and HR_p = yc(1)(p, p) are
+	// diagonalized, see addHlAndHr, and the other connections enter through
+	// their mean diagonal in the patch
+	// If distributed, only the out patches of this rank are filled, and
+	// indices refer to the local vectors, see toLocal
+	template<typename PreconditionerType>
+	void fillPreconditioner(PreconditionerType& prec) const
+	{
+		typedef typename PreconditionerType::Patch PatchType;
+
+		const VectorSizeType& permInverse = BaseType::lrs(BaseType::NEW).super().permutationInverse();
+		SizeType nl = BaseType::lrs(BaseType::NEW).left().hamiltonian().rows();
+		SizeType offset = BaseType::offset(BaseType::NEW);
+		const BasisType& left = BaseType::lrs(BaseType::NEW).left();
+		const BasisType& right = BaseType::lrs(BaseType::NEW).right();
+		SizeType nC = BaseType::connections();
+		assert(nC >= 2);
+
+		VectorRealType diagonal((distributed_) ? xout_.size() : BaseType::size(BaseType::NEW),
+		                        0.0);
+
+		for (SizeType ipatch = mpiRange_.first; ipatch < mpiRange_.second; ++ipatch) {
+			SizeType igroup = BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT)[ipatch];
+			SizeType jgroup = BaseType::patch(BaseType::NEW, GenIjPatchType::RIGHT)[ipatch];
+			SizeType sizeLeft =  left.partition(igroup+1) - left.partition(igroup);
+			SizeType sizeRight = right.partition(jgroup+1) - right.partition(jgroup);
+			SizeType leftOffset = left.partition(igroup);
+			SizeType rightOffset = right.partition(jgroup);
+
+			PatchType* patch = new PatchType;
+			patch->sizeLeft = sizeLeft;
+			patch->sizeRight = sizeRight;
+			patch->index.resize(sizeLeft*sizeRight);
+			patch->shift = 0;
+
+			for (SizeType ileft = 0; ileft < sizeLeft; ++ileft) {
+				for (SizeType iright = 0; iright < sizeRight; ++iright) {
+					SizeType ij = ileft + leftOffset + (iright + rightOffset)*nl;
+					assert(ij < permInverse.size());
+					SizeType r = permInverse[ij];
+					SizeType ind = (distributed_) ? offsetsNew_[ipatch] + iright + ileft*sizeRight
+					                              : r - offset;
+					assert(r >= offset && ind < diagonal.size());
+					patch->index[iright + ileft*sizeRight] = ind;
+				}
+			}
+
+			VectorRealType dl;
+			VectorRealType dr;
+			for (SizeType ic = 0; ic < nC; ++ic) {
+				diagonalOf(dl, BaseType::xc(ic)(ipatch, ipatch));
+				diagonalOf(dr, BaseType::yc(ic)(ipatch, ipatch));
+				for (SizeType ileft = 0; ileft < sizeLeft; ++ileft) {
+					for (SizeType iright = 0; iright < sizeRight; ++iright) {
+						RealType val = dl[ileft]*dr[iright];
+						diagonal[patch->index[iright + ileft*sizeRight]] += val;
+						if (ic > 1) patch->shift += val;
+					}
+				}
+			}
+
+			SizeType total = sizeLeft*sizeRight;
+			if (total > 0) patch->shift /= total;
+
+			if (prec.usePatches() &&
+			        sizeLeft <= PreconditionerType::MAX_PATCH_SIDE &&
+			        sizeRight <= PreconditionerType::MAX_PATCH_SIDE) {
+				MatrixType mL;
+				toDense(mL, BaseType::xc(0)(ipatch, ipatch));
+				patch->eigsLeft.resize(sizeLeft);
+				PsimagLite::diag(mL, patch->eigsLeft, 'V');
+				patch->uLeftConj.resize(sizeLeft, sizeLeft);
+				for (SizeType i = 0; i < sizeLeft; ++i)
+					for (SizeType j = 0; j < sizeLeft; ++j)
+						patch->uLeftConj(i, j) = PsimagLite::conj(mL(i, j));
+
+				toDense(patch->uRight, BaseType::yc(1)(ipatch, ipatch));
+				patch->eigsRight.resize(sizeRight);
+				PsimagLite::diag(patch->uRight, patch->eigsRight, 'V');
+			}
+
+			prec.addPatch(patch);
+		}
+
+		prec.setDiagonal(diagonal);
+	}
+
 private:
 
+	static bool isDistributed(const ModelType& model)
+	{
+		const PsimagLite::String& options = model.params().options;
+		if (options.find("KronMpi") == PsimagLite::String::npos) return false;
+		if (options.find("BatchedGemm") != PsimagLite::String::npos) return false;
+		if (PsimagLite::Concurrency::isMpiDisabled("KronMatrix")) return false;
+		return (PsimagLite::MPI::commSize(PsimagLite::MPI::COMM_WORLD) > 1);
+	}
+
+	bool isOutPatch(SizeType ipatch) const
+	{
+		return (ipatch >= mpiRange_.first && ipatch < mpiRange_.second);
+	}
+
+	// ---------------------------------------------------------
+	// The in patches that the out patches of this rank need are
+	// those with a nonzero A and B block for some connection;
+	// yin holds the out patches of this rank, in the same layout
+	// as xout, followed by the other in patches it needs
+	// Without MPI every patch is held, and yin and xout are full
+	// ---------------------------------------------------------
+	void setInPatches()
+	{
+		const SizeType npatches = BaseType::numberOfPatches(BaseType::NEW);
+		const SizeType invalid = static_cast<SizeType>(-1);
+		offsetsNew_.assign(npatches + 1, invalid);
+		offsetsOld_.assign(npatches + 1, invalid);
+		inPatches_.clear();
+
+		const SizeType shift = offsetForPatches_[mpiRange_.first];
+		for (SizeType ipatch = mpiRange_.first; ipatch <= mpiRange_.second; ++ipatch)
+			offsetsNew_[ipatch] = offsetsOld_[ipatch] = offsetForPatches_[ipatch] - shift;
+
+		for (SizeType ipatch = mpiRange_.first; ipatch < mpiRange_.second; ++ipatch)
+			inPatches_.push_back(ipatch);
+
+		const SizeType ownSize = sizeOfPatches(mpiRange_.first, mpiRange_.second);
+		xout_.resize(ownSize, 0.0);
+
+		SizeType sum = ownSize;
+		if (distributed_) {
+			const SizeType nC = BaseType::connections();
+			for (SizeType inPatch = 0; inPatch < npatches; ++inPatch) {
+				if (isOutPatch(inPatch)) continue;
+				bool needed = false;
+				for (SizeType outPatch = mpiRange_.first; outPatch < mpiRange_.second; ++outPatch) {
+					for (SizeType ic = 0; ic < nC; ++ic) {
+						if (BaseType::xc(ic)(outPatch, inPatch).isZero()) continue;
+						if (BaseType::yc(ic)(outPatch, inPatch).isZero()) continue;
+						needed = true;
+						break;
+					}
+
+					if (needed) break;
+				}
+
+				if (!needed) continue;
+				inPatches_.push_back(inPatch);
+				offsetsOld_[inPatch] = sum;
+				sum += sizeOfPatches(inPatch, inPatch + 1);
+			}
+		}
+
+		yin_.resize(sum, 0.0);
+	}
+
 	void addHlAndHr()
 	{
 		const RealType value = 1.0;
@@ -279,18 +569,54 @@ private:
 		}
 	}
 
+	static void diagonalOf(VectorRealType& d, const MatrixDenseOrSparseType& m)
+	{
+		SizeType n = m.rows();
+		d.resize(n);
+		std::fill(d.begin(), d.end(), 0.0);
+		if (m.isDense()) {
+			const MatrixType& dense = m.dense();
+			for (SizeType i = 0; i < n; ++i)
+				d[i] = PsimagLite::real(dense(i, i));
+			return;
+		}
+
+		const SparseMatrixType& sparse = m.sparse();
+		for (SizeType i = 0; i < n; ++i) {
+			for (int k = sparse.getRowPtr(i); k < sparse.getRowPtr(i + 1); ++k) {
+				if (static_cast<SizeType>(sparse.getCol(k)) != i) continue;
+				d[i] += PsimagLite::real(sparse.getValue(k));
+			}
+		}
+	}
+
+	static void toDense(MatrixType& dest, const MatrixDenseOrSparseType& m)
+	{
+		if (m.isDense()) {
+			dest = m.dense();
+			return;
+		}
+
+		dest = m.sparse().toDense();
+	}
+
 	InitKronHamiltonian(const InitKronHamiltonian&);
 
 	InitKronHamiltonian& operator=(const InitKronHamiltonian&);
 
 	const ModelType& model_;
 	const HamiltonianConnectionType& hc_;
+	const bool distributed_;
+	PairSizeType mpiRange_;
 	SparseMatrixType identityL_;
 	SparseMatrixType identityR_;
 	VectorSizeType vstart_;
 	VectorType yin_;
 	VectorType xout_;
 	VectorSizeType offsetForPatches_;
+	VectorSizeType offsetsNew_;
+	VectorSizeType offsetsOld_;
+	VectorSizeType inPatches_;
 };
 } // namespace Dmrg
 
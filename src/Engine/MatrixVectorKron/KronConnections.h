@@ -120,10 +120,12 @@ public:
 		const bool isComplex = PsimagLite::IsComplexNumber<ComplexOrRealType>::True;
 
 		SizeType nC = initKron_.connections();
-		SizeType total = initKron_.numberOfPatches(InitKronType::OLD);
+		const VectorSizeType& inPatches = initKron_.inPatches();
+		SizeType total = inPatches.size();
 		SizeType offsetX = initKron_.offsetForPatches(InitKronType::NEW, outPatch);
 		assert(offsetX < x_.size());
-		for (SizeType inPatch=0;inPatch<total;++inPatch) {
+		for (SizeType i=0;i<total;++i) {
+			const SizeType inPatch = inPatches[i];
 			SizeType offsetY = initKron_.offsetForPatches(InitKronType::OLD, inPatch);
 			assert(offsetY < y_.size());
 			for (SizeType ic=0;ic<nC;++ic) {
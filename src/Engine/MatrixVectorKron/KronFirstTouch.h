@@ -0,0 +1,92 @@
+#ifndef KRON_FIRST_TOUCH_H
+#define KRON_FIRST_TOUCH_H
+#include "Vector.h"
+#include "PsimagLite.h"
+#include "NumaFirstTouch.h"
+#include "ProgressIndicator.h"
+
+// Placement of xout, the output of the Kronecker product, on the NUMA
+// node of the thread that will compute each out patch; xout is the only
+// buffer split by thread, since all threads read all of yin
+// Must be run with the same stable schedule and weights as KronConnections,
+// so that each thread places the patches that it will later own
+// It also counts, for each thread, the pages of its patches that are on its
+// node (local) and on other nodes (remote); this is where the pages are,
+// not how much memory traffic goes to each node
+namespace Dmrg {
+
+template<typename InitKronType>
+class KronFirstTouch {
+
+	typedef typename InitKronType::VectorType VectorType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+
+public:
+
+	KronFirstTouch(InitKronType& initKron, SizeType nthreads)
+	    : initKron_(initKron),
+	      local_(nthreads, 0),
+	      remote_(nthreads, 0)
+	{}
+
+	// the out patches of this MPI rank
+	SizeType tasks() const
+	{
+		return initKron_.mpiRange().second - initKron_.mpiRange().first;
+	}
+
+	void doTask(SizeType taskNumber, SizeType threadNum)
+	{
+		VectorType& v = initKron_.xout();
+		const SizeType outPatch = taskNumber + initKron_.mpiRange().first;
+		const SizeType start = initKron_.offsetForPatches(InitKronType::NEW, outPatch);
+		const SizeType end = initKron_.offsetForPatches(InitKronType::NEW, outPatch + 1);
+		assert(end <= v.size());
+		if (start == end) return;
+
+		const bool withFirst = (taskNumber == 0);
+		const int node = NumaFirstTouch::nodeOfThisThread();
+		NumaFirstTouch::placePages(&(v[start]), &(v[end - 1]) + 1, node, withFirst);
+
+		if (threadNum >= local_.size()) return;
+		NumaFirstTouch::countPages(local_[threadNum],
+		                           remote_[threadNum],
+		                           &(v[start]),
+		                           &(v[end - 1]) + 1,
+		                           node,
+		                           withFirst);
+	}
+
+	// one line with the total pages, and with verbose one line per thread
+	void printReport(const PsimagLite::ProgressIndicator& progress, bool verbose) const
+	{
+		SizeType totalLocal = 0;
+		SizeType totalRemote = 0;
+		for (SizeType i = 0; i < local_.size(); ++i) {
+			if (local_[i] + remote_[i] == 0) continue;
+			totalLocal += local_[i];
+			totalRemote += remote_[i];
+			if (!verbose) continue;
+			PsimagLite::OstringStream msg;
+			msg<<"First touch of xout: thread "<<i<<" localPages="<<local_[i];
+			msg<<" remotePages="<<remote_[i];
+			progress.printline(msg, std::cout);
+		}
+
+		PsimagLite::OstringStream msg;
+		msg<<"First touch of xout: localPages="<<totalLocal<<" remotePages="<<totalRemote;
+		progress.printline(msg, std::cout);
+	}
+
+private:
+
+	KronFirstTouch(const KronFirstTouch&);
+
+	KronFirstTouch& operator=(const KronFirstTouch&);
+
+	InitKronType& initKron_;
+	VectorSizeType local_;
+	VectorSizeType remote_;
+};
+}
+#endif // KRON_FIRST_TOUCH_H
@@ -81,10 +81,13 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 
 #include "Matrix.h"
 #include "KronConnections.h"
+#include "KronFirstTouch.h"
 #include "Concurrency.h"
-#include "Parallelizer.h"
+#include "ParallelizerPool.h"
 #include "PsimagLite.h"
 #include "ProgressIndicator.h"
+#include "MPI.h"
+#include <algorithm>
 #ifdef PLUGIN_SC
 #include "BatchedGemmPluginSc.h"
 #else
@@ -98,31 +101,76 @@ class KronMatrix {
 
 	typedef typename InitKronType::SparseMatrixType SparseMatrixType;
 	typedef typename SparseMatrixType::value_type ComplexOrRealType;
+	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
 	typedef KronConnections<InitKronType> KronConnectionsType;
 	typedef typename KronConnectionsType::MatrixType MatrixType;
 	typedef typename KronConnectionsType::VectorType VectorType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
 	typedef typename InitKronType::ArrayOfMatStructType ArrayOfMatStructType;
 	typedef typename InitKronType::GenIjPatchType GenIjPatchType;
 	typedef typename ArrayOfMatStructType::MatrixDenseOrSparseType MatrixDenseOrSparseType;
 	typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename PsimagLite::Vector<VectorSizeType>::Type VectorVectorSizeType;
 	typedef typename GenIjPatchType::BasisType BasisType;
 	typedef BatchedGemm2<InitKronType> BatchedGemmType;
+	typedef std::pair<SizeType, SizeType> PairSizeType;
+	typedef KronFirstTouch<InitKronType> KronFirstTouchType;
+
+	enum {TAG_YIN = 1024, TAG_XOUT = 1025};
+
+	// The out patches of this MPI rank, [first, second)
+	class KronConnectionsRange {
+
+	public:
+
+		KronConnectionsRange(KronConnectionsType& kc, const PairSizeType& range)
+		    : kc_(kc), range_(range)
+		{}
+
+		SizeType tasks() const { return range_.second - range_.first; }
+
+		void doTask(SizeType taskNumber, SizeType threadNum)
+		{
+			kc_.doTask(taskNumber + range_.first, threadNum);
+		}
+
+	private:
+
+		KronConnectionsType& kc_;
+		const PairSizeType& range_;
+	};
 
 public:
 
 	KronMatrix(InitKronType& initKron, PsimagLite::String name)
 	    : initKron_(initKron),
 	      progress_("KronMatrix"),
-	      batchedGemm_(initKron)
+	      batchedGemm_(initKron),
+	      mpiSize_(1),
+	      mpiRank_(0),
+	      placed_(false)
 	{
 		PsimagLite::String str((initKron.loadBalance()) ? "true" : "false");
 		PsimagLite::OstringStream msg;
 		msg<<"KronMatrix: "<<name<<" sizes="<<initKron.size(InitKronType::NEW);
 		msg<<" "<<initKron.size(InitKronType::OLD);
 		msg<<" loadBalance "<<str;
+		if (initKron.distributed()) {
+			setMpiPeers();
+			const PairSizeType& range = initKron_.mpiRange();
+			msg<<" MPI ranks "<<mpiSize_<<" this rank has out patches ";
+			msg<<range.first<<" to "<<range.second<<" and needs ";
+			msg<<(initKron_.inPatches().size() - range.second + range.first);
+			msg<<" in patches of other ranks";
+		}
+
 		progress_.printline(msg, std::cout);
+
+		if (!batchedGemm_.enabled()) firstTouch();
 	}
 
+	bool distributed() const { return (mpiSize_ > 1); }
+
 	void matrixVectorProduct(VectorType& vout, const VectorType& vin) const
 	{
 		initKron_.copyIn(vout, vin);
@@ -138,22 +186,242 @@ public:
 			return;
 		}
 
+		compute();
+
+		initKron_.copyOut(vout);
+
+		if (mpiSize_ > 1) exchangeOut(vout, initKron_.xout());
+	}
+
+	// x and y hold the out patches of this rank, see InitKronHamiltonian::toLocal;
+	// only the in patches that this rank needs are received from other ranks
+	void matrixVectorProductLocal(VectorType& x, const VectorType& y) const
+	{
+		assert(mpiSize_ > 1);
+		initKron_.copyInLocal(x, y);
+		exchangeIn();
+		compute();
+		x = initKron_.xout();
+	}
+
+	// full(:) from the local(:) of all ranks; collective
+	void fromLocal(VectorType& full, const VectorType& local) const
+	{
+		full.resize(initKron_.size(InitKronType::NEW));
+		std::fill(full.begin(), full.end(), 0.0);
+		const PairSizeType& range = initKron_.mpiRange();
+		initKron_.copyOut(full, local, range.first, range.second);
+		exchangeOut(full, local);
+	}
+
+	void sumOverRanks(ComplexOrRealType& value) const
+	{
+		if (mpiSize_ < 2) return;
+		VectorType tmp(1, value);
+		PsimagLite::MPI::allReduce(tmp);
+		value = tmp[0];
+	}
+
+	RealType minOverRanks(RealType value) const
+	{
+		if (mpiSize_ < 2) return value;
+		VectorRealType tmp(mpiSize_, 0.0);
+		tmp[mpiRank_] = value;
+		PsimagLite::MPI::allReduce(tmp);
+		return *std::min_element(tmp.begin(), tmp.end());
+	}
+
+private:
+
+	// H y on the out patches of this rank
+	void compute() const
+	{
 		KronConnectionsType kc(initKron_);
+		KronConnectionsRange kcRange(kc, initKron_.mpiRange());
 
-		typedef PsimagLite::Parallelizer<KronConnectionsType> ParallelizerType;
-		ParallelizerType parallelConnections(PsimagLite::Concurrency::codeSectionParams);
+		typedef ParallelizerPool<KronConnectionsRange> ParallelizerType;
+		ParallelizerType parallelConnections(PsimagLite::Concurrency::codeSectionParams,
+		                                     "KronMatrix::matrixVectorProduct",
+		                                     placed_);
 
 		if (initKron_.loadBalance())
-			parallelConnections.loopCreate(kc, initKron_.weightsOfPatchesNew());
+			parallelConnections.loopCreate(kcRange, weightsOfRange());
 		else
-			parallelConnections.loopCreate(kc);
+			parallelConnections.loopCreate(kcRange);
 
 		kc.sync();
+	}
 
-		initKron_.copyOut(vout);
+	// The pages of xout are placed on the NUMA node of the thread that owns
+	// each out patch; only with setAffinities and the thread pool, which
+	// keep threads on their cpus, and then matrixVectorProduct uses the same
+	// stable schedule and weights, so that each patch stays with its thread
+	void firstTouch()
+	{
+		const SizeType nthreads = PsimagLite::Concurrency::codeSectionParams.npthreads;
+		if (nthreads < 2 || !initKron_.setAffinities() || !ThreadPoolEngine::enabled())
+			return;
+
+		KronFirstTouchType kft(initKron_, nthreads);
+		typedef ParallelizerPool<KronFirstTouchType> ParallelizerType;
+		ParallelizerType parallelTouch(PsimagLite::Concurrency::codeSectionParams,
+		                               "KronMatrix::firstTouch",
+		                               true);
+
+		if (initKron_.loadBalance())
+			parallelTouch.loopCreate(kft, weightsOfRange());
+		else
+			parallelTouch.loopCreate(kft);
+
+		kft.printReport(progress_, initKron_.verbose());
+		placed_ = true;
 	}
 
-private:
+	VectorSizeType weightsOfRange() const
+	{
+		const VectorSizeType& weights = initKron_.weightsOfPatchesNew();
+		const PairSizeType& range = initKron_.mpiRange();
+		return VectorSizeType(weights.begin() + range.first, weights.begin() + range.second);
+	}
+
+	// --------------------------------------------------------------
+	// For each other rank, which of our out patches it needs as in
+	// patches (sendPatches_), and which of its out patches we need
+	// (recvPatches_); exchanged once per superblock with one allReduce
+	// --------------------------------------------------------------
+	void setMpiPeers()
+	{
+		mpiSize_ = PsimagLite::MPI::commSize(PsimagLite::MPI::COMM_WORLD);
+		mpiRank_ = PsimagLite::MPI::commRank(PsimagLite::MPI::COMM_WORLD);
+
+		const SizeType npatches = initKron_.numberOfPatches(InitKronType::NEW);
+		VectorSizeType owner(npatches, 0);
+		ranges_.resize(mpiSize_);
+		for (SizeType rank = 0; rank < mpiSize_; ++rank) {
+			ranges_[rank] = initKron_.mpiRangeOf(rank);
+			for (SizeType p = ranges_[rank].first; p < ranges_[rank].second; ++p)
+				owner[p] = rank;
+		}
+
+		const PairSizeType& range = initKron_.mpiRange();
+		const VectorSizeType& inPatches = initKron_.inPatches();
+		VectorSizeType needs(mpiSize_*npatches, 0);
+		for (SizeType i = range.second - range.first; i < inPatches.size(); ++i)
+			needs[mpiRank_*npatches + inPatches[i]] = 1;
+
+		PsimagLite::MPI::allReduce(needs);
+
+		sendPatches_.clear();
+		recvPatches_.clear();
+		sendPatches_.resize(mpiSize_);
+		recvPatches_.resize(mpiSize_);
+		for (SizeType rank = 0; rank < mpiSize_; ++rank) {
+			if (rank == mpiRank_) continue;
+			for (SizeType p = 0; p < npatches; ++p) {
+				if (needs[rank*npatches + p] > 0 && owner[p] == mpiRank_)
+					sendPatches_[rank].push_back(p);
+				if (needs[mpiRank_*npatches + p] > 0 && owner[p] == rank)
+					recvPatches_[rank].push_back(p);
+			}
+		}
+	}
+
+	// the in patches of other ranks that this rank needs, into yin
+	void exchangeIn() const
+	{
+		VectorType& yin = initKron_.yin();
+		for (SizeType a = 0; a < mpiSize_; ++a) {
+			for (SizeType b = a + 1; b < mpiSize_; ++b) {
+				if (a != mpiRank_ && b != mpiRank_) continue;
+				const SizeType peer = (a == mpiRank_) ? b : a;
+				if (sendPatches_[peer].size() == 0 && recvPatches_[peer].size() == 0)
+					continue;
+
+				// pairs are visited in the same order by all ranks,
+				// and the lower rank of each pair sends first
+				if (a == mpiRank_) {
+					sendPatchesTo(peer, yin);
+					recvPatchesFrom(peer, yin);
+				} else {
+					recvPatchesFrom(peer, yin);
+					sendPatchesTo(peer, yin);
+				}
+			}
+		}
+	}
+
+	void sendPatchesTo(SizeType peer, const VectorType& yin) const
+	{
+		const VectorSizeType& patches = sendPatches_[peer];
+		if (patches.size() == 0) return;
+
+		VectorType buffer;
+		for (SizeType i = 0; i < patches.size(); ++i) {
+			const SizeType start = initKron_.offsetForPatches(InitKronType::NEW, patches[i]);
+			const SizeType size = initKron_.sizeOfPatches(patches[i], patches[i] + 1);
+			buffer.insert(buffer.end(), yin.begin() + start, yin.begin() + start + size);
+		}
+
+		PsimagLite::MPI::send(buffer, peer, TAG_YIN, PsimagLite::MPI::COMM_WORLD);
+	}
+
+	void recvPatchesFrom(SizeType peer, VectorType& yin) const
+	{
+		const VectorSizeType& patches = recvPatches_[peer];
+		if (patches.size() == 0) return;
+
+		SizeType total = 0;
+		for (SizeType i = 0; i < patches.size(); ++i)
+			total += initKron_.sizeOfPatches(patches[i], patches[i] + 1);
+
+		VectorType buffer(total);
+		PsimagLite::MPI::recv(buffer, peer, TAG_YIN, PsimagLite::MPI::COMM_WORLD);
+
+		SizeType start = 0;
+		for (SizeType i = 0; i < patches.size(); ++i) {
+			const SizeType offset = initKron_.offsetForPatches(InitKronType::OLD, patches[i]);
+			const SizeType size = initKron_.sizeOfPatches(patches[i], patches[i] + 1);
+			std::copy(buffer.begin() + start, buffer.begin() + start + size, yin.begin() + offset);
+			start += size;
+		}
+	}
+
+	// vout(:) of the out patches of the other ranks, from their x(:);
+	// only for the replicated vectors of solvers other than
+	// the preconditioned Davidson
+	void exchangeOut(VectorType& vout, const VectorType& x) const
+	{
+		VectorType mine = x;
+		for (SizeType a = 0; a < mpiSize_; ++a) {
+			for (SizeType b = a + 1; b < mpiSize_; ++b) {
+				if (a != mpiRank_ && b != mpiRank_) continue;
+				const SizeType peer = (a == mpiRank_) ? b : a;
+				const PairSizeType& range = ranges_[peer];
+				VectorType theirs(initKron_.sizeOfPatches(range.first, range.second));
+				if (a == mpiRank_) {
+					sendSlice(mine, peer);
+					recvSlice(theirs, peer);
+				} else {
+					recvSlice(theirs, peer);
+					sendSlice(mine, peer);
+				}
+
+				initKron_.copyOut(vout, theirs, range.first, range.second);
+			}
+		}
+	}
+
+	static void sendSlice(VectorType& x, SizeType peer)
+	{
+		if (x.size() == 0) return;
+		PsimagLite::MPI::send(x, peer, TAG_XOUT, PsimagLite::MPI::COMM_WORLD);
+	}
+
+	static void recvSlice(VectorType& x, SizeType peer)
+	{
+		if (x.size() == 0) return;
+		PsimagLite::MPI::recv(x, peer, TAG_XOUT, PsimagLite::MPI::COMM_WORLD);
+	}
 
 	KronMatrix(const KronMatrix&);
 
@@ -162,6 +430,12 @@ private:
 	InitKronType& initKron_;
 	PsimagLite::ProgressIndicator progress_;
 	BatchedGemmType batchedGemm_;
+	SizeType mpiSize_;
+	SizeType mpiRank_;
+	typename PsimagLite::Vector<PairSizeType>::Type ranges_;
+	VectorVectorSizeType sendPatches_;
+	VectorVectorSizeType recvPatches_;
+	bool placed_;
 }; //class KronMatrix
 
 } // namespace PsimagLite
@@ -147,6 +147,43 @@ public:
 		const PsimagLite::MemoryUsage::TimeHandle time2 = PsimagLite::ProgressIndicator::time();
 		const PsimagLite::MemoryUsage::TimeHandle deltaTime = time2 - time1;
 		time_ += deltaTime;
+		BaseType::countMatvec();
+	}
+
+	// SolverOptions=KronMpi: the eigensolver may work on the out patches
+	// of this MPI rank only, see DavidsonSolverPreconditioned
+	bool distributed() const
+	{
+		return (matrixStored_.rows() == 0 && kronMatrix_.distributed());
+	}
+
+	SizeType localRows() const { return initKron_.xout().size(); }
+
+	void toLocal(VectorType& local, const VectorType& full) const
+	{
+		initKron_.toLocal(local, full);
+	}
+
+	void fromLocal(VectorType& full, const VectorType& local) const
+	{
+		kronMatrix_.fromLocal(full, local);
+	}
+
+	void matrixVectorProductLocal(VectorType& x, const VectorType& y) const
+	{
+		const PsimagLite::MemoryUsage::TimeHandle time1 = PsimagLite::ProgressIndicator::time();
+
+		kronMatrix_.matrixVectorProductLocal(x, y);
+
+		const PsimagLite::MemoryUsage::TimeHandle time2 = PsimagLite::ProgressIndicator::time();
+		const PsimagLite::MemoryUsage::TimeHandle deltaTime = time2 - time1;
+		time_ += deltaTime;
+		BaseType::countMatvec();
+	}
+
+	void sumOverRanks(ComplexOrRealType& value) const
+	{
+		kronMatrix_.sumOverRanks(value);
 	}
 
 	void fullDiag(VectorRealType& eigs,FullMatrixType& fm) const
@@ -154,6 +191,19 @@ public:
 		BaseType::fullDiag(eigs, fm, matrixStored_, params_.maxMatrixRankStored);
 	}
 
+	template<typename PreconditionerType>
+	void fillPreconditioner(PreconditionerType& prec) const
+	{
+		if (matrixStored_.rows() > 0) {
+			BaseType::fillPreconditioner(prec, matrixStored_);
+			return;
+		}
+
+		initKron_.fillPreconditioner(prec);
+		if (distributed())
+			prec.lowest(kronMatrix_.minOverRanks(prec.lowest()));
+	}
+
 private:
 
 	void checkKron() const
@@ -0,0 +1,39 @@
+#ifndef MATRIX_VECTOR_LOCAL_H
+#define MATRIX_VECTOR_LOCAL_H
+#include "Vector.h"
+
+// The rows of this MPI rank of a matrix-vector class whose vectors are
+// distributed over ranks, see MatrixVectorKron and SolverOptions=KronMpi
+// Eigensolvers that take it must reduce their dot products with sumOverRanks
+namespace Dmrg {
+
+template<typename MatrixVectorType>
+class MatrixVectorLocal {
+
+public:
+
+	typedef typename MatrixVectorType::VectorType VectorType;
+	typedef typename VectorType::value_type ComplexOrRealType;
+
+	MatrixVectorLocal(const MatrixVectorType& h)
+	    : h_(h)
+	{}
+
+	SizeType rows() const { return h_.localRows(); }
+
+	void matrixVectorProduct(VectorType& x, const VectorType& y) const
+	{
+		h_.matrixVectorProductLocal(x, y);
+	}
+
+	void sumOverRanks(ComplexOrRealType& value) const
+	{
+		h_.sumOverRanks(value);
+	}
+
+private:
+
+	const MatrixVectorType& h_;
+};
+}
+#endif // MATRIX_VECTOR_LOCAL_H
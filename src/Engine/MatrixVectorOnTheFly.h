@@ -123,6 +123,8 @@ public:
 			matrixStored_.matrixVectorProduct(x,y);
 		else
 			model_.matrixVectorProduct(x, y, hc_);
+
+		BaseType::countMatvec();
 	}
 
 	void fullDiag(VectorRealType& eigs,FullMatrixType& fm) const
@@ -136,6 +138,12 @@ public:
 		BaseType::fullDiag(eigs, fm, matrixStored_, mrs);
 	}
 
+	template<typename PreconditionerType>
+	void fillPreconditioner(PreconditionerType& prec) const
+	{
+		BaseType::fillPreconditioner(prec, matrixStored_);
+	}
+
 private:
 
 	const ModelType& model_;
@@ -140,6 +140,7 @@ public:
 	void matrixVectorProduct(SomeVectorType &x, SomeVectorType const &y) const
 	{
 		matrixStored_[pointer_].matrixVectorProduct(x,y);
+		BaseType::countMatvec();
 	}
 
 	value_type operator()(SizeType i,SizeType j) const
@@ -159,6 +160,12 @@ public:
 		                   model_.params().maxMatrixRankStored);
 	}
 
+	template<typename PreconditionerType>
+	void fillPreconditioner(PreconditionerType& prec) const
+	{
+		BaseType::fillPreconditioner(prec, matrixStored_[pointer_]);
+	}
+
 private:
 
 	const ModelType& model_;
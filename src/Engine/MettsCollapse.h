@@ -122,6 +122,11 @@ public:
 	      collapseBasis_(0,0)
 	{}
 
+	void reseed(typename RngType::LongType seed)
+	{
+		rng_ = RngType(seed);
+	}
+
 	bool operator()(VectorWithOffsetType& c,
 	                const VectorWithOffsetType& eToTheBetaH,
 	                typename PsimagLite::Vector<SizeType>::Type& block,
@@ -117,6 +117,15 @@ public:
 
 	const ModelType& model() const { return model_; }
 
+	// continues from the state of other, with the stream of seed
+	void fork(const MettsStochastics& other, LongType seed)
+	{
+		rng_ = RngType(seed);
+		pureStates_ = other.pureStates_;
+		addedSites_ = other.addedSites_;
+		qnVsSize_ = other.qnVsSize_;
+	}
+
 	SizeType chooseRandomState(SizeType site) const
 	{
 		if (site < pure_.size()) return pure_[site];
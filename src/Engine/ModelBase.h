@@ -88,6 +88,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "ModelCommon.h"
 #include "NotReallySort.h"
 #include "ParallelHamiltonianConnection.h"
+#include "ParallelizerPool.h"
 
 namespace Dmrg {
 
@@ -153,6 +154,7 @@ public:
 		modelLinks_.postCtor1(labeledOperators_, modelCommon_.geometry().terms());
 		fillModelLinks(); // fills modelLinks_
 		modelLinks_.postCtor2();
+		HamiltonianConnectionType::clearCache(); // links depend on modelLinks_
 
 		ProgramGlobals::init(maxElectronsOneSpin());
 	}
@@ -400,8 +402,8 @@ for (SizeType dof = 0; dof < numberOfDofs; ++dof) {
 	                         const VectorType& y,
 	                         const HamiltonianConnectionType& hc) const
 	{
-		typedef PsimagLite::Parallelizer<ParallelHamConnectionType> ParallelizerType;
-		ParallelizerType parallelConnections(PsimagLite::Concurrency::codeSectionParams);
+		typedef ParallelizerPool<ParallelHamConnectionType> ParallelizerType;
+		ParallelizerType parallelConnections(PsimagLite::Concurrency::codeSectionParams, "ModelBase::matrixVectorProduct");
 
 		ParallelHamConnectionType phc(x, y, hc);
 		parallelConnections.loopCreate(phc);
@@ -180,6 +180,12 @@ public:
 		return lrs_.super().qnEx(m_);
 	}
 
+	// Nothing to cache here, see ModelHelperSu2::cacheOperators
+	void cacheOperators(SparseMatrixType const&,
+	                    SparseMatrixType const&,
+	                    const LinkType&)
+	{}
+
 	//! Does matrixBlock= (AB), A belongs to pSprime and B
 	// belongs to pEprime or viceversa (inter)
 	void fastOpProdInter(SparseMatrixType const &A,
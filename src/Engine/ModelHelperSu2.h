@@ -73,6 +73,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 
 #include "ClebschGordanCached.h"
 #include "Su2Reduced.h"
+#include "Su2ReducedKron.h"
 #include "Link.h"
 
 /** \ingroup DMRG */
@@ -91,6 +92,8 @@ template<typename LeftRightSuperType_>
 class ModelHelperSu2  {
 
 	typedef std::pair<SizeType,SizeType> PairType;
+	typedef Su2Reduced<LeftRightSuperType_> Su2ReducedType;
+	typedef Su2ReducedKron<LeftRightSuperType_, Su2ReducedType> Su2ReducedKronType;
 
 public:
 
@@ -114,7 +117,8 @@ public:
 	ModelHelperSu2(int m, const LeftRightSuperType& lrs)
 	    : m_(m),
 	      lrs_(lrs),
-	      su2reduced_(m,lrs)
+	      su2reduced_(m,lrs),
+	      su2ReducedKron_(m, lrs, su2reduced_, !ProgramGlobals::su2NoKron)
 	{}
 
 	const SparseMatrixType& reducedOperator(char modifier,
@@ -151,6 +155,19 @@ public:
 		return lrs_.super().qnEx(m_);
 	}
 
+	// Unless SolverOptions contains su2NoKron, the products with vectors are
+	// done by patches and GEMMs, see Su2ReducedKron.h, and the operators
+	// of each link must be given here once, before any product
+	void cacheOperators(SparseMatrixType const &A,
+	                    SparseMatrixType const &B,
+	                    const LinkType& link)
+	{
+		if (link.type == ProgramGlobals::ConnectionEnum::ENVIRON_SYSTEM)
+			su2ReducedKron_.cacheOperators(B, A);
+		else
+			su2ReducedKron_.cacheOperators(A, B);
+	}
+
 	// Does matrixBlock= (AB), A belongs to pSprime and B
 	// belongs to pEprime or viceversa (inter)
 	void fastOpProdInter(SparseMatrixType const &A,
@@ -253,6 +270,11 @@ public:
 			return;
 		}
 
+		if (su2ReducedKron_.enabled()) {
+			su2ReducedKron_.fastOpProdInter(x, y, A, B, link, flipped, su2reduced_);
+			return;
+		}
+
 		//! work only on partition m
 		int m = m_;
 		int offset = lrs_.super().partition(m);
@@ -314,6 +336,11 @@ public:
 	void hamiltonianLeftProduct(VectorSparseElementType& x,
 	                            const VectorSparseElementType& y) const
 	{
+		if (su2ReducedKron_.enabled()) {
+			su2ReducedKron_.hamiltonianLeftProduct(x, y, su2reduced_);
+			return;
+		}
+
 		//! work only on partition m
 		int m = m_;
 		int offset = lrs_.super().partition(m);
@@ -352,6 +379,11 @@ public:
 	void hamiltonianRightProduct(VectorSparseElementType& x,
 	                             const VectorSparseElementType& y) const
 	{
+		if (su2ReducedKron_.enabled()) {
+			su2ReducedKron_.hamiltonianRightProduct(x, y, su2reduced_);
+			return;
+		}
+
 		//! work only on partition m
 		int m = m_;
 		int offset = lrs_.super().partition(m);
@@ -480,7 +512,8 @@ private:
 
 	int m_;
 	const LeftRightSuperType&  lrs_;
-	Su2Reduced<LeftRightSuperType> su2reduced_;
+	Su2ReducedType su2reduced_;
+	Su2ReducedKronType su2ReducedKron_;
 };
 } // namespace Dmrg
 /*@}*/
@@ -0,0 +1,145 @@
+#ifndef NUMA_FIRST_TOUCH_H
+#define NUMA_FIRST_TOUCH_H
+#include "Vector.h"
+#include "PsimagLite.h"
+#ifdef __linux__
+#include <unistd.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+// Helpers for the placement of large buffers on NUMA nodes
+// Linux places a page on the node of the thread that first writes it,
+// but PsimagLite vectors are zeroed when allocated, by the allocating
+// thread; so the thread that will own part of a buffer moves the pages of
+// that part to its node instead, see placePages()
+// On other systems these functions do nothing
+namespace Dmrg {
+
+class NumaFirstTouch {
+
+public:
+
+	enum {NO_NODE = -1};
+
+	// node of the cpu this thread is running on
+	static int nodeOfThisThread()
+	{
+#ifdef __linux__
+		unsigned int cpu = 0;
+		unsigned int node = 0;
+		if (syscall(SYS_getcpu, &cpu, &node, 0) != 0) return NO_NODE;
+		return node;
+#else
+		return NO_NODE;
+#endif
+	}
+
+	// Moves to node the pages that start in [begin, end), and also the page
+	// holding begin if withFirst; so that each page of a buffer split into
+	// consecutive parts is moved once, by the owner of its first byte
+	static void placePages(const void* begin, const void* end, int node, bool withFirst)
+	{
+#ifdef __linux__
+		if (node == NO_NODE) return;
+		std::vector<void*> pages;
+		fillPages(pages, begin, end, withFirst);
+		if (pages.size() == 0) return;
+		std::vector<int> nodes(pages.size(), node);
+		std::vector<int> status(pages.size(), NO_NODE);
+		syscall(SYS_move_pages, 0, pages.size(), &(pages[0]), &(nodes[0]), &(status[0]),
+		        FLAG_MOVE);
+#endif
+	}
+
+	// counts the pages of placePages(begin, end, node, withFirst) that are
+	// on node, and those that are on other nodes; pages not yet placed
+	// are not counted
+	static void countPages(SizeType& local,
+	                       SizeType& remote,
+	                       const void* begin,
+	                       const void* end,
+	                       int node,
+	                       bool withFirst)
+	{
+#ifdef __linux__
+		if (node == NO_NODE) return;
+		std::vector<void*> pages;
+		fillPages(pages, begin, end, withFirst);
+		if (pages.size() == 0) return;
+		std::vector<int> status(pages.size(), NO_NODE);
+		if (syscall(SYS_move_pages, 0, pages.size(), &(pages[0]), 0, &(status[0]), 0) != 0)
+			return;
+
+		for (SizeType i = 0; i < status.size(); ++i) {
+			if (status[i] < 0) continue;
+			if (status[i] == node) ++local;
+			else ++remote;
+		}
+#endif
+	}
+
+	// pins the calling thread to the cpu-th (modulo their number) of the cpus
+	// that this process was allowed to run on when first called,
+	// so that taskset, numactl, and MPI launchers are respected
+	static void pinThisThread(SizeType cpu)
+	{
+#ifdef __linux__
+		const std::vector<int>& cpus = allowedCpus();
+		if (cpus.size() == 0) return;
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpus[cpu % cpus.size()], &set);
+		sched_setaffinity(0, sizeof(set), &set);
+#endif
+	}
+
+private:
+
+#ifdef __linux__
+	enum {FLAG_MOVE = 2}; // MPOL_MF_MOVE of numaif.h, which needs libnuma
+
+	static const std::vector<int>& allowedCpus()
+	{
+		static const std::vector<int> cpus = readAllowedCpus();
+		return cpus;
+	}
+
+	static std::vector<int> readAllowedCpus()
+	{
+		std::vector<int> cpus;
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		if (sched_getaffinity(0, sizeof(set), &set) != 0) return cpus;
+		for (int i = 0; i < CPU_SETSIZE; ++i)
+			if (CPU_ISSET(i, &set)) cpus.push_back(i);
+
+		return cpus;
+	}
+
+	static void fillPages(std::vector<void*>& pages,
+	                      const void* begin,
+	                      const void* end,
+	                      bool withFirst)
+	{
+		const SizeType page = pageSize();
+		SizeType b = reinterpret_cast<SizeType>(begin);
+		SizeType e = reinterpret_cast<SizeType>(end);
+		b = (withFirst) ? b - b % page : ((b + page - 1)/page)*page;
+		for (SizeType p = b; p < e; p += page)
+			pages.push_back(reinterpret_cast<void*>(p));
+	}
+#endif
+
+	static SizeType pageSize()
+	{
+#ifdef __linux__
+		long page = sysconf(_SC_PAGESIZE);
+		return (page > 0) ? page : 4096;
+#else
+		return 4096;
+#endif
+	}
+};
+}
+#endif // NUMA_FIRST_TOUCH_H
@@ -83,6 +83,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Vector.h"
 #include "ProgramGlobals.h"
 #include "ApplyOperatorLocal.h"
+#include "ParallelizerPool.h"
+#include <map>
 
 namespace Dmrg {
 
@@ -107,6 +109,11 @@ public:
 	typedef typename ObserverType::BraketType BraketType;
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef std::pair<SizeType,SizeType> PairSizeType;
+	typedef PsimagLite::Vector<PsimagLite::String>::Type VectorStringType;
+	typedef typename ObserverType::TwoPointCorrelationsType TwoPointCorrelationsType;
+	typedef typename TwoPointCorrelationsType::Request TwoPointRequestType;
+	typedef typename TwoPointCorrelationsType::VectorRequestType VectorTwoPointRequestType;
+	typedef std::map<PsimagLite::String, MatrixType> MapStringMatrixType;
 
 	template<typename IoInputter>
 	ObservableLibrary(IoInputter& io,
@@ -144,6 +151,27 @@ public:
 		}
 	}
 
+	// As measure(label, ...) for each label, in order, but with the
+	// two-point correlations of all labels computed first in one pass,
+	// so that operators grown from the same site are shared
+	void measure(const VectorStringType& labels,
+	             SizeType rows,
+	             SizeType cols,
+	             SizeType orbitals)
+	{
+		VectorTwoPointRequestType requests;
+		for (SizeType i = 0; i < labels.size(); ++i)
+			planTwoPoint(requests, labels[i], rows, cols, orbitals);
+
+		if (requests.size() > 0)
+			observe_.twoPoint(requests);
+
+		for (SizeType i = 0; i < labels.size(); ++i)
+			measure(labels[i], rows, cols, orbitals);
+
+		twoPoints_.clear();
+	}
+
 	void measure(const PsimagLite::String& label,
 	             SizeType rows,
 	             SizeType cols,
@@ -160,22 +188,17 @@ public:
 			SizeType site = 1;
 			for (SizeType i = 0; i < orbitals*2; ++i) {
 				for (SizeType j = i; j < orbitals*2; ++j) {
-					SparseMatrixType O2,O4,n1,n2;
-					SparseMatrixType O1 = model_.naturalOperator("c",site,i).data; // c_i
-					transposeConjugate(O2,O1); // O2 = transpose(O1)
-					SparseMatrixType O3 = model_.naturalOperator("c",site,j).data; // c_j
-					transposeConjugate(O4,O3); // O4 = transpose(O3)
-
-					multiply(n1,O2,O1); // c_i^{\dagger}.c_i
-					multiply(n2,O4,O3); // c_j^{\dagger}.c_j
+					SparseMatrixType n1,n2;
+					nnOperators(n1, n2, site, i, j);
 
 					PsimagLite::String str = "<gs|n?" + ttos(i) + ";n?" + ttos(j) + "|gs>";
-					observe_.twoPoint(out,
-					                  n1,
-					                  n2,
-					                  ProgramGlobals::FermionOrBosonEnum::BOSON,
-					                  "gs",
-					                  "gs");
+					if (!cachedTwoPoint(out, str))
+						observe_.twoPoint(out,
+						                  n1,
+						                  n2,
+						                  ProgramGlobals::FermionOrBosonEnum::BOSON,
+						                  "gs",
+						                  "gs");
 					std::cout << str << std::endl;
 					std::cout << out;
 				}
@@ -377,6 +400,115 @@ public:
 
 private:
 
+	// Adds the two-point correlations that measure(label, ...) will need
+	// to requests, with storage in twoPoints_; labels that are not
+	// listed here compute their correlations themselves
+	void planTwoPoint(VectorTwoPointRequestType& requests,
+	                  const PsimagLite::String& label,
+	                  SizeType rows,
+	                  SizeType cols,
+	                  SizeType orbitals)
+	{
+		if (label == "cc") {
+			planBraket(requests, "<gs|c?0-;c'?0-|gs>", rows, cols);
+			planBraket(requests, "<gs|c?1-;c'?1-|gs>", rows, cols);
+		} else if (label == "nn") {
+			SizeType site = 1;
+			for (SizeType i = 0; i < orbitals*2; ++i) {
+				for (SizeType j = i; j < orbitals*2; ++j) {
+					PsimagLite::String str = "<gs|n?" + ttos(i) + ";n?" + ttos(j) + "|gs>";
+					if (twoPoints_.find(str) != twoPoints_.end()) continue;
+					SparseMatrixType n1,n2;
+					nnOperators(n1, n2, site, i, j);
+					MatrixType& m = twoPoints_[str];
+					m.resize(rows, cols);
+					requests.push_back(TwoPointRequestType(m,
+					                                       n1,
+					                                       n2,
+					                                       ProgramGlobals::FermionOrBosonEnum::BOSON,
+					                                       "gs",
+					                                       "gs"));
+				}
+			}
+		} else if (label == "szsz") {
+			if (szsz_.size() == 0)
+				planOrbitals(requests, "sz", "sz", rows, cols, orbitals);
+		} else if (label == "s+s-") {
+			if (sPlusSminus_.size() == 0)
+				planOrbitals(requests, "splus", "sminus", rows, cols, orbitals);
+		} else if (label == "s-s+") {
+			if (sMinusSplus_.size() == 0)
+				planOrbitals(requests, "sminus", "splus", rows, cols, orbitals);
+		} else if (label == "ss") {
+			planTwoPoint(requests, "szsz", rows, cols, orbitals);
+			planTwoPoint(requests, "s+s-", rows, cols, orbitals);
+			planTwoPoint(requests, "s-s+", rows, cols, orbitals);
+		} else if (label == "dd") {
+			planBraket(requests, "<gs|d;d'|gs>", rows, cols);
+		}
+	}
+
+	void planOrbitals(VectorTwoPointRequestType& requests,
+	                  PsimagLite::String op1,
+	                  PsimagLite::String op2,
+	                  SizeType rows,
+	                  SizeType cols,
+	                  SizeType orbitals)
+	{
+		for (SizeType i = 0; i < orbitals; ++i) {
+			for (SizeType j = i; j < orbitals; ++j) {
+				PsimagLite::String str = "<gs|" + op1 + "?" + ttos(i) + ";";
+				str += op2 + "?" + ttos(j) + "|gs>";
+				planBraket(requests, str, rows, cols);
+			}
+		}
+	}
+
+	void planBraket(VectorTwoPointRequestType& requests,
+	                PsimagLite::String str,
+	                SizeType rows,
+	                SizeType cols)
+	{
+		BraketType braket(model_, str);
+		assert(braket.points() == 2);
+		const PsimagLite::String key = braket.toString();
+		if (twoPoints_.find(key) != twoPoints_.end()) return;
+		MatrixType& m = twoPoints_[key];
+		m.resize(rows, cols);
+		requests.push_back(TwoPointRequestType(m,
+		                                       braket.op(0).data,
+		                                       braket.op(1).data,
+		                                       braket.op(0).fermionOrBoson,
+		                                       braket.bra(),
+		                                       braket.ket()));
+	}
+
+	// returns false if key was not planned, see planTwoPoint
+	bool cachedTwoPoint(MatrixType& m, const PsimagLite::String& key) const
+	{
+		typename MapStringMatrixType::const_iterator it = twoPoints_.find(key);
+		if (it == twoPoints_.end()) return false;
+		m = it->second;
+		return true;
+	}
+
+	// n1 = c_i^{\dagger}.c_i and n2 = c_j^{\dagger}.c_j
+	void nnOperators(SparseMatrixType& n1,
+	                 SparseMatrixType& n2,
+	                 SizeType site,
+	                 SizeType i,
+	                 SizeType j) const
+	{
+		SparseMatrixType O2,O4;
+		SparseMatrixType O1 = model_.naturalOperator("c",site,i).data; // c_i
+		transposeConjugate(O2,O1); // O2 = transpose(O1)
+		SparseMatrixType O3 = model_.naturalOperator("c",site,j).data; // c_j
+		transposeConjugate(O4,O3); // O4 = transpose(O3)
+
+		multiply(n1,O2,O1); // c_i^{\dagger}.c_i
+		multiply(n2,O4,O3); // c_j^{\dagger}.c_j
+	}
+
 	void measureOnePoint(const PsimagLite::String& bra,
 	                     const OperatorType& opA,
 	                     PsimagLite::String label,
@@ -600,8 +732,8 @@ private:
 		}
 
 		typedef typename ObserverType::Parallel4PointDsType Parallel4PointDsType;
-		typedef PsimagLite::Parallelizer<Parallel4PointDsType> ParallelizerType;
-		ParallelizerType threaded4PointDs(PsimagLite::Concurrency::codeSectionParams);
+		typedef ParallelizerPool<Parallel4PointDsType> ParallelizerType;
+		ParallelizerType threaded4PointDs(PsimagLite::Concurrency::codeSectionParams, "ObservableLibrary::ppupupdndn");
 
 		Parallel4PointDsType helper4PointDs(m,
 		                                    observe_.fourpoint(),
@@ -610,7 +742,7 @@ private:
 		                                    pairs,
 		                                    Parallel4PointDsType::MODE_THINupdn);
 
-		threaded4PointDs.loopCreate(helper4PointDs);
+		threaded4PointDs.loopCreate(helper4PointDs, helper4PointDs.weights());
 
 		MatrixType mup(rows,cols);
 		MatrixType mdown(rows,cols);
@@ -1064,8 +1196,8 @@ private:
 		}
 
 		typedef typename ObserverType::Parallel4PointDsType Parallel4PointDsType;
-		typedef PsimagLite::Parallelizer<Parallel4PointDsType> ParallelizerType;
-		ParallelizerType threaded4PointDs(PsimagLite::Concurrency::codeSectionParams);
+		typedef ParallelizerPool<Parallel4PointDsType> ParallelizerType;
+		ParallelizerType threaded4PointDs(PsimagLite::Concurrency::codeSectionParams, "ObservableLibrary::ppFour");
 
 		Parallel4PointDsType helper4PointDs(m,
 		                                    observe_.fourpoint(),
@@ -1074,7 +1206,7 @@ private:
 		                                    pairs,
 		                                    Parallel4PointDsType::MODE_THIN);
 
-		threaded4PointDs.loopCreate(helper4PointDs);
+		threaded4PointDs.loopCreate(helper4PointDs, helper4PointDs.weights());
 
 		MatrixType mTriplet(rows,cols);
 		MatrixType mSinglet(rows,cols);
@@ -1129,7 +1261,8 @@ private:
 				storage = new MatrixType(rows,cols);
 			}
 
-			observe_.twoPoint(*storage,braket);
+			if (!cachedTwoPoint(*storage, braket.toString()))
+				observe_.twoPoint(*storage,braket);
 
 			if (needsPrinting) {
 				std::cout<<(*storage);
@@ -1211,6 +1344,7 @@ private:
 	const ModelType& model_; // not the owner
 	ObserverType observe_;
 	VectorMatrixType szsz_,sPlusSminus_,sMinusSplus_;
+	MapStringMatrixType twoPoints_;
 
 }; // class ObservableLibrary
 
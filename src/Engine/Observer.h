@@ -88,7 +88,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Parallel4PointDs.h"
 #include "MultiPointCorrelations.h"
 #include "Concurrency.h"
-#include "Parallelizer.h"
+#include "ParallelizerPool.h"
 #include "Utils.h"
 
 namespace Dmrg {
@@ -128,7 +128,9 @@ public:
 	              start,
 	              nf,
 	              trail,
-	              params.options.find("fixLegacyBugs") == PsimagLite::String::npos),
+	              params.options.find("fixLegacyBugs") == PsimagLite::String::npos,
+	              params.filename,
+	              params.options.find("mappedTransforms") != PsimagLite::String::npos),
 	      onepoint_(helper_),
 	      skeleton_(helper_, true),
 	      twopoint_(skeleton_),
@@ -211,6 +213,12 @@ public:
 		twopoint_(m, O1, O2, fermionicSign, bra, ket);
 	}
 
+	// many two-point correlations in one pass, see TwoPointCorrelations
+	void twoPoint(const typename TwoPointCorrelationsType::VectorRequestType& requests) const
+	{
+		twopoint_(requests);
+	}
+
 	void threePoint(const BraketType& braket,
 	                SizeType rows,
 	                SizeType cols)
@@ -340,20 +348,22 @@ public:
 			SizeType site1 = braket.site(1);
 			std::cout<<"Fixed site0= "<<site0<<"\n";
 			std::cout<<"Fixed site1= "<<site1<<"\n";
-			typename FourPointCorrelationsType::SparseMatrixType O2gt;
-			fourpoint_.firstStage(O2gt,'N',site0,'N',site1,braket,0,1);
+			typename FourPointCorrelationsType::SparseMatrixType O2grown;
+			fourpoint_.firstStage(O2grown,'N',site0,'N',site1,braket,0,1);
 
+			// the growth of the first stage is shared by all site2 and site3
+			SizeType grownTo = site1;
 			for (SizeType site2 = site1+1; site2 < rows; ++site2) {
+				fourpoint_.growTowards(O2grown, grownTo, site2, braket.op(1).fermionOrBoson);
 				for (SizeType site3 = site2+1; site3 < cols; ++site3) {
-					typename MatrixType::value_type tmp = fourpoint_.secondStage(O2gt,
-					                                                             site1,
-					                                                             'N',
-					                                                             site2,
-					                                                             'N',
-					                                                             site3,
-					                                                             braket,
-					                                                             2,
-					                                                             3);
+					typename MatrixType::value_type tmp = fourpoint_.secondStageGrown(O2grown,
+					                                                                  'N',
+					                                                                  site2,
+					                                                                  'N',
+					                                                                  site3,
+					                                                                  braket,
+					                                                                  2,
+					                                                                  3);
 					std::cout<<site2<<" "<<site3<<" "<<tmp<<"\n";
 				}
 			}
@@ -364,19 +374,20 @@ public:
 		assert(flag == 0);
 		for (SizeType site0 = 0; site0 < rows; ++site0) {
 			for (SizeType site1 = site0+1; site1 < cols; ++site1) {
+				typename FourPointCorrelationsType::SparseMatrixType O2grown;
+				fourpoint_.firstStage(O2grown,'N',site0,'N',site1,braket,0,1);
+				SizeType grownTo = site1;
 				for (SizeType site2 = site1+1; site2 < rows; ++site2) {
+					fourpoint_.growTowards(O2grown, grownTo, site2, braket.op(1).fermionOrBoson);
 					for (SizeType site3 = site2+1; site3 < cols; ++site3) {
-						typename FourPointCorrelationsType::SparseMatrixType O2gt;
-						fourpoint_.firstStage(O2gt,'N',site0,'N',site1,braket,0,1);
-						typename MatrixType::value_type tmp = fourpoint_.secondStage(O2gt,
-						                                                             site1,
-						                                                             'N',
-						                                                             site2,
-						                                                             'N',
-						                                                             site3,
-						                                                             braket,
-						                                                             2,
-						                                                             3);
+						typename MatrixType::value_type tmp = fourpoint_.secondStageGrown(O2grown,
+						                                                                  'N',
+						                                                                  site2,
+						                                                                  'N',
+						                                                                  site3,
+						                                                                  braket,
+						                                                                  2,
+						                                                                  3);
 						std::cout<<site0<<" "<<site1<<" ";
 						std::cout<<site2<<" "<<site3<<" "<<tmp<<"\n";
 					}
@@ -460,8 +471,8 @@ public:
 		}
 
 
-		typedef PsimagLite::Parallelizer<Parallel4PointDsType> ParallelizerType;
-		ParallelizerType threaded4PointDs(PsimagLite::Concurrency::codeSectionParams);
+		typedef ParallelizerPool<Parallel4PointDsType> ParallelizerType;
+		ParallelizerType threaded4PointDs(PsimagLite::Concurrency::codeSectionParams, "Observer::fourPointDeltas");
 
 		Parallel4PointDsType helper4PointDs(fpd,
 		                                    fourpoint_,
@@ -470,7 +481,7 @@ public:
 		                                    pairs,
 		                                    Parallel4PointDsType::MODE_NORMAL);
 
-		threaded4PointDs.loopCreate(helper4PointDs);
+		threaded4PointDs.loopCreate(helper4PointDs, helper4PointDs.weights());
 	}
 
 	template<typename ApplyOperatorType>
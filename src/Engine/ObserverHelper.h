@@ -85,6 +85,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "VectorWithOffsets.h" // to include norm
 #include "VectorWithOffset.h" // to include norm
 #include "GetBraOrKet.h"
+#include "MappedTransforms.h"
 
 namespace Dmrg {
 
@@ -114,18 +115,25 @@ public:
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef PsimagLite::Vector<short int>::Type VectorShortIntType;
 	typedef PsimagLite::GetBraOrKet GetBraOrKetType;
+	typedef MappedTransforms<typename DmrgSerializerType::BlockDiagonalMatrixType>
+	MappedTransformsType;
 
 	enum class SaveEnum {YES, NO};
 
+	// if mappedTransforms then the transforms are mapped from a flat file
+	// next to datafile, see MappedTransforms
 	ObserverHelper(IoInputType& io,
 	               SizeType start,
 	               SizeType nf,
 	               SizeType trail,
-	               bool withLegacyBugs)
+	               bool withLegacyBugs,
+	               PsimagLite::String datafile = "",
+	               bool mappedTransforms = false)
 	    : io_(io),
 	      withLegacyBugs_(withLegacyBugs),
 	      noMoreData_(false),
-	      numberOfSites_(0)
+	      numberOfSites_(0),
+	      mapped_((mappedTransforms) ? new MappedTransformsType(datafile, io) : 0)
 	{
 		typename BasisWithOperatorsType::VectorBoolType odds;
 		io_.read(odds, "OddElectronsOneSite");
@@ -154,6 +162,9 @@ public:
 			delete timeSerializerV_[i];
 			timeSerializerV_[i] = 0;
 		}
+
+		delete mapped_;
+		mapped_ = 0;
 	}
 
 	const SizeType& numberOfSites() const { return numberOfSites_; }
@@ -165,19 +176,24 @@ public:
 	               SizeType ind) const
 	{
 		checkIndex(ind);
+		if (mapped_)
+			return DmrgSerializerType::transform(ret, O2, (*mapped_)(serializerIndex_[ind]));
+
 		return dSerializerV_[ind]->transform(ret, O2);
 	}
 
 	SizeType cols(SizeType ind) const
 	{
 		checkIndex(ind);
-		return dSerializerV_[ind]->cols();
+		return (mapped_) ? (*mapped_)(serializerIndex_[ind]).cols() :
+		                   dSerializerV_[ind]->cols();
 	}
 
 	SizeType rows(SizeType ind) const
 	{
 		checkIndex(ind);
-		return dSerializerV_[ind]->rows();
+		return (mapped_) ? (*mapped_)(serializerIndex_[ind]).rows() :
+		                   dSerializerV_[ind]->rows();
 	}
 
 	short int signsOneSite(SizeType site) const
@@ -296,16 +312,19 @@ private:
 			DmrgSerializerType* dSerializer = new DmrgSerializerType(io_,
 			                                                         prefix + "/" + ttos(i),
 			                                                         false,
-			                                                         true);
+			                                                         true,
+			                                                         (mapped_ == 0));
 
 
 			SizeType tmp = dSerializer->leftRightSuper().sites();
 			if (tmp > 0 && numberOfSites_ == 0) numberOfSites_ = tmp;
 
-			if (saveOrNot == SaveEnum::YES)
+			if (saveOrNot == SaveEnum::YES) {
 				dSerializerV_.push_back(dSerializer);
-			else
+				serializerIndex_.push_back(i);
+			} else {
 				delete dSerializer;
+			}
 
 			try {
 				PsimagLite::String prefix("/TargetingCommon/" + ttos(i));
@@ -351,6 +370,8 @@ private:
 	bool noMoreData_;
 	VectorShortIntType signsOneSite_;
 	SizeType numberOfSites_;
+	MappedTransformsType* mapped_;
+	VectorSizeType serializerIndex_;
 };  // ObserverHelper
 } // namespace Dmrg
 
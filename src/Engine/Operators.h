@@ -84,7 +84,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "ProgressIndicator.h"
 #include "Complex.h"
 #include "Concurrency.h"
-#include "Parallelizer.h"
+#include "ParallelizerPool.h"
+#include "ExternalProductSmall.h"
 
 namespace Dmrg {
 /* PSIDOC Operators
@@ -311,8 +312,8 @@ public:
 	                 const BasisType* thisBasis,
 	                 const PairSizeSizeType& startEnd)
 	{
-		typedef PsimagLite::Parallelizer<MyLoop> ParallelizerType;
-		ParallelizerType threadObject(PsimagLite::Concurrency::codeSectionParams);
+		typedef ParallelizerPool<MyLoop> ParallelizerType;
+		ParallelizerType threadObject(PsimagLite::Concurrency::codeSectionParams, "Operators::changeBasis");
 
 		MyLoop helper(reducedOpImpl_,operators_,ftransform,thisBasis,startEnd);
 
@@ -382,7 +383,7 @@ public:
 	                     ApplyFactorsType& apply)
 	{
 		assert(!BasisType::useSu2Symmetry());
-		PsimagLite::externalProduct(operators_[i].data,m.data,x,fermionicSigns,option);
+		externalProductSmall(operators_[i].data,m.data,x,fermionicSigns,option);
 		// don't forget to set fermion sign and j:
 		operators_[i].fermionOrBoson=m.fermionOrBoson;
 		operators_[i].jm=m.jm;
@@ -407,9 +408,9 @@ public:
 		SparseMatrixType tmpMatrix;
 		assert(h2.rows()==h2.cols());
 		VectorRealType ones(h2.rows(),1.0);
-		PsimagLite::externalProduct(hamiltonian_,h2,h3.rows(),ones,true);
+		externalProductSmall(hamiltonian_,h2,h3.rows(),ones,true);
 
-		PsimagLite::externalProduct(tmpMatrix,h3,h2.rows(),ones,false);
+		externalProductSmall(tmpMatrix,h3,h2.rows(),ones,false);
 
 		hamiltonian_ += tmpMatrix;
 
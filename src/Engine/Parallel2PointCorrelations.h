@@ -91,54 +91,51 @@ public:
 
 	typedef typename TwoPointCorrelationsType::MatrixType MatrixType;
 	typedef typename TwoPointCorrelationsType::SparseMatrixType SparseMatrixType;
+	typedef typename TwoPointCorrelationsType::VectorRequestType VectorRequestType;
 	typedef typename MatrixType::value_type FieldType;
 	typedef PsimagLite::Concurrency ConcurrencyType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename PsimagLite::Vector<VectorSizeType>::Type VectorVectorSizeType;
 	typedef std::pair<SizeType,SizeType> PairType;
 	typedef typename PsimagLite::Real<FieldType>::Type RealType;
 
-	Parallel2PointCorrelations(MatrixType& w,
-	                           const TwoPointCorrelationsType& twopoint,
-	                           const typename PsimagLite::Vector<PairType>::Type& pairs,
-	                           const SparseMatrixType& O1,
-	                           const SparseMatrixType& O2,
-	                           ProgramGlobals::FermionOrBosonEnum fermionicSign,
-	                           PsimagLite::String bra,
-	                           PsimagLite::String ket)
-	    : w_(w),
-	      twopoint_(twopoint),
-	      pairs_(pairs),
-	      O1_(O1),
-	      O2_(O2),
-	      fermionicSign_(fermionicSign),
-	      bra_(bra),
-	      ket_(ket)
-	{}
+	// one task per row of each group of requests
+	Parallel2PointCorrelations(const TwoPointCorrelationsType& twopoint,
+	                           const VectorRequestType& requests,
+	                           const VectorVectorSizeType& groups)
+	    : twopoint_(twopoint),
+	      requests_(requests),
+	      groups_(groups)
+	{
+		for (SizeType g = 0; g < groups_.size(); ++g) {
+			const MatrixType& w = *requests_[groups_[g][0]].w;
+			for (SizeType i = 0; i < w.n_row(); ++i) {
+				tasks_.push_back(PairType(g, i));
+				// row i has cols - i entries
+				const SizeType cols = w.n_col();
+				weights_.push_back(groups_[g].size()*((cols > i) ? cols - i : 0));
+			}
+		}
+	}
 
 	void doTask(SizeType taskNumber, SizeType)
 	{
-		SizeType i = pairs_[taskNumber].first;
-		SizeType j = pairs_[taskNumber].second;
-		w_(i,j) = twopoint_.calcCorrelation(i,
-		                                    j,
-		                                    O1_,
-		                                    O2_,
-		                                    fermionicSign_,
-		                                    bra_,
-		                                    ket_);
+		assert(taskNumber < tasks_.size());
+		const PairType& task = tasks_[taskNumber];
+		twopoint_.calcRow(requests_, groups_[task.first], task.second);
 	}
 
-	SizeType tasks() const { return pairs_.size(); }
+	SizeType tasks() const { return tasks_.size(); }
+
+	const VectorSizeType& weights() const { return weights_; }
 
 private:
 
-	MatrixType& w_;
 	const TwoPointCorrelationsType& twopoint_;
-	const typename PsimagLite::Vector<PairType>::Type& pairs_;
-	const SparseMatrixType& O1_;
-	const SparseMatrixType& O2_;
-	const ProgramGlobals::FermionOrBosonEnum fermionicSign_;
-	const PsimagLite::String bra_;
-	const PsimagLite::String ket_;
+	const VectorRequestType& requests_;
+	const VectorVectorSizeType& groups_;
+	typename PsimagLite::Vector<PairType>::Type tasks_;
+	VectorSizeType weights_;
 }; // class Parallel2PointCorrelations
 } // namespace Dmrg 
 
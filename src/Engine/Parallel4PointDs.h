@@ -79,6 +79,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Matrix.h"
 #include "Mpi.h"
 #include "Concurrency.h"
+#include <algorithm>
 
 namespace Dmrg {
 
@@ -91,6 +92,8 @@ class Parallel4PointDs {
 	typedef typename MatrixType::value_type FieldType;
 	typedef typename FourPointCorrelationsType::SparseMatrixType SparseMatrixType;
 	typedef PsimagLite::Concurrency ConcurrencyType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename PsimagLite::Vector<VectorSizeType>::Type VectorVectorSizeType;
 
 public:
 
@@ -110,33 +113,102 @@ public:
 	      gammas_(gammas),
 	      pairs_(pairs),
 	      mode_(mode)
-	{}
+	{
+		// The pairs of a row i share the first two sites and operators,
+		// and thus the first stage, so each row is one task,
+		// with its pairs ordered by third site; see FourPointCorrelations::growTowards
+		VectorSizeType taskOfRow;
+		VectorSizeType thirdSite(pairs_.size());
+		VectorSizeType sites(4);
+		for (SizeType p = 0; p < pairs_.size(); ++p) {
+			const SizeType i = pairs_[p].first;
+			quadruple(sites, i, pairs_[p].second);
+			thirdSite[p] = sites[2];
+			if (i >= taskOfRow.size())
+				taskOfRow.resize(i + 1, pairs_.size());
+
+			if (taskOfRow[i] == pairs_.size()) {
+				taskOfRow[i] = rows_.size();
+				rows_.push_back(VectorSizeType());
+			}
+
+			rows_[taskOfRow[i]].push_back(p);
+		}
+
+		for (SizeType t = 0; t < rows_.size(); ++t) {
+			VectorSizeType& row = rows_[t];
+			std::stable_sort(row.begin(),
+			                 row.end(),
+			                 [&thirdSite](SizeType a, SizeType b)
+			{ return thirdSite[a] < thirdSite[b]; });
+			weights_.push_back(row.size());
+		}
+	}
 
 	void doTask(SizeType taskNumber, SizeType)
 	{
-		SizeType i = pairs_[taskNumber].first;
-		SizeType j = pairs_[taskNumber].second;
-
-		fpd_(i,j) = (mode_ == MODE_NORMAL) ? fourPointDelta(2*i, 2*j, gammas_)
-		                                   : fourPointThin(i, j);
-		if (mode_ == MODE_NORMAL) {
-			fpd_(i,j) = fourPointDelta(2*i,2*j,gammas_);
-		} else if (mode_ == MODE_THIN) {
-			fpd_(i,j) = fourPointThin(i, j);
-		} else if (mode_ == MODE_THINupdn) {
-			fpd_(i,j) = fourPointThinupdn(i, j);
-		} else {
-			throw PsimagLite::RuntimeError("Parallel4PointDs: No matching mode_ found \n");
+		assert(taskNumber < rows_.size());
+		const VectorSizeType& row = rows_[taskNumber];
+		VectorSizeType sites(4);
+		VectorSizeType prevSites;
+		PsimagLite::String prevOps;
+		SparseMatrixType O2grown;
+		SizeType grownTo = 0;
+		for (SizeType k = 0; k < row.size(); ++k) {
+			const SizeType i = pairs_[row[k]].first;
+			const SizeType j = pairs_[row[k]].second;
+			BraketType braket(model_, quadruple(sites, i, j));
+			FourPointCorrelationsType::checkFourPoint(sites[0], sites[1], sites[2], sites[3]);
+
+			// the first stage is redone only if the prefix changes
+			const PsimagLite::String ops = braket.opName(0) + ";" + braket.opName(1);
+			const bool samePrefix = (k > 0 &&
+			                         sites[0] == prevSites[0] &&
+			                         sites[1] == prevSites[1] &&
+			                         ops == prevOps &&
+			                         sites[2] > grownTo);
+			if (!samePrefix) {
+				fourpoint_.firstStage(O2grown, 'N', sites[0], 'N', sites[1], braket, 0, 1);
+				grownTo = sites[1];
+				prevSites = sites;
+				prevOps = ops;
+			}
+
+			fourpoint_.growTowards(O2grown, grownTo, sites[2], braket.op(1).fermionOrBoson);
+			fpd_(i,j) = fourpoint_.secondStageGrown(O2grown,
+			                                        'C',
+			                                        sites[2],
+			                                        'C',
+			                                        sites[3],
+			                                        braket,
+			                                        2,
+			                                        3);
 		}
 	}
 
-	SizeType tasks() const { return pairs_.size(); }
+	SizeType tasks() const { return rows_.size(); }
+
+	const VectorSizeType& weights() const { return weights_; }
 
 private:
 
-	FieldType fourPointDelta(SizeType i,
-	                         SizeType j,
-	                         const typename PsimagLite::Vector<SizeType>::Type& gammas) const
+	// sites of the quadruple of pair (i, j), and the braket to use
+	PsimagLite::String quadruple(VectorSizeType& sites, SizeType i, SizeType j) const
+	{
+		if (mode_ == MODE_NORMAL)
+			return fourPointDelta(sites, 2*i, 2*j, gammas_);
+		else if (mode_ == MODE_THIN)
+			return fourPointThin(sites, i, j);
+		else if (mode_ == MODE_THINupdn)
+			return fourPointThinupdn(sites, i, j);
+
+		throw PsimagLite::RuntimeError("Parallel4PointDs: No matching mode_ found \n");
+	}
+
+	PsimagLite::String fourPointDelta(VectorSizeType& sites,
+	                                  SizeType i,
+	                                  SizeType j,
+	                                  const typename PsimagLite::Vector<SizeType>::Type& gammas) const
 	{
 		SizeType hs = model_.hilbertSize(0);
 		SizeType nx = 0;
@@ -163,11 +235,11 @@ private:
 		str += "<gs|c[" + ttos(site) + "]?" + ttos(gammas[3] + 0*nx) + "|gs>";
 		//const SparseMatrixType& opC3 = model.naturalOperator("c",site,gammas[3] + 0*nx).data;
 
-		BraketType braket(model_, str);
-		return fourpoint_(i,i+1,j,j+1,braket);
+		setSites(sites, i, i + 1, j, j + 1);
+		return str;
 	}
 
-	FieldType fourPointThin(SizeType i, SizeType j) const
+	PsimagLite::String fourPointThin(VectorSizeType& sites, SizeType i, SizeType j) const
 	{
 		SizeType number1 = fpd_.n_row()/2;
 		SizeType spin0 = i/number1;
@@ -206,12 +278,11 @@ private:
 //		FieldType fourval = fourpoint_(thini1,thini2,thinj1,thinj2,braket);
 //		return signTerm*fourval;
 
-		BraketType braket(model_, str);
-		FieldType fourval = fourpoint_(thini1,thini2,thinj1,thinj2,braket);
-		return fourval;
+		setSites(sites, thini1, thini2, thinj1, thinj2);
+		return str;
 	}
 
-	FieldType fourPointThinupdn(SizeType i, SizeType j) const
+	PsimagLite::String fourPointThinupdn(VectorSizeType& sites, SizeType i, SizeType j) const
 	{
 		SizeType number1 = fpd_.n_row()/2;
 		SizeType spin0 = i/number1;
@@ -240,9 +311,21 @@ private:
 		// c(i3,orb1,spin1)
 		str += "c?"+ ttos(spin1) + "[" + ttos(site) + "]|gs>";
 
-		BraketType braket(model_, str);
-		FieldType fourval = fourpoint_(thini1,thini2,thinj1,thinj2,braket);
-		return fourval;
+		setSites(sites, thini1, thini2, thinj1, thinj2);
+		return str;
+	}
+
+	static void setSites(VectorSizeType& sites,
+	                     SizeType i1,
+	                     SizeType i2,
+	                     SizeType i3,
+	                     SizeType i4)
+	{
+		assert(sites.size() == 4);
+		sites[0] = i1;
+		sites[1] = i2;
+		sites[2] = i3;
+		sites[3] = i4;
 	}
 
 	MatrixType& fpd_;
@@ -251,6 +334,8 @@ private:
 	const typename PsimagLite::Vector<SizeType>::Type& gammas_;
 	const typename PsimagLite::Vector<PairType>::Type& pairs_;
 	const FourPointModeEnum mode_;
+	VectorVectorSizeType rows_;
+	VectorSizeType weights_;
 }; // class Parallel4PointDs
 } // namespace Dmrg
 
@@ -63,14 +63,14 @@ public:
 
 	void sync()
 	{
-		SizeType total = 0;
-		for (SizeType threadNum = 0; threadNum < xtemp_.size(); threadNum++)
-			if (xtemp_[threadNum].size() == x_.size()) total++;
-
+		// a thread might have had no tasks (e.g., they were all stolen),
+		// so do not assume that the threads used are contiguous
 		typename PsimagLite::Vector<ComplexOrRealType>::Type x(x_.size(),0);
-		for (SizeType threadNum = 0; threadNum < total; threadNum++)
+		for (SizeType threadNum = 0; threadNum < xtemp_.size(); threadNum++) {
+			if (xtemp_[threadNum].size() != x_.size()) continue;
 			for (SizeType i=0;i<x_.size();i++)
 				x[i]+=xtemp_[threadNum][i];
+		}
 
 		if (!ConcurrencyType::isMpiDisabled("HamiltonianConnection"))
 			PsimagLite::MPI::allReduce(x);
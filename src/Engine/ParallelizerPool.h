@@ -0,0 +1,487 @@
+#ifndef PARALLELIZER_POOL_H
+#define PARALLELIZER_POOL_H
+#include "Vector.h"
+#include "PsimagLite.h"
+#include "Concurrency.h"
+#include "Parallelizer.h"
+#include "NumaFirstTouch.h"
+#include <map>
+#include <deque>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <memory>
+#ifdef USE_PTHREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#endif
+
+// Engine-wide persistent thread pool
+// Threads are created once (on first use) and reused by every call site
+// Each participant owns a deque of task ranges; when its deque is empty
+// it steals ranges from the back of the other deques, except in stable loops.
+// Calls made from inside a pool task (nested parallelism), or while another
+// loop owns the pool, run serially in the calling thread.
+// Enabled with SolverOptions=threadPool; otherwise ParallelizerPool
+// forwards to PsimagLite::Parallelizer
+namespace Dmrg {
+
+class ThreadPoolEngine {
+
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef std::chrono::steady_clock ClockType;
+
+	struct SiteStats {
+
+		SiteStats()
+		    : calls(0),
+		      serialCalls(0),
+		      tasks(0),
+		      steals(0),
+		      imbalanceSum(0),
+		      idleSeconds(0),
+		      wallSeconds(0)
+		{}
+
+		SizeType calls;
+		SizeType serialCalls;
+		SizeType tasks;
+		SizeType steals;
+		double imbalanceSum;
+		double idleSeconds;
+		double wallSeconds;
+	};
+
+	typedef std::map<PsimagLite::String, SiteStats> MapStringStatsType;
+
+public:
+
+	typedef std::function<void(SizeType, SizeType)> TaskFunctionType;
+
+	// With setAffinities each participant is pinned to one cpu, the caller
+	// to the first, so that the placement of pages (see NumaFirstTouch)
+	// stays valid from one loop to the next
+	static void init(SizeType nthreads, bool enabled, bool setAffinities = false)
+	{
+		ThreadPoolEngine& p = instance();
+		p.enabled_ = enabled;
+		p.nthreads_ = (nthreads == 0) ? 1 : nthreads;
+		p.setAffinities_ = setAffinities;
+		if (enabled && setAffinities && p.nthreads_ > 1)
+			NumaFirstTouch::pinThisThread(0);
+	}
+
+	static bool enabled() { return instance().enabled_; }
+
+	static SizeType threads() { return instance().nthreads_; }
+
+	// Runs f(task, thread) for task in [0, tasks) using at most
+	// maxThreads participants; weights, if not empty, has one entry per task
+	// If stable, there is no stealing, so that for the same tasks and
+	// weights each task always runs on the same thread
+	static void run(const TaskFunctionType& f,
+	                SizeType tasks,
+	                SizeType maxThreads,
+	                const VectorSizeType& weights,
+	                PsimagLite::String site,
+	                bool stable = false)
+	{
+		instance().runInternal(f, tasks, maxThreads, weights, site, stable);
+	}
+
+	static void printStats(std::ostream& os)
+	{
+		const ThreadPoolEngine& p = instance();
+		if (!p.enabled_ || p.stats_.size() == 0) return;
+
+		os<<"ThreadPoolEngine: threads="<<p.nthreads_<<"\n";
+		os<<"site calls serialCalls tasks steals avgImbalance idle(s) wall(s)\n";
+		MapStringStatsType::const_iterator it = p.stats_.begin();
+		for (; it != p.stats_.end(); ++it) {
+			const SiteStats& s = it->second;
+			SizeType parallelCalls = s.calls - s.serialCalls;
+			double avgImbalance = (parallelCalls > 0) ? s.imbalanceSum/parallelCalls : 1.0;
+			os<<it->first<<" "<<s.calls<<" "<<s.serialCalls<<" "<<s.tasks<<" ";
+			os<<s.steals<<" "<<avgImbalance<<" "<<s.idleSeconds<<" ";
+			os<<s.wallSeconds<<"\n";
+		}
+	}
+
+	~ThreadPoolEngine()
+	{
+#ifdef USE_PTHREADS
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			shutdown_ = true;
+			++generation_;
+		}
+
+		cvWork_.notify_all();
+		for (SizeType i = 0; i < workers_.size(); ++i)
+			workers_[i].join();
+#endif
+	}
+
+private:
+
+	ThreadPoolEngine()
+	    : enabled_(false),
+	      nthreads_(1),
+	      setAffinities_(false)
+#ifdef USE_PTHREADS
+	    ,
+	      shutdown_(false),
+	      generation_(0),
+	      participants_(0),
+	      pending_(0),
+	      stealing_(true),
+	      steals_(0),
+	      function_(0)
+#endif
+	{}
+
+	ThreadPoolEngine(const ThreadPoolEngine&);
+
+	ThreadPoolEngine& operator=(const ThreadPoolEngine&);
+
+	static ThreadPoolEngine& instance()
+	{
+		static ThreadPoolEngine pool;
+		return pool;
+	}
+
+	void runSerially(const TaskFunctionType& f, SizeType tasks)
+	{
+		for (SizeType i = 0; i < tasks; ++i)
+			f(i, 0);
+	}
+
+	void addStats(PsimagLite::String site,
+	              SizeType tasks,
+	              bool serial,
+	              SizeType steals,
+	              const std::vector<double>& busy,
+	              double wall)
+	{
+		SiteStats& s = stats_[site];
+		++s.calls;
+		s.tasks += tasks;
+		s.wallSeconds += wall;
+		if (serial) {
+			++s.serialCalls;
+			return;
+		}
+
+		s.steals += steals;
+		double maxBusy = 0;
+		double sumBusy = 0;
+		for (SizeType i = 0; i < busy.size(); ++i) {
+			maxBusy = std::max(maxBusy, busy[i]);
+			sumBusy += busy[i];
+			s.idleSeconds += (wall > busy[i]) ? wall - busy[i] : 0;
+		}
+
+		double avg = sumBusy/busy.size();
+		s.imbalanceSum += (avg > 0) ? maxBusy/avg : 1.0;
+	}
+
+#ifndef USE_PTHREADS
+
+	void runInternal(const TaskFunctionType& f,
+	                 SizeType tasks,
+	                 SizeType,
+	                 const VectorSizeType&,
+	                 PsimagLite::String site,
+	                 bool)
+	{
+		ClockType::time_point t0 = ClockType::now();
+		runSerially(f, tasks);
+		std::chrono::duration<double> wall = ClockType::now() - t0;
+		addStats(site, tasks, true, 0, std::vector<double>(), wall.count());
+	}
+
+#else
+
+	struct Range {
+
+		Range(SizeType b, SizeType e) : begin(b), end(e) {}
+
+		SizeType begin;
+		SizeType end;
+	};
+
+	struct WorkQueue {
+
+		std::mutex mutex;
+		std::deque<Range> ranges;
+	};
+
+	static bool& insidePool()
+	{
+		static thread_local bool inside = false;
+		return inside;
+	}
+
+	void runInternal(const TaskFunctionType& f,
+	                 SizeType tasks,
+	                 SizeType maxThreads,
+	                 const VectorSizeType& weights,
+	                 PsimagLite::String site,
+	                 bool stable)
+	{
+		ClockType::time_point t0 = ClockType::now();
+		SizeType participants = std::min(std::min(maxThreads, nthreads_), tasks);
+
+		std::unique_lock<std::mutex> owner(ownerMutex_, std::defer_lock);
+		const bool serial = (participants < 2 || insidePool() || !owner.try_lock());
+		if (serial) {
+			bool saved = insidePool();
+			insidePool() = true;
+			runSerially(f, tasks);
+			insidePool() = saved;
+			std::chrono::duration<double> wall = ClockType::now() - t0;
+			addStatsLocked(site, tasks, true, 0, std::vector<double>(), wall.count());
+			return;
+		}
+
+		startWorkers();
+		distribute(tasks, participants, weights);
+
+		busy_.assign(participants, 0.0);
+		steals_ = 0;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			function_ = &f;
+			participants_ = participants;
+			stealing_ = !stable;
+			pending_ = participants - 1;
+			++generation_;
+		}
+
+		cvWork_.notify_all();
+
+		work(0);
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			cvDone_.wait(lock, [this]{ return pending_ == 0; });
+			function_ = 0;
+		}
+
+		std::chrono::duration<double> wall = ClockType::now() - t0;
+		addStatsLocked(site, tasks, false, steals_, busy_, wall.count());
+	}
+
+	void addStatsLocked(PsimagLite::String site,
+	                    SizeType tasks,
+	                    bool serial,
+	                    SizeType steals,
+	                    const std::vector<double>& busy,
+	                    double wall)
+	{
+		std::unique_lock<std::mutex> lock(statsMutex_);
+		addStats(site, tasks, serial, steals, busy, wall);
+	}
+
+	void startWorkers()
+	{
+		if (workers_.size() + 1 >= nthreads_) return;
+
+		queues_.resize(nthreads_);
+		for (SizeType i = 0; i < nthreads_; ++i)
+			if (!queues_[i]) queues_[i].reset(new WorkQueue());
+
+		for (SizeType i = workers_.size() + 1; i < nthreads_; ++i)
+			workers_.push_back(std::thread(&ThreadPoolEngine::workerLoop, this, i));
+	}
+
+	// Contiguous blocks of ranges per participant if there are no weights;
+	// longest-processing-time-first assignment of single tasks otherwise
+	void distribute(SizeType tasks, SizeType participants, const VectorSizeType& weights)
+	{
+		for (SizeType i = 0; i < participants; ++i)
+			queues_[i]->ranges.clear();
+
+		if (weights.size() != tasks) {
+			SizeType chunk = std::max(static_cast<SizeType>(1), tasks/(4*participants));
+			SizeType perThread = (tasks + participants - 1)/participants;
+			for (SizeType t = 0; t < participants; ++t) {
+				SizeType begin = t*perThread;
+				SizeType end = std::min(tasks, begin + perThread);
+				for (SizeType b = begin; b < end; b += chunk)
+					queues_[t]->ranges.push_back(Range(b, std::min(end, b + chunk)));
+			}
+
+			return;
+		}
+
+		VectorSizeType perm(tasks);
+		for (SizeType i = 0; i < tasks; ++i) perm[i] = i;
+		std::stable_sort(perm.begin(),
+		                 perm.end(),
+		                 [&weights](SizeType a, SizeType b)
+		{ return weights[a] > weights[b]; });
+
+		VectorSizeType load(participants, 0);
+		for (SizeType i = 0; i < tasks; ++i) {
+			SizeType task = perm[i];
+			SizeType t = std::min_element(load.begin(), load.end()) - load.begin();
+			load[t] += weights[task] + 1;
+			queues_[t]->ranges.push_back(Range(task, task + 1));
+		}
+	}
+
+	void workerLoop(SizeType threadNum)
+	{
+		if (setAffinities_) NumaFirstTouch::pinThisThread(threadNum);
+		insidePool() = true;
+		SizeType seen = 0;
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				cvWork_.wait(lock, [this, &seen]{ return generation_ != seen; });
+				seen = generation_;
+				if (shutdown_) return;
+				if (threadNum >= participants_) continue;
+			}
+
+			work(threadNum);
+
+			std::unique_lock<std::mutex> lock(mutex_);
+			if (--pending_ == 0) cvDone_.notify_one();
+		}
+	}
+
+	void work(SizeType threadNum)
+	{
+		bool saved = insidePool();
+		insidePool() = true;
+		ClockType::time_point t0 = ClockType::now();
+		Range range(0, 0);
+		while (popOrSteal(range, threadNum)) {
+			for (SizeType i = range.begin; i < range.end; ++i)
+				(*function_)(i, threadNum);
+		}
+
+		std::chrono::duration<double> busy = ClockType::now() - t0;
+		busy_[threadNum] = busy.count();
+		insidePool() = saved;
+	}
+
+	bool popOrSteal(Range& range, SizeType threadNum)
+	{
+		{
+			WorkQueue& q = *queues_[threadNum];
+			std::unique_lock<std::mutex> lock(q.mutex);
+			if (!q.ranges.empty()) {
+				range = q.ranges.front();
+				q.ranges.pop_front();
+				return true;
+			}
+		}
+
+		if (!stealing_) return false;
+
+		for (SizeType k = 1; k < participants_; ++k) {
+			WorkQueue& q = *queues_[(threadNum + k) % participants_];
+			std::unique_lock<std::mutex> lock(q.mutex);
+			if (q.ranges.empty()) continue;
+			range = q.ranges.back();
+			q.ranges.pop_back();
+			++steals_;
+			return true;
+		}
+
+		return false;
+	}
+
+#endif
+
+	bool enabled_;
+	SizeType nthreads_;
+	bool setAffinities_;
+	MapStringStatsType stats_;
+#ifdef USE_PTHREADS
+	bool shutdown_;
+	SizeType generation_;
+	SizeType participants_;
+	SizeType pending_;
+	bool stealing_;
+	std::atomic<SizeType> steals_;
+	const TaskFunctionType* function_;
+	std::vector<double> busy_;
+	std::vector<std::thread> workers_;
+	std::vector<std::unique_ptr<WorkQueue> > queues_;
+	std::mutex mutex_;
+	std::mutex ownerMutex_;
+	std::mutex statsMutex_;
+	std::condition_variable cvWork_;
+	std::condition_variable cvDone_;
+#endif
+};
+
+// Drop-in replacement for PsimagLite::Parallelizer<LambdaType>
+// site names the call site for the statistics
+template<typename LambdaType>
+class ParallelizerPool {
+
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef PsimagLite::Parallelizer<LambdaType> ParallelizerType;
+
+public:
+
+	// stable asks the pool for a schedule without stealing, see
+	// ThreadPoolEngine::run; PsimagLite::Parallelizer ignores it
+	ParallelizerPool(const PsimagLite::CodeSectionParams& codeSectionParams,
+	                 PsimagLite::String site,
+	                 bool stable = false)
+	    : codeSectionParams_(codeSectionParams),
+	      site_(site),
+	      stable_(stable)
+	{}
+
+	void loopCreate(LambdaType& lambda)
+	{
+		loopCreate(lambda, VectorSizeType());
+	}
+
+	void loopCreate(LambdaType& lambda, const VectorSizeType& weights)
+	{
+		if (!ThreadPoolEngine::enabled()) {
+			ParallelizerType parallelizer(codeSectionParams_);
+			if (weights.size() == 0)
+				parallelizer.loopCreate(lambda);
+			else
+				parallelizer.loopCreate(lambda, weights);
+			return;
+		}
+
+		ThreadPoolEngine::TaskFunctionType f = [&lambda](SizeType task,
+		        SizeType threadNum)
+		{ lambda.doTask(task, threadNum); };
+
+		ThreadPoolEngine::run(f,
+		                      lambda.tasks(),
+		                      codeSectionParams_.npthreads,
+		                      weights,
+		                      site_,
+		                      stable_);
+	}
+
+	SizeType numberOfThreads() const
+	{
+		return codeSectionParams_.npthreads;
+	}
+
+	PsimagLite::String name() const { return "ParallelizerPool"; }
+
+private:
+
+	PsimagLite::CodeSectionParams codeSectionParams_;
+	PsimagLite::String site_;
+	bool stable_;
+};
+}
+#endif // PARALLELIZER_POOL_H
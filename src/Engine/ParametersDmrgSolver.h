@@ -151,6 +151,7 @@ struct ParametersDmrgSolver {
 	SizeType dumperBegin;
 	SizeType dumperEnd;
 	SizeType precision;
+	SizeType mettsChains;
 	int useReflectionSymmetry;
 	bool autoRestart;
 	PairRealSizeType truncationControl;
@@ -159,6 +160,7 @@ struct ParametersDmrgSolver {
 	PsimagLite::String options;
 	PsimagLite::String model;
 	PsimagLite::String insitu;
+	PsimagLite::String insituCorrelations;
 	PsimagLite::String fileForDensityMatrixEigs;
 	PsimagLite::String recoverySave;
 	RestartStruct checkpoint;
@@ -166,6 +168,7 @@ struct ParametersDmrgSolver {
 	VectorFiniteLoopType finiteLoop;
 	FieldType degeneracyMax;
 	FieldType denseSparseThreshold;
+	VectorFieldType densityMatrixPerturbation;
 
 	void write(PsimagLite::String label,
 	           PsimagLite::IoSerializer& ioSerializer) const
@@ -182,6 +185,7 @@ struct ParametersDmrgSolver {
 		ioSerializer.write(root + "/dumperBegin", dumperBegin);
 		ioSerializer.write(root + "/dumperEnd", dumperEnd);
 		ioSerializer.write(root + "/precision", precision);
+		ioSerializer.write(root + "/mettsChains", mettsChains);
 		ioSerializer.write(root + "/useReflectionSymmetry", useReflectionSymmetry);
 		ioSerializer.write(root + "/truncationControl", truncationControl);
 		ioSerializer.write(root + "/filename", filename);
@@ -189,6 +193,7 @@ struct ParametersDmrgSolver {
 		ioSerializer.write(root + "/options", options);
 		ioSerializer.write(root + "/model", model);
 		ioSerializer.write(root + "/insitu", insitu);
+		ioSerializer.write(root + "/insituCorrelations", insituCorrelations);
 		ioSerializer.write(root + "/fileForDensityMatrixEigs", fileForDensityMatrixEigs);
 		ioSerializer.write(root + "/recoverySave", recoverySave);
 		checkpoint.write(label + "/checkpoint", ioSerializer);
@@ -196,6 +201,7 @@ struct ParametersDmrgSolver {
 		ioSerializer.write(root + "/finiteLoop", finiteLoop);
 		ioSerializer.write(root + "/degeneracyMax", degeneracyMax);
 		ioSerializer.write(root + "/denseSparseThreshold", denseSparseThreshold);
+		ioSerializer.write(root + "/densityMatrixPerturbation", densityMatrixPerturbation);
 	}
 
 	template<typename SomeMemResolvType>
@@ -218,6 +224,7 @@ struct ParametersDmrgSolver {
 	      dumperBegin(0),
 	      dumperEnd(0),
 	      precision(6),
+	      mettsChains(1),
 	      autoRestart(false),
 	      recoverySave("no"),
 	      adjustQuantumNumbers(0, QnType(false, VectorSizeType(), PairSizeType(0, 0), 0)),
@@ -309,6 +316,11 @@ struct ParametersDmrgSolver {
 			io.readline(insitu,"insitu=");
 		} catch (std::exception&) {}
 
+		insituCorrelations = "";
+		try {
+			io.readline(insituCorrelations,"InSituCorrelations=");
+		} catch (std::exception&) {}
+
 		try {
 			io.readline(sitesPerBlock,"SitesPerBlock=");
 		} catch (std::exception&) {}
@@ -357,6 +369,17 @@ struct ParametersDmrgSolver {
 			io.readline(denseSparseThreshold, "DenseSparseThreshold=");
 		} catch (std::exception&) {}
 
+		try {
+			PsimagLite::String s("");
+			VectorStringType tokens;
+			io.readline(s, "DensityMatrixPerturbation=");
+			PsimagLite::split(tokens, s, ",");
+			for (SizeType i = 0; i < tokens.size(); ++i)
+				densityMatrixPerturbation.push_back(atof(tokens[i].c_str()));
+		} catch (std::exception&) {}
+
+		checkDensityMatrixPerturbation();
+
 		if (isObserveCode) return;
 		bool hasRestart = false;
 		PsimagLite::String restartFrom;
@@ -431,6 +454,38 @@ struct ParametersDmrgSolver {
 		if (hasRestart) {
 			checkpoint.read(io);
 		}
+
+		try {
+			io.readline(mettsChains, "MettsChains=");
+		} catch (std::exception&) {}
+
+		if (mettsChains == 0)
+			err("FATAL: MettsChains= must be positive\n");
+
+		if (mettsChains > 1) {
+			if (options.find("MettsTargeting") == PsimagLite::String::npos)
+				err("FATAL: MettsChains= needs MettsTargeting in SolverOptions\n");
+			if (options.find("restart") != PsimagLite::String::npos || recoverySave != "no")
+				err("FATAL: MettsChains= cannot be used with restart or RecoverySave\n");
+
+			// the chains run concurrently and do not write to files
+			const char* noChains[] = {"shrinkStacksOnDisk",
+			                          "asyncWrite",
+			                          "saveDensityMatrixEigenvalues"};
+			for (SizeType i = 0; i < 3; ++i)
+				if (options.find(noChains[i]) != PsimagLite::String::npos)
+					err("FATAL: MettsChains= cannot be used with " +
+					    PsimagLite::String(noChains[i]) + "\n");
+		}
+	}
+
+	// DensityMatrixPerturbation of finite loop loopIndex; the last value
+	// given applies to all remaining loops
+	FieldType densityMatrixPerturbationOf(SizeType loopIndex) const
+	{
+		const SizeType n = densityMatrixPerturbation.size();
+		if (n == 0) return 0;
+		return densityMatrixPerturbation[(loopIndex < n) ? loopIndex : n - 1];
 	}
 
 	template<typename SomeInputType>
@@ -571,6 +626,8 @@ struct ParametersDmrgSolver {
 		os<<p.finiteLoop;
 
 		os<<"RecoverySave="<<p.recoverySave<<"\n";
+		if (p.insituCorrelations != "")
+			os<<"parameters.insituCorrelations="<<p.insituCorrelations<<"\n";
 
 		if (p.truncationControl.first > 0) {
 			os<<"parameters.tolerance="<<p.truncationControl.first<<",";
@@ -579,6 +636,16 @@ struct ParametersDmrgSolver {
 
 		os<<"parameters.degeneracyMax="<<p.degeneracyMax<<"\n";
 		os<<"parameters.denseSparseThreshold="<<p.denseSparseThreshold<<"\n";
+		if (p.densityMatrixPerturbation.size() > 0) {
+			os<<"parameters.densityMatrixPerturbation=";
+			for (SizeType i = 0; i < p.densityMatrixPerturbation.size(); ++i)
+				os<<((i > 0) ? "," : "")<<p.densityMatrixPerturbation[i];
+			os<<"\n";
+		}
+
+		if (p.mettsChains > 1)
+			os<<"parameters.mettsChains="<<p.mettsChains<<"\n";
+
 		os<<"parameters.nthreads="<<p.nthreads<<"\n";
 		os<<"parameters.useReflectionSymmetry="<<p.useReflectionSymmetry<<"\n";
 		os<<p.checkpoint;
@@ -612,6 +679,37 @@ private:
 		}
 	}
 
+	void checkDensityMatrixPerturbation() const
+	{
+		const SizeType n = densityMatrixPerturbation.size();
+		if (n == 0) return;
+
+		if (n > finiteLoop.size())
+			err("FATAL: DensityMatrixPerturbation= has more values than FiniteLoops\n");
+
+		bool nonZero = false;
+		for (SizeType i = 0; i < n; ++i) {
+			if (densityMatrixPerturbation[i] < 0)
+				err("FATAL: DensityMatrixPerturbation= values cannot be negative\n");
+			if (densityMatrixPerturbation[i] > 0) nonZero = true;
+		}
+
+		if (!nonZero) return;
+
+		if (options.find("wftAccelSvd") != PsimagLite::String::npos)
+			err("FATAL: DensityMatrixPerturbation= cannot be used with wftAccelSvd\n");
+
+		if (options.find("twositedmrg") != PsimagLite::String::npos) {
+			std::cerr<<"WARNING: DensityMatrixPerturbation used with twositedmrg\n";
+			std::cout<<"WARNING: DensityMatrixPerturbation used with twositedmrg\n";
+		}
+
+		if (densityMatrixPerturbation[n - 1] > 0) {
+			std::cerr<<"WARNING: DensityMatrixPerturbation nonzero in the last FiniteLoops\n";
+			std::cout<<"WARNING: DensityMatrixPerturbation nonzero in the last FiniteLoops\n";
+		}
+	}
+
 	static void checkFilesNotEqual(PsimagLite::String filename1,
 	                               PsimagLite::String filename2)
 	{
@@ -97,6 +97,8 @@ struct ProgramGlobals {
 
 	static PsimagLite::String notReallySortAlgo;
 
+	static bool su2NoKron;
+
 	enum class DirectionEnum {INFINITE, EXPAND_ENVIRON, EXPAND_SYSTEM};
 
 	enum class ConnectionEnum {SYSTEM_SYSTEM, SYSTEM_ENVIRON, ENVIRON_SYSTEM, ENVIRON_ENVIRON};
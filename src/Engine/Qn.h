@@ -99,10 +99,9 @@ public:
 
 	void write(PsimagLite::String str, PsimagLite::IoNgSerializer& io) const
 	{
-		static bool firstcall = true;
-		if (firstcall) {
+		if (!modalStructWritten) {
 			io.write("modalStruct", modalStruct);
-			firstcall = false;
+			modalStructWritten = true;
 		}
 
 		io.createGroup(str);
@@ -285,6 +284,7 @@ public:
 	}
 
 	static VectorModalStructType modalStruct;
+	static bool modalStructWritten;
 	static bool ifPresentOther0IsElectrons;
 	bool oddElectrons;
 	Array<SizeType> other;
@@ -0,0 +1,119 @@
+#ifndef RANDOMIZEDSVD_H
+#define RANDOMIZEDSVD_H
+#include "SubspaceIterationDiag.h"
+
+// Left singular vectors and squared singular values of the largest
+// k singular values of m (rows x cols), by a randomized range finder
+// with oversampling and power iterations
+// The small problem is solved through the eigenvalues of B B^dagger,
+// with B = Q^dagger m, which is the same accuracy that the density
+// matrix path has, and avoids computing right singular vectors
+namespace Dmrg {
+
+template<typename MatrixType>
+class RandomizedSvd {
+
+	typedef typename MatrixType::value_type ComplexOrRealType;
+	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef SubspaceIterationDiag<MatrixType> HelperType;
+
+	static const SizeType POWER_ITERATIONS = 2;
+
+public:
+
+	RandomizedSvd(const MatrixType& m, SizeType k)
+	    : m_(m),
+	      k_(std::min(k, std::min(m.rows(), m.cols()))),
+	      l_(std::min(k_ + std::max(k_/4, static_cast<SizeType>(8)),
+	                  std::min(m.rows(), m.cols()))),
+	      missedWeight_(0),
+	      totalWeight_(0)
+	{}
+
+	// Pays only if the sample is small compared to the matrix
+	bool worthIt() const
+	{
+		return (k_ > 0 && 4*l_ <= std::min(m_.rows(), m_.cols()));
+	}
+
+	// On return u is rows x l and s2 has l squared singular values,
+	// both in decreasing order
+	// Returns false if the weight of m not captured by the sample exceeds
+	// tolerance times the total weight of m
+	bool operator()(MatrixType& u, VectorRealType& s2, RealType tolerance)
+	{
+		const SizeType rows = m_.rows();
+		const SizeType cols = m_.cols();
+
+		MatrixType omega(cols, l_);
+		PsimagLite::Random48<RealType> rng(3433117);
+		for (SizeType j = 0; j < l_; ++j)
+			for (SizeType i = 0; i < cols; ++i)
+				omega(i, j) = rng() - 0.5;
+
+		MatrixType q;
+		HelperType::gemm('N', 'N', q, m_, omega);
+		HelperType::orthonormalize(q);
+		MatrixType z;
+		for (SizeType it = 0; it < POWER_ITERATIONS; ++it) {
+			HelperType::gemm('C', 'N', z, m_, q);
+			HelperType::orthonormalize(z);
+			HelperType::gemm('N', 'N', q, m_, z);
+			HelperType::orthonormalize(q);
+		}
+
+		// b = q^dagger m, and then b b^dagger = ub s2 ub^dagger
+		MatrixType b;
+		HelperType::gemm('C', 'N', b, q, m_);
+		MatrixType bbd(l_, l_);
+		for (SizeType i = 0; i < l_; ++i) {
+			for (SizeType j = 0; j < l_; ++j) {
+				ComplexOrRealType sum = 0;
+				for (SizeType c = 0; c < cols; ++c)
+					sum += b(i, c)*PsimagLite::conj(b(j, c));
+				bbd(i, j) = sum;
+			}
+		}
+
+		VectorRealType eigs(l_);
+		PsimagLite::diag(bbd, eigs, 'V');
+
+		// reverse to decreasing order
+		MatrixType ub(l_, l_);
+		s2.resize(l_);
+		RealType captured = 0;
+		for (SizeType j = 0; j < l_; ++j) {
+			s2[j] = std::max(eigs[l_ - 1 - j], static_cast<RealType>(0));
+			captured += s2[j];
+			for (SizeType i = 0; i < l_; ++i)
+				ub(i, j) = bbd(i, l_ - 1 - j);
+		}
+
+		HelperType::gemm('N', 'N', u, q, ub);
+
+		totalWeight_ = 0;
+		for (SizeType j = 0; j < cols; ++j)
+			for (SizeType i = 0; i < rows; ++i)
+				totalWeight_ += HelperType::modulusSquared(m_(i, j));
+
+		missedWeight_ = std::max(totalWeight_ - captured, static_cast<RealType>(0));
+
+		return (missedWeight_ <= tolerance*totalWeight_);
+	}
+
+	SizeType sampled() const { return l_; }
+
+	// weight of m outside the sampled subspace
+	RealType missedWeight() const { return missedWeight_; }
+
+private:
+
+	const MatrixType& m_;
+	SizeType k_;
+	SizeType l_;
+	RealType missedWeight_;
+	RealType totalWeight_;
+};
+}
+#endif // RANDOMIZEDSVD_H
@@ -103,13 +103,18 @@ class Recovery  {
 	struct OptionSpec {
 
 		OptionSpec()
-		    : optionEnum(OptionEnum::BY_LOOP), value(1), keepFiles(false), maxFiles(10)
+		    : optionEnum(OptionEnum::BY_LOOP),
+		      value(1),
+		      keepFiles(false),
+		      maxFiles(10),
+		      incremental(false)
 		{}
 
 		OptionEnum optionEnum;
 		SizeType value;
 		bool keepFiles;
 		SizeType maxFiles;
+		bool incremental;
 	};
 
 	struct OpaqueRestart {
@@ -170,6 +175,12 @@ public:
 			if (optionSpec_.keepFiles) continue;
 			unlink(savedName.c_str());
 		}
+
+		if (!optionSpec_.incremental || optionSpec_.keepFiles) return;
+
+		VectorStringType blobFiles = checkpoint_.blobFiles();
+		for (SizeType i = 0; i < blobFiles.size(); ++i)
+			unlink(blobFiles[i].c_str());
 	}
 
 	SizeType indexOfFirstFiniteLoop() const
@@ -220,7 +231,10 @@ public:
 		ioOut.close();
 
 		// checkpoint stacks
-		checkpoint_.checkpointStacks(savedName);
+		if (optionSpec_.incremental)
+			checkpoint_.checkpointStacksIncremental(savedName);
+		else
+			checkpoint_.checkpointStacks(savedName);
 
 		if (counter_ >= optionSpec_.maxFiles) counter_ = 0;
 	}
@@ -256,6 +270,17 @@ private:
 
 	  M=n, where n is the maximum number of recovery files that will be saved, before
 	  the oldest file is overwritten. Defaults to 10.
+
+	  incremental, which writes each stack entry only once, to a blob file named
+	  as the output file but ending in Blobs0.hd5, and
+	  only a list of entries to each recovery file.
+	  Entries unchanged since the previous save are not written again.
+	  An existing blob file is never overwritten; the next free name, ending in
+	  Blobs1.hd5 and so on, is used instead.
+	  When more than half of the entries in the blob file are no longer listed by
+	  any recovery file, the next save starts a new blob file, and blob files
+	  that no recovery file lists are deleted.
+	  The blob files are deleted with the recovery files.
 	 */
 	void procOneOption(PsimagLite::String str)
 	{
@@ -271,6 +296,11 @@ private:
 			return;
 		}
 
+		if (str == "incremental") {
+			optionSpec_.incremental = true;
+			return;
+		}
+
 		if (str.length() < 3) dieWithError(str);
 
 		if (str[0] == 'l' && str[1] == '%') {
@@ -0,0 +1,167 @@
+#ifndef RESOURCE_PLANNER_H
+#define RESOURCE_PLANNER_H
+#include "Vector.h"
+#include "PsimagLite.h"
+#include "ParametersForSolver.h"
+#include "FiniteLoop.h"
+#include "MatrixVectorKron/GenIjPatch.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+// Forecast of memory and time per finite loop, enabled with
+// SolverOptions=resourcePlanner; the run stops after the infinite loop
+// The sizes of the last infinite step, with block size n0, are
+// extrapolated to a finite loop with keptStates m with r = m d/n0,
+// where d is the Hilbert size of the site added:
+// sector size and vectors as r^2, operators (Kron blocks and stacks) as r^2,
+// and the time of the diagonalization as r^3, which is the scaling of the
+// Kronecker product of dense blocks
+// The number of patches is not extrapolated
+namespace Dmrg {
+
+template<typename LeftRightSuperType>
+class ResourcePlanner {
+
+	typedef typename LeftRightSuperType::BasisWithOperatorsType BasisWithOperatorsType;
+	typedef typename BasisWithOperatorsType::SparseMatrixType SparseMatrixType;
+	typedef typename SparseMatrixType::value_type ComplexOrRealType;
+	typedef typename BasisWithOperatorsType::RealType RealType;
+	typedef typename BasisWithOperatorsType::QnType QnType;
+	typedef GenIjPatch<LeftRightSuperType> GenIjPatchType;
+	typedef PsimagLite::ParametersForSolver<RealType> ParametersForSolverType;
+	typedef PsimagLite::Vector<FiniteLoop>::Type VectorFiniteLoopType;
+	typedef std::chrono::steady_clock ClockType;
+
+public:
+
+	ResourcePlanner(bool enabled)
+	    : enabled_(enabled),
+	      left_(0),
+	      right_(0),
+	      sector_(0),
+	      patches_(0),
+	      operatorBytes_(0),
+	      stackEntryBytes_(0),
+	      keptStates_(0),
+	      seconds_(0)
+	{}
+
+	bool enabled() const { return enabled_; }
+
+	void startStep()
+	{
+		if (!enabled_) return;
+		start_ = ClockType::now();
+	}
+
+	// after the diagonalization of each infinite step
+	template<typename VectorWithOffsetType>
+	void measureSuper(const LeftRightSuperType& lrs,
+	                  const QnType& qn,
+	                  const VectorWithOffsetType& psi)
+	{
+		if (!enabled_) return;
+		std::chrono::duration<double> spent = ClockType::now() - start_;
+		seconds_ = spent.count();
+		left_ = lrs.left().size();
+		right_ = lrs.right().size();
+		sector_ = 0;
+		for (SizeType ii = 0; ii < psi.sectors(); ++ii)
+			sector_ += psi.effectiveSize(psi.sector(ii));
+
+		GenIjPatchType patches(lrs, qn);
+		patches_ = patches(GenIjPatchType::LEFT).size();
+		operatorBytes_ = bytes(lrs.left()) + bytes(lrs.right());
+	}
+
+	// after the truncation of each infinite step
+	void measureStack(const BasisWithOperatorsType& basis)
+	{
+		if (!enabled_) return;
+		keptStates_ = basis.size();
+		stackEntryBytes_ = bytes(basis);
+	}
+
+	template<typename InputValidatorType>
+	void print(std::ostream& os,
+	           InputValidatorType& io,
+	           const VectorFiniteLoopType& finiteLoop,
+	           SizeType sites) const
+	{
+		if (!enabled_ || keptStates_ == 0 || left_ == 0) return;
+
+		const RealType mega = 1024.0*1024.0;
+		const RealType hilbert = static_cast<RealType>(left_)/keptStates_;
+		os<<"ResourcePlanner: last infinite step: keptStates="<<keptStates_;
+		os<<" left="<<left_<<" right="<<right_<<" sector="<<sector_;
+		os<<" patches="<<patches_<<" operatorsMB="<<operatorBytes_/mega;
+		os<<" stackEntryMB="<<stackEntryBytes_/mega;
+		os<<" diagonalizationSeconds="<<seconds_<<"\n";
+		os<<"ResourcePlanner: loop keptStates steps sector vectorsMB ";
+		os<<"operatorsMB stacksMB peakMB dataMB seconds\n";
+
+		RealType totalSeconds = 0;
+		RealType maxPeak = 0;
+		RealType totalData = 0;
+		for (SizeType i = 0; i < finiteLoop.size(); ++i) {
+			const SizeType steps = std::abs(finiteLoop[i].stepLength);
+			const SizeType m = finiteLoop[i].keptStates;
+			const RealType r = m*hilbert/left_;
+			const RealType sector = sector_*r*r;
+
+			ParametersForSolverType params(io, "Lanczos", i);
+			const SizeType vectors = (params.lotaMemory) ? params.steps + 2 : 4;
+			const RealType vectorsBytes = vectors*sector*sizeof(ComplexOrRealType);
+
+			// xout and yin of the Kronecker product
+			const RealType operatorsBytes = operatorBytes_*r*r +
+			        2*sector*sizeof(ComplexOrRealType);
+			const RealType stacksBytes = sites*stackEntryBytes_*r*r;
+			const RealType peak = vectorsBytes + operatorsBytes + stacksBytes;
+
+			// transform and wavefunction of each step
+			RealType dataBytes = 0;
+			if (finiteLoop[i].saveOption & 1)
+				dataBytes = steps*(m*hilbert*m + sector)*sizeof(ComplexOrRealType);
+
+			const RealType seconds = steps*seconds_*r*r*r;
+
+			os<<"ResourcePlanner: "<<i<<" "<<m<<" "<<steps<<" "<<sector<<" ";
+			os<<vectorsBytes/mega<<" "<<operatorsBytes/mega<<" "<<stacksBytes/mega<<" ";
+			os<<peak/mega<<" "<<dataBytes/mega<<" "<<seconds<<"\n";
+
+			totalSeconds += seconds;
+			totalData += dataBytes;
+			if (peak > maxPeak) maxPeak = peak;
+		}
+
+		os<<"ResourcePlanner: peakMB="<<maxPeak/mega<<" dataMB="<<totalData/mega;
+		os<<" seconds="<<totalSeconds<<"\n";
+	}
+
+private:
+
+	static RealType bytes(const BasisWithOperatorsType& basis)
+	{
+		const RealType perNonZero = sizeof(ComplexOrRealType) + sizeof(int);
+		RealType sum = basis.hamiltonian().nonZeros()*perNonZero;
+		for (SizeType i = 0; i < basis.numberOfOperators(); ++i)
+			sum += basis.getOperatorByIndex(i).data.nonZeros()*perNonZero;
+
+		return sum;
+	}
+
+	bool enabled_;
+	SizeType left_;
+	SizeType right_;
+	SizeType sector_;
+	SizeType patches_;
+	RealType operatorBytes_;
+	RealType stackEntryBytes_;
+	SizeType keptStates_;
+	double seconds_;
+	ClockType::time_point start_;
+};
+}
+#endif // RESOURCE_PLANNER_H
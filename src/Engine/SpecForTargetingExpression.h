@@ -7,6 +7,7 @@
 #include "GetBraOrKet.h"
 #include "ProgramGlobals.h"
 #include "PackIndices.h"
+#include <map>
 
 // All this isn't efficient!!
 
@@ -27,15 +28,42 @@ struct AuxForTargetingExpression {
 	                          const VectorWithOffsetType& gs_,
 	                          const VectorVectorWithOffsetType& pvectors_,
 	                          ProgramGlobals::DirectionEnum dir)
-	    : aoe(aoe_), model(model_), lrs(lrs_), gs(gs_), pvectors(pvectors_), direction(dir)
+	    : aoe(aoe_),
+	      model(model_),
+	      lrs(lrs_),
+	      gs(gs_),
+	      pvectors(pvectors_),
+	      direction(dir),
+	      termsComputed(0),
+	      termsReused(0)
 	{}
 
+	// Terms A|ket> already computed, by ket index and operators
+	// They are kept only for one step, since aux lives for one step,
+	// and must be dropped when the vector of their ket is overwritten
+	typedef std::pair<SizeType, PsimagLite::String> TermKeyType;
+	typedef std::map<TermKeyType, VectorWithOffsetType> MapTermType;
+
+	void eraseTermsOfKet(SizeType ind) const
+	{
+		typename MapTermType::iterator it = cachedTerms.begin();
+		while (it != cachedTerms.end()) {
+			if (it->first.first == ind)
+				cachedTerms.erase(it++);
+			else
+				++it;
+		}
+	}
+
 	const ApplyOperatorExpressionType& aoe;
 	const ModelType& model;
 	const LeftRightSuperType lrs;
 	const VectorWithOffsetType& gs;
 	const VectorVectorWithOffsetType& pvectors;
 	ProgramGlobals::DirectionEnum direction;
+	mutable MapTermType cachedTerms;
+	mutable SizeType termsComputed;
+	mutable SizeType termsReused;
 };
 
 template<typename TargetingBaseType>
@@ -163,7 +191,7 @@ public:
 		}
 
 		if (n > 1)
-			finalizeInternal(ket, ops, sites);
+			finalizeOrReuse(ket, ops, sites);
 
 		for (SizeType i = 0; i < opsSize; ++i) {
 			delete ops[i];
@@ -186,6 +214,29 @@ public:
 
 private:
 
+	// The same operators on the same ket appear in many P vectors,
+	// so A|ket> is computed once per step
+	void finalizeOrReuse(PsimagLite::String ket,
+	                     const VectorOneOperatorSpecType& ops,
+	                     const VectorIntType& sites)
+	{
+		PsimagLite::String opsString;
+		for (SizeType i = 0; i + 1 < vStr_.size(); ++i)
+			opsString += vStr_[i] + "*";
+
+		PsimagLite::GetBraOrKet getBraOrKet(ket);
+		const typename AuxiliaryType::TermKeyType key(getBraOrKet(), opsString);
+		typename AuxiliaryType::MapTermType::const_iterator it = aux_.cachedTerms.find(key);
+		if (it != aux_.cachedTerms.end()) {
+			fullVector_ = it->second;
+			++aux_.termsReused;
+			return;
+		}
+
+		finalizeInternal(ket, ops, sites);
+		aux_.cachedTerms[key] = fullVector_;
+		++aux_.termsComputed;
+	}
 
 	void finalizeInternal(PsimagLite::String ket,
 	                      const VectorOneOperatorSpecType& ops,
@@ -0,0 +1,398 @@
+#ifndef SU2_REDUCED_KRON_H
+#define SU2_REDUCED_KRON_H
+#include "Vector.h"
+#include "Matrix.h"
+#include "Map.h"
+#include "BLAS.h"
+#include "Link.h"
+#include "ProgramGlobals.h"
+
+// Kronecker form of the SU(2) reduced products of ModelHelperSu2
+// Reduced states of the left and of the right basis are grouped in classes
+// of equal j and electrons. A pair of classes, one left and one right, whose
+// states are in partition m is a patch, and the vector restricted to a patch
+// is a dense matrix. The Wigner-Eckart factors, and the fermion sign, depend
+// only on the classes, so that each pair of patches contributes
+// c A(a, a') Y(a', b') B(b, b')^T, with one coefficient c, by two GEMMs
+// This gives the same result as the element by element loops of ModelHelperSu2
+// The patches, and the dense blocks of the Hamiltonians and of the operators of
+// the links, are built once for each ModelHelperSu2, not for each product
+namespace Dmrg {
+
+template<typename LeftRightSuperType, typename Su2ReducedType>
+class Su2ReducedKron {
+
+	typedef typename LeftRightSuperType::BasisWithOperatorsType BasisWithOperatorsType;
+	typedef typename BasisWithOperatorsType::OperatorsType OperatorsType;
+	typedef typename OperatorsType::OperatorType OperatorType;
+	typedef typename OperatorType::StorageType SparseMatrixType;
+	typedef typename SparseMatrixType::value_type SparseElementType;
+	typedef typename PsimagLite::Real<SparseElementType>::Type RealType;
+	typedef typename PsimagLite::Vector<SparseElementType>::Type VectorSparseElementType;
+	typedef PsimagLite::Matrix<SparseElementType> MatrixType;
+	typedef typename PsimagLite::Vector<MatrixType>::Type VectorMatrixType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef PsimagLite::Vector<int>::Type VectorIntType;
+	typedef std::pair<SizeType, SizeType> PairType;
+	typedef Link<SparseElementType> LinkType;
+
+	// reduced states of one basis, by class
+	struct Classes {
+
+		void init(const BasisWithOperatorsType& basis)
+		{
+			VectorSizeType electronsOfState;
+			basis.su2ElectronsBridge(electronsOfState);
+			const SizeType n = basis.reducedSize();
+			classOf.resize(n);
+			position.resize(n);
+			typename PsimagLite::Map<PairType, SizeType>::Type classIndex;
+			for (SizeType i = 0; i < n; ++i) {
+				const SizeType ri = basis.reducedIndex(i);
+				assert(ri < electronsOfState.size());
+				PairType key(basis.jmValue(ri).first, electronsOfState[ri]);
+				typename PsimagLite::Map<PairType, SizeType>::Type::iterator it =
+				        classIndex.find(key);
+				SizeType c = 0;
+				if (it == classIndex.end()) {
+					c = j.size();
+					classIndex[key] = c;
+					j.push_back(key.first);
+					electrons.push_back(key.second);
+					size.push_back(0);
+				} else {
+					c = it->second;
+				}
+
+				classOf[i] = c;
+				position[i] = size[c]++;
+			}
+		}
+
+		SizeType classes() const { return j.size(); }
+
+		VectorSizeType classOf;
+		VectorSizeType position;
+		VectorSizeType j;
+		VectorSizeType electrons;
+		VectorSizeType size;
+	};
+
+	struct Patch {
+
+		Patch(SizeType a_, SizeType b_, SizeType offset_)
+		    : a(a_), b(b_), offset(offset_)
+		{}
+
+		SizeType a;
+		SizeType b;
+		// of this patch in the vector of all patches, see gather()
+		SizeType offset;
+	};
+
+	typedef typename PsimagLite::Vector<Patch>::Type VectorPatchType;
+
+	// the nonzero blocks of an operator between classes, as dense matrices;
+	// index(c, cprime) is the block, or -1 if it is zero
+	struct DenseBlocks {
+
+		VectorMatrixType blocks;
+		PsimagLite::Matrix<int> index;
+	};
+
+	typedef typename PsimagLite::Vector<DenseBlocks>::Type VectorDenseBlocksType;
+
+	// the dense blocks of operators of one basis, by operator
+	struct Operators {
+
+		typename PsimagLite::Map<const SparseMatrixType*, SizeType>::Type index;
+		VectorDenseBlocksType blocks;
+	};
+
+public:
+
+	// Nothing is built unless enabled, see SolverOptions=su2NoKron
+	Su2ReducedKron(int m,
+	               const LeftRightSuperType& lrs,
+	               const Su2ReducedType& su2reduced,
+	               bool enabled)
+	    : enabled_(enabled), jMax_(lrs.left().jMax()), size_(0)
+	{
+		if (!enabled_) return;
+
+		left_.init(lrs.left());
+		right_.init(lrs.right());
+
+		patchIndex_.resize(left_.classes(), right_.classes());
+		for (SizeType a = 0; a < left_.classes(); ++a)
+			for (SizeType b = 0; b < right_.classes(); ++b)
+				patchIndex_(a, b) = -1;
+
+		for (SizeType i = 0; i < su2reduced.reducedEffectiveSize(); ++i) {
+			const SizeType a = left_.classOf[su2reduced.reducedEffective(i).first];
+			const SizeType b = right_.classOf[su2reduced.reducedEffective(i).second];
+			if (patchIndex_(a, b) >= 0) continue;
+			patchIndex_(a, b) = patches_.size();
+			patches_.push_back(Patch(a, b, size_));
+			size_ += left_.size[a]*right_.size[b];
+		}
+
+		// column major in each patch, -1 if the state is not in partition m
+		superIndex_.resize(size_, -1);
+		const int offset = lrs.super().partition(m);
+		const int total = lrs.super().partition(m + 1) - offset;
+		for (SizeType i = 0; i < su2reduced.reducedEffectiveSize(); ++i) {
+			const int ix = su2reduced.flavorMapping(i) - offset;
+			if (ix < 0 || ix >= total) continue;
+			const SizeType i1 = su2reduced.reducedEffective(i).first;
+			const SizeType i2 = su2reduced.reducedEffective(i).second;
+			const SizeType a = left_.classOf[i1];
+			const Patch& patch = patches_[patchIndex_(a, right_.classOf[i2])];
+			superIndex_[patch.offset + left_.position[i1] + right_.position[i2]*left_.size[a]] = ix;
+		}
+
+		denseBlocks(hamiltonianLeft_, su2reduced.hamiltonianLeft(), left_);
+		denseBlocks(hamiltonianRight_, su2reduced.hamiltonianRight(), right_);
+	}
+
+	bool enabled() const { return enabled_; }
+
+	// Dense blocks of A, acting on the left, and of B, acting on the right,
+	// for fastOpProdInter below; the operators must not change afterwards
+	void cacheOperators(const SparseMatrixType& A, const SparseMatrixType& B)
+	{
+		if (!enabled_) return;
+		cacheOperator(leftOperators_, A, left_);
+		cacheOperator(rightOperators_, B, right_);
+	}
+
+	// x += (AB)y, A acting on the left and B on the right, for a
+	// SYSTEM_ENVIRON link, see ModelHelperSu2::fastOpProdInter
+	// A and B must have been given to cacheOperators
+	void fastOpProdInter(VectorSparseElementType& x,
+	                     const VectorSparseElementType& y,
+	                     const SparseMatrixType& A,
+	                     const SparseMatrixType& B,
+	                     const LinkType& link,
+	                     bool flipped,
+	                     const Su2ReducedType& su2reduced) const
+	{
+		assert(enabled_);
+		assert(link.type == ProgramGlobals::ConnectionEnum::SYSTEM_ENVIRON);
+		const RealType fermionSign = (link.fermionOrBoson ==
+		                              ProgramGlobals::FermionOrBosonEnum::FERMION) ? -1 : 1;
+
+		const DenseBlocks& blocksA = cachedOperator(leftOperators_, A);
+		const DenseBlocks& blocksB = cachedOperator(rightOperators_, B);
+
+		VectorSparseElementType ys;
+		gather(ys, y);
+		VectorSparseElementType xs(size_, 0.0);
+
+		const SparseElementType zero = 0.0;
+		const SparseElementType one = 1.0;
+		MatrixType tmp;
+		for (SizeType pprime = 0; pprime < patches_.size(); ++pprime) {
+			const SizeType aprime = patches_[pprime].a;
+			const SizeType bprime = patches_[pprime].b;
+			const SizeType rowsPrime = left_.size[aprime];
+			const SizeType colsPrime = right_.size[bprime];
+			for (SizeType b = 0; b < right_.classes(); ++b) {
+				const int kb = blocksB.index(b, bprime);
+				if (kb < 0) continue;
+
+				const SizeType cols = right_.size[b];
+				// tmp = Y(a', b') B(b, b')^T, shared by all a
+				tmp.resize(rowsPrime, cols);
+				psimag::BLAS::GEMM('N', 'T', rowsPrime, cols, colsPrime, one,
+				                   &(ys[patches_[pprime].offset]), rowsPrime,
+				                   &(blocksB.blocks[kb](0, 0)), cols, zero,
+				                   &(tmp(0, 0)), rowsPrime);
+
+				const SizeType lf2 = left_.j[aprime] + right_.j[bprime]*jMax_;
+				for (SizeType a = 0; a < left_.classes(); ++a) {
+					const int p = patchIndex_(a, b);
+					const int ka = blocksA.index(a, aprime);
+					if (p < 0 || ka < 0) continue;
+
+					const SizeType lf1 = left_.j[a] + right_.j[b]*jMax_;
+					SparseElementType c = su2reduced.reducedFactor(link.angularMomentum,
+					                                               link.category,
+					                                               flipped,
+					                                               lf1,
+					                                               lf2);
+					if (c == zero) continue;
+
+					const SizeType n1 = left_.electrons[a];
+					const RealType fsign = (n1 > 0 && n1 % 2 != 0) ? fermionSign : 1;
+					c *= fsign*link.value*link.angularFactor;
+
+					const SizeType rows = left_.size[a];
+					psimag::BLAS::GEMM('N', 'N', rows, cols, rowsPrime, c,
+					                   &(blocksA.blocks[ka](0, 0)), rows,
+					                   &(tmp(0, 0)), rowsPrime, one,
+					                   &(xs[patches_[p].offset]), rows);
+				}
+			}
+		}
+
+		scatter(x, xs);
+	}
+
+	// x += H_left y, see ModelHelperSu2::hamiltonianLeftProduct
+	void hamiltonianLeftProduct(VectorSparseElementType& x,
+	                            const VectorSparseElementType& y,
+	                            const Su2ReducedType& su2reduced) const
+	{
+		assert(enabled_);
+		VectorSparseElementType ys;
+		gather(ys, y);
+		VectorSparseElementType xs(size_, 0.0);
+
+		const SparseElementType one = 1.0;
+		for (SizeType p = 0; p < patches_.size(); ++p) {
+			const SizeType a = patches_[p].a;
+			const SizeType b = patches_[p].b;
+			if (!hamiltonianFactor(a, b, su2reduced)) continue;
+
+			const SizeType rows = left_.size[a];
+			const SizeType cols = right_.size[b];
+			for (SizeType aprime = 0; aprime < left_.classes(); ++aprime) {
+				const int k = hamiltonianLeft_.index(a, aprime);
+				const int pprime = patchIndex_(aprime, b);
+				if (k < 0 || pprime < 0) continue;
+
+				const SizeType rowsPrime = left_.size[aprime];
+				psimag::BLAS::GEMM('N', 'N', rows, cols, rowsPrime, one,
+				                   &(hamiltonianLeft_.blocks[k](0, 0)), rows,
+				                   &(ys[patches_[pprime].offset]), rowsPrime, one,
+				                   &(xs[patches_[p].offset]), rows);
+			}
+		}
+
+		scatter(x, xs);
+	}
+
+	// x += H_right y, see ModelHelperSu2::hamiltonianRightProduct
+	void hamiltonianRightProduct(VectorSparseElementType& x,
+	                             const VectorSparseElementType& y,
+	                             const Su2ReducedType& su2reduced) const
+	{
+		assert(enabled_);
+		VectorSparseElementType ys;
+		gather(ys, y);
+		VectorSparseElementType xs(size_, 0.0);
+
+		const SparseElementType one = 1.0;
+		for (SizeType p = 0; p < patches_.size(); ++p) {
+			const SizeType a = patches_[p].a;
+			const SizeType b = patches_[p].b;
+			if (!hamiltonianFactor(a, b, su2reduced)) continue;
+
+			const SizeType rows = left_.size[a];
+			const SizeType cols = right_.size[b];
+			for (SizeType bprime = 0; bprime < right_.classes(); ++bprime) {
+				const int k = hamiltonianRight_.index(b, bprime);
+				const int pprime = patchIndex_(a, bprime);
+				if (k < 0 || pprime < 0) continue;
+
+				const SizeType colsPrime = right_.size[bprime];
+				psimag::BLAS::GEMM('N', 'T', rows, cols, colsPrime, one,
+				                   &(ys[patches_[pprime].offset]), rows,
+				                   &(hamiltonianRight_.blocks[k](0, 0)), cols, one,
+				                   &(xs[patches_[p].offset]), rows);
+			}
+		}
+
+		scatter(x, xs);
+	}
+
+private:
+
+	bool hamiltonianFactor(SizeType a, SizeType b, const Su2ReducedType& su2reduced) const
+	{
+		const SparseElementType zero = 0.0;
+		return (su2reduced.reducedHamiltonianFactor(left_.j[a], right_.j[b]) != zero);
+	}
+
+	static void cacheOperator(Operators& operators,
+	                          const SparseMatrixType& m,
+	                          const Classes& classes)
+	{
+		if (operators.index.find(&m) != operators.index.end()) return;
+		operators.index[&m] = operators.blocks.size();
+		operators.blocks.push_back(DenseBlocks());
+		denseBlocks(operators.blocks.back(), m, classes);
+	}
+
+	static const DenseBlocks& cachedOperator(const Operators& operators,
+	                                         const SparseMatrixType& m)
+	{
+		typename PsimagLite::Map<const SparseMatrixType*, SizeType>::Type::const_iterator it =
+		        operators.index.find(&m);
+		if (it == operators.index.end())
+			err("Su2ReducedKron: operator was not given to cacheOperators\n");
+
+		assert(it->second < operators.blocks.size());
+		return operators.blocks[it->second];
+	}
+
+	static void denseBlocks(DenseBlocks& dense,
+	                        const SparseMatrixType& m,
+	                        const Classes& classes)
+	{
+		const SizeType n = classes.classes();
+		dense.index.resize(n, n);
+		for (SizeType c = 0; c < n; ++c)
+			for (SizeType cprime = 0; cprime < n; ++cprime)
+				dense.index(c, cprime) = -1;
+
+		dense.blocks.clear();
+		const SizeType rows = m.rows();
+		assert(rows <= classes.classOf.size());
+		for (SizeType i = 0; i < rows; ++i) {
+			const SizeType c = classes.classOf[i];
+			for (int k = m.getRowPtr(i); k < m.getRowPtr(i + 1); ++k) {
+				const SizeType iprime = m.getCol(k);
+				const SizeType cprime = classes.classOf[iprime];
+				if (dense.index(c, cprime) < 0) {
+					dense.index(c, cprime) = dense.blocks.size();
+					dense.blocks.push_back(MatrixType(classes.size[c], classes.size[cprime]));
+					dense.blocks.back().setTo(0.0);
+				}
+
+				MatrixType& block = dense.blocks[dense.index(c, cprime)];
+				block(classes.position[i], classes.position[iprime]) += m.getValue(k);
+			}
+		}
+	}
+
+	// ys holds all patches, one after the other, see Patch::offset
+	void gather(VectorSparseElementType& ys, const VectorSparseElementType& y) const
+	{
+		ys.resize(size_);
+		for (SizeType k = 0; k < size_; ++k)
+			ys[k] = (superIndex_[k] >= 0) ? y[superIndex_[k]] : 0.0;
+	}
+
+	void scatter(VectorSparseElementType& x, const VectorSparseElementType& xs) const
+	{
+		for (SizeType k = 0; k < size_; ++k)
+			if (superIndex_[k] >= 0) x[superIndex_[k]] += xs[k];
+	}
+
+	bool enabled_;
+	SizeType jMax_;
+	Classes left_;
+	Classes right_;
+	PsimagLite::Matrix<int> patchIndex_;
+	VectorPatchType patches_;
+	SizeType size_;
+	VectorIntType superIndex_;
+	DenseBlocks hamiltonianLeft_;
+	DenseBlocks hamiltonianRight_;
+	Operators leftOperators_;
+	Operators rightOperators_;
+};
+}
+#endif // SU2_REDUCED_KRON_H
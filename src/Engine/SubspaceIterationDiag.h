@@ -0,0 +1,190 @@
+#ifndef SUBSPACEITERATIONDIAG_H
+#define SUBSPACEITERATIONDIAG_H
+#include "Matrix.h"
+#include "BLAS.h"
+#include "Random48.h"
+#include "PsimagLite.h"
+
+// Eigenvectors of the k largest eigenvalues of a hermitian positive
+// semidefinite matrix, such as a block of the reduced density matrix,
+// by block subspace iteration with Rayleigh-Ritz
+// The cost per iteration is one n x n times n x (k + p) gemm,
+// instead of the full n^3 diagonalization
+namespace Dmrg {
+
+template<typename MatrixType>
+class SubspaceIterationDiag {
+
+	typedef typename MatrixType::value_type ComplexOrRealType;
+	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+
+	static const SizeType MAX_ITERATIONS = 25;
+
+public:
+
+	SubspaceIterationDiag(const MatrixType& a, SizeType k)
+	    : a_(a),
+	      k_(k),
+	      nb_(std::min(a.rows(), k + std::max(k/4, static_cast<SizeType>(8))))
+	{
+		assert(a.rows() == a.cols());
+	}
+
+	// Subspace iteration pays only if the subspace is small compared
+	// to the matrix; otherwise use full diagonalization
+	bool worthIt() const
+	{
+		return (k_ > 0 && 8*nb_ <= a_.rows());
+	}
+
+	// On return x is n x k, with columns sorted by increasing eigenvalue
+	// Returns false if the residuals did not converge
+	bool operator()(MatrixType& x, VectorRealType& eigs, RealType tolerance) const
+	{
+		const SizeType n = a_.rows();
+		MatrixType q(n, nb_);
+		PsimagLite::Random48<RealType> rng(3433117);
+		for (SizeType j = 0; j < nb_; ++j)
+			for (SizeType i = 0; i < n; ++i)
+				q(i, j) = rng() - 0.5;
+
+		orthonormalize(q);
+
+		RealType normOfA = 0;
+		for (SizeType i = 0; i < n; ++i)
+			normOfA += PsimagLite::real(a_(i, i)); // a is positive semidefinite
+
+		MatrixType y(n, nb_);
+		MatrixType b(nb_, nb_);
+		VectorRealType theta(nb_);
+		for (SizeType iter = 0; iter < MAX_ITERATIONS; ++iter) {
+			gemm('N', 'N', y, a_, q);
+
+			// Rayleigh-Ritz: b = q^dagger a q
+			gemm('C', 'N', b, q, y);
+			PsimagLite::diag(b, theta, 'V');
+
+			// x = q b, restricted to the k largest
+			gemm('N', 'N', x, q, b);
+			bool converged = residualsConverged(x, y, b, theta, tolerance*normOfA);
+
+			if (converged) {
+				extract(x, eigs, theta);
+				return true;
+			}
+
+			// next subspace is a q, orthonormalized
+			q = y;
+			orthonormalize(q);
+		}
+
+		return false;
+	}
+
+	// Gram-Schmidt twice; columns that are linearly dependent on the
+	// previous ones are replaced by unit vectors
+	static void orthonormalize(MatrixType& q)
+	{
+		const SizeType n = q.rows();
+		const SizeType cols = q.cols();
+		SizeType unit = 0;
+		for (SizeType j = 0; j < cols; ++j) {
+			RealType norma0 = 0;
+			for (SizeType r = 0; r < n; ++r)
+				norma0 += modulusSquared(q(r, j));
+			norma0 = sqrt(norma0);
+
+			for (SizeType pass = 0; pass < 2; ++pass) {
+				for (SizeType i = 0; i < j; ++i) {
+					ComplexOrRealType c = 0;
+					for (SizeType r = 0; r < n; ++r)
+						c += PsimagLite::conj(q(r, i))*q(r, j);
+					for (SizeType r = 0; r < n; ++r)
+						q(r, j) -= c*q(r, i);
+				}
+			}
+
+			RealType norma = 0;
+			for (SizeType r = 0; r < n; ++r)
+				norma += modulusSquared(q(r, j));
+			norma = sqrt(norma);
+
+			if (norma <= 1e-10*norma0 || norma0 == 0) {
+				if (unit >= n) err("SubspaceIterationDiag: rank deficient\n");
+				for (SizeType r = 0; r < n; ++r)
+					q(r, j) = (r == unit) ? 1.0 : 0.0;
+				++unit;
+				--j;
+				continue;
+			}
+
+			for (SizeType r = 0; r < n; ++r)
+				q(r, j) /= norma;
+		}
+	}
+
+	static RealType modulusSquared(const ComplexOrRealType& z)
+	{
+		return PsimagLite::real(PsimagLite::conj(z)*z);
+	}
+
+	// c = op(a) b
+	static void gemm(char opA, char opB, MatrixType& c, const MatrixType& a, const MatrixType& b)
+	{
+		const SizeType m = (opA == 'N') ? a.rows() : a.cols();
+		const SizeType k = (opA == 'N') ? a.cols() : a.rows();
+		assert(opB == 'N' && b.rows() == k);
+		const SizeType n = b.cols();
+		c.resize(m, n);
+		const ComplexOrRealType one = 1.0;
+		const ComplexOrRealType zero = 0.0;
+		psimag::BLAS::GEMM(opA, opB, m, n, k, one, &(a(0, 0)), a.rows(),
+		                   &(b(0, 0)), b.rows(), zero, &(c(0, 0)), m);
+	}
+
+private:
+
+	// the last k columns of x are the wanted ones, with ascending theta
+	void extract(MatrixType& x, VectorRealType& eigs, const VectorRealType& theta) const
+	{
+		const SizeType n = x.rows();
+		const SizeType offset = nb_ - k_;
+		MatrixType tmp(n, k_);
+		eigs.resize(k_);
+		for (SizeType j = 0; j < k_; ++j) {
+			eigs[j] = theta[j + offset];
+			for (SizeType i = 0; i < n; ++i)
+				tmp(i, j) = x(i, j + offset);
+		}
+
+		x = tmp;
+	}
+
+	// ||a x_j - theta_j x_j|| for the wanted columns, with a x = y b
+	bool residualsConverged(const MatrixType& x,
+	                        const MatrixType& y,
+	                        const MatrixType& b,
+	                        const VectorRealType& theta,
+	                        RealType tolerance) const
+	{
+		const SizeType n = x.rows();
+		MatrixType ax(n, nb_);
+		gemm('N', 'N', ax, y, b);
+		for (SizeType j = nb_ - k_; j < nb_; ++j) {
+			RealType sum = 0;
+			for (SizeType i = 0; i < n; ++i)
+				sum += modulusSquared(ax(i, j) - theta[j]*x(i, j));
+
+			if (sum > tolerance*tolerance) return false;
+		}
+
+		return true;
+	}
+
+	const MatrixType& a_;
+	SizeType k_;
+	SizeType nb_;
+};
+}
+#endif // SUBSPACEITERATIONDIAG_H
@@ -0,0 +1,145 @@
+#ifndef SYNCHRONIZED_LINES_H
+#define SYNCHRONIZED_LINES_H
+#include "Vector.h"
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <mutex>
+
+// While alive, the stream given to the constructor, usually std::cout,
+// writes whole lines, one thread at a time
+// Threads that print concurrently, such as the METTS chains of
+// MettsChains=, then neither interleave their lines nor write to the
+// stream buffer at the same time; dmrg redirects std::cout to a file, whose
+// buffer cannot be written by two threads at once
+// Each thread keeps its unfinished line until it ends with a newline,
+// or until the stream is flushed
+// A thread that holds a Tag starts each of its lines with the tag, so that
+// the lines of, for example, each METTS chain can be told apart
+namespace Dmrg {
+
+class SynchronizedLines : public std::streambuf {
+
+public:
+
+	// While alive, the lines that this thread writes start with tag
+	class Tag {
+
+	public:
+
+		Tag(const std::string& tag)
+		{
+			threadTag() = tag;
+			atLineStart() = true;
+		}
+
+		~Tag()
+		{
+			threadTag() = "";
+		}
+
+	private:
+
+		Tag(const Tag&);
+
+		Tag& operator=(const Tag&);
+	};
+
+	SynchronizedLines(std::ostream& os)
+	    : os_(os), buffer_(os.rdbuf())
+	{
+		os_.flush();
+		os_.rdbuf(this);
+	}
+
+	~SynchronizedLines()
+	{
+		writeLine(threadLine());
+		os_.rdbuf(buffer_);
+		os_.flush();
+	}
+
+protected:
+
+	int overflow(int c)
+	{
+		if (traits_type::eq_int_type(c, traits_type::eof()))
+			return traits_type::not_eof(c);
+
+		std::string& line = threadLine();
+		line += traits_type::to_char_type(c);
+		if (traits_type::to_char_type(c) == '\n') writeLine(line);
+		return c;
+	}
+
+	std::streamsize xsputn(const char* s, std::streamsize n)
+	{
+		std::string& line = threadLine();
+		line.append(s, n);
+		if (line.size() > 0 && line[line.size() - 1] == '\n') writeLine(line);
+		return n;
+	}
+
+	int sync()
+	{
+		writeLine(threadLine());
+		std::lock_guard<std::mutex> lock(mutex_);
+		return buffer_->pubsync();
+	}
+
+private:
+
+	SynchronizedLines(const SynchronizedLines&);
+
+	SynchronizedLines& operator=(const SynchronizedLines&);
+
+	static std::string& threadLine()
+	{
+		static thread_local std::string line;
+		return line;
+	}
+
+	static std::string& threadTag()
+	{
+		static thread_local std::string tag;
+		return tag;
+	}
+
+	// false if this thread has flushed part of a line, whose remainder
+	// must not be tagged again
+	static bool& atLineStart()
+	{
+		static thread_local bool start = true;
+		return start;
+	}
+
+	void writeLine(std::string& line)
+	{
+		if (line.size() == 0) return;
+		const std::string& tag = threadTag();
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (tag.size() == 0) {
+			buffer_->sputn(line.data(), line.size());
+			line.clear();
+			return;
+		}
+
+		SizeType start = 0;
+		while (start < line.size()) {
+			size_t end = line.find('\n', start);
+			end = (end == std::string::npos) ? line.size() : end + 1;
+			if (atLineStart()) buffer_->sputn(tag.data(), tag.size());
+			buffer_->sputn(line.data() + start, end - start);
+			atLineStart() = (line[end - 1] == '\n');
+			start = end;
+		}
+
+		line.clear();
+	}
+
+	std::ostream& os_;
+	std::streambuf* buffer_;
+	std::mutex mutex_;
+};
+}
+#endif // SYNCHRONIZED_LINES_H
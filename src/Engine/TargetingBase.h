@@ -199,6 +199,13 @@ public:
 		return false;
 	}
 
+	// Continues, as chain number chain, from the state of other after the
+	// infinite loop; other must be of the same targeting; see MettsChains=
+	virtual void fork(const TargetingBase&, SizeType)
+	{
+		err("This targeting does not support MettsChains=\n");
+	}
+
 	virtual SizeType size() const
 	{
 		if (commonTargeting_.aoe().allStages(StageEnumType::DISABLED)) return 0;
@@ -275,6 +282,11 @@ public:
 		commonTargeting_.aoe().multiSitePush(ds);
 	}
 
+	void setAsyncWriter(AsyncOutputWriter* asyncWriter)
+	{
+		commonTargeting_.setAsyncWriter(asyncWriter);
+	}
+
 protected:
 
 	TargetingCommonType& common()
@@ -93,6 +93,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "PsimagLite.h"
 #include "GetBraOrKet.h"
 #include "RestartStruct.h"
+#include "AsyncOutputWriter.h"
+#include <memory>
 
 namespace Dmrg {
 
@@ -154,7 +156,8 @@ public:
 	      progress_("TargetingCommon"),
 	      targetHelper_(lrs, model, wft),
 	      aoe_(targetHelper_, indexNoAdvance),
-	      inSitu_(model.geometry().numberOfSites())
+	      inSitu_(model.geometry().numberOfSites()),
+	      asyncWriter_(0)
 	{
 		PsimagLite::split(meas_, model.params().insitu, ",");
 		SizeType n = meas_.size();
@@ -180,6 +183,12 @@ public:
 		}
 	}
 
+	// TimeSerializers for the io of asyncWriter go through it
+	void setAsyncWriter(AsyncOutputWriter* asyncWriter)
+	{
+		asyncWriter_ = asyncWriter;
+	}
+
 	void postCtor(SizeType tstSites, SizeType targets)
 	{
 		aoe_.postCtor(tstSites);
@@ -217,6 +226,17 @@ public:
 	                PsimagLite::String prefix) const
 	{
 		SizeType site = block[0];
+		if (asyncWriter_ && asyncWriter_->enabled() && &io == &asyncWriter_->io()) {
+			std::shared_ptr<TimeSerializerType> ts(new TimeSerializerType(aoe_.currentTimeStep(),
+			                                                              aoe_.time(),
+			                                                              site,
+			                                                              aoe_.targetVectors(),
+			                                                              aoe_.stages()));
+			asyncWriter_->push([ts, prefix](PsimagLite::IoSelector::Out& ioOut)
+			{ ts->write(ioOut, prefix); });
+			return;
+		}
+
 		TimeSerializerType ts(aoe_.currentTimeStep(),
 		                      aoe_.time(),
 		                      site,
@@ -450,17 +470,16 @@ public:
 		for (SizeType i = 0; i < q.size(); ++i) signs[i] = q[i].oddElectrons;
 
 		FermionSign fs(targetHelper_.lrs().left(), signs);
-		for (SizeType j=0;j<creationMatrix.size();j++) {
-			VectorWithOffsetType phiTemp;
-			const OperatorType& cm = creationMatrix[j];
-			aoe_.applyOpLocal()(phiTemp,
-			                    psi,
-			                    cm,
-			                    fs,
-			                    direction,
-			                    ApplyOperatorType::BORDER_NO);
-			if (j==0) v = phiTemp;
-			else v += phiTemp;
+		typename ApplyOperatorType::VectorVectorWithOffsetType phiTemp;
+		aoe_.applyOpLocal()(phiTemp,
+		                    psi,
+		                    creationMatrix,
+		                    fs,
+		                    direction,
+		                    ApplyOperatorType::BORDER_NO);
+		for (SizeType j=0;j<phiTemp.size();j++) {
+			if (j==0) v = phiTemp[j];
+			else v += phiTemp[j];
 		}
 	}
 
@@ -720,6 +739,7 @@ private:
 	TargetHelperType targetHelper_;
 	ApplyOperatorExpressionType aoe_;
 	mutable VectorType inSitu_;
+	AsyncOutputWriter* asyncWriter_;
 }; // class TargetingCommon
 
 template<typename TargetHelperType,
@@ -230,7 +230,13 @@ private:
 			canonicalExpression(tmp, pVectors_[i]->toString(), opEmpty, aux);
 			VectorWithOffsetType_& dst = this->common().aoe().targetVectors(i);
 			tmp.finalize(&dst);
+			// |P<i>> has ket index i + 1, see GetBraOrKet
+			aux.eraseTermsOfKet(i + 1);
 		}
+
+		PsimagLite::OstringStream msg;
+		msg<<"Terms computed "<<aux.termsComputed<<" reused "<<aux.termsReused;
+		progress_.printline(msg, std::cout);
 	}
 
 	PsimagLite::ProgressIndicator progress_;
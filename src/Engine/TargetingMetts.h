@@ -172,6 +172,7 @@ public:
 	      mettsStochastics_(model,mettsStruct_.rngSeed,mettsStruct_.pure),
 	      mettsCollapse_(mettsStochastics_,lrs,mettsStruct_),
 	      prevDirection_(ProgramGlobals::DirectionEnum::INFINITE),
+	      timesWithoutAdvancement_(0),
 	      systemPrev_(),
 	      environPrev_()
 	{
@@ -331,6 +332,30 @@ public:
 
 	bool end() const { return false; }
 
+	// chain c uses the seed TSPRngSeed + 1 + c, and the infinite
+	// loop TSPRngSeed
+	void fork(const BaseType& base, SizeType chain)
+	{
+		const TargetingMetts* other = dynamic_cast<const TargetingMetts*>(&base);
+		if (!other) err("TargetingMetts::fork(): other targeting is not METTS\n");
+
+		this->common().aoe().psi() = other->common().aoe().psi();
+		const SizeType n = other->common().aoe().targetVectors().size();
+		assert(n == this->common().aoe().targetVectors().size());
+		for (SizeType i = 0; i < n; ++i)
+			this->common().aoe().targetVectors(i) = other->common().aoe().targetVectors()[i];
+
+		const typename RngType::LongType seed = mettsStruct_.rngSeed + 1 + chain;
+		mettsStochastics_.fork(other->mettsStochastics_, seed);
+		mettsCollapse_.reseed(seed);
+		prevDirection_ = other->prevDirection_;
+		timesWithoutAdvancement_ = other->timesWithoutAdvancement_;
+		systemPrev_ = other->systemPrev_;
+		environPrev_ = other->environPrev_;
+		pureVectors_ = other->pureVectors_;
+		sitesCollapsed_ = other->sitesCollapsed_;
+	}
+
 private:
 
 	void evolve(SizeType index,
@@ -379,8 +404,6 @@ private:
 
 	void advanceCounterAndComputeStage(const VectorSizeType& block)
 	{
-		static SizeType timesWithoutAdvancement = 0;
-
 		if (this->common().aoe().noStageIs(StageEnumType::COLLAPSE))
 			this->common().setAllStagesTo(StageEnumType::WFT_NOADVANCE);
 
@@ -388,13 +411,13 @@ private:
 			if (!allSitesCollapsed()) {
 				if (sitesCollapsed_.size()>2*model_.geometry().numberOfSites())
 					throw PsimagLite::RuntimeError("advanceCounterAndComputeStage\n");
-				printAdvancement(timesWithoutAdvancement);
+				printAdvancement(timesWithoutAdvancement_);
 				return;
 			}
 
 			sitesCollapsed_.clear();
 			this->common().setAllStagesTo(StageEnumType::WFT_NOADVANCE);
-			timesWithoutAdvancement = 0;
+			timesWithoutAdvancement_ = 0;
 			this->common().aoe().setCurrentTimeStep(0);
 			PsimagLite::OstringStream msg;
 			SizeType n1 = mettsStruct_.timeSteps();
@@ -404,13 +427,13 @@ private:
 			for (SizeType i=0;i<n1;i++)
 				this->common().aoe().targetVectors(i) = this->common().aoe().targetVectors()[n1];
 			this->common().aoe().timeHasAdvanced();
-			printAdvancement(timesWithoutAdvancement);
+			printAdvancement(timesWithoutAdvancement_);
 			return;
 		}
 
-		if (timesWithoutAdvancement < mettsStruct_.advanceEach()) {
-			timesWithoutAdvancement++;
-			printAdvancement(timesWithoutAdvancement);
+		if (timesWithoutAdvancement_ < mettsStruct_.advanceEach()) {
+			timesWithoutAdvancement_++;
+			printAdvancement(timesWithoutAdvancement_);
 			return;
 		}
 
@@ -419,15 +442,15 @@ private:
 			this->common().setAllStagesTo(StageEnumType::WFT_ADVANCE);
 			const SizeType tmp = this->common().aoe().currentTimeStep() + 1;
 			this->common().aoe().setCurrentTimeStep(tmp);
-			timesWithoutAdvancement = 0;
-			printAdvancement(timesWithoutAdvancement);
+			timesWithoutAdvancement_ = 0;
+			printAdvancement(timesWithoutAdvancement_);
 			return;
 		}
 
 		if (this->common().aoe().noStageIs(StageEnumType::COLLAPSE) &&
 		        this->common().aoe().time() >= mettsStruct_.beta &&
 		        block[0]!=block.size()) {
-			printAdvancement(timesWithoutAdvancement);
+			printAdvancement(timesWithoutAdvancement_);
 			return;
 		}
 
@@ -437,8 +460,8 @@ private:
 			sitesCollapsed_.clear();
 			SizeType n1 = mettsStruct_.timeSteps();
 			this->common().aoe().targetVectors(n1).clear();
-			timesWithoutAdvancement = 0;
-			printAdvancement(timesWithoutAdvancement);
+			timesWithoutAdvancement_ = 0;
+			printAdvancement(timesWithoutAdvancement_);
 			return;
 		}
 	}
@@ -843,6 +866,7 @@ private:
 	MettsStochasticsType mettsStochastics_;
 	MettsCollapseType mettsCollapse_;
 	ProgramGlobals::DirectionEnum prevDirection_;
+	SizeType timesWithoutAdvancement_;
 	MettsPrev systemPrev_;
 	MettsPrev environPrev_;
 	std::pair<TargetVectorType,TargetVectorType> pureVectors_;
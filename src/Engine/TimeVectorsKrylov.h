@@ -81,6 +81,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #define TIME_VECTORS_KRYLOV
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include "TimeVectorsBase.h"
 #include "ParallelTriDiag.h"
 #include "NoPthreadsNg.h"
@@ -159,8 +160,18 @@ public:
 	      lrs_(lrs),
 	      ioIn_(ioIn),
 	      timeHasAdvanced_(false),
-	      krylovHelper_(model.params())
-	{}
+	      krylovHelper_(model.params()),
+	      recycle_(model.params().options.find("KrylovRecycle") != PsimagLite::String::npos),
+	      recycleTolerance_(1e-7),
+	      progress_("TimeVectorsKrylov"),
+	      lastFreshSteps_(0),
+	      stepsSaved_(0)
+	{
+		if (!recycle_) return;
+		try {
+			ioIn.readline(recycleTolerance_, "KrylovRecycleTolerance=");
+		} catch (std::exception&) {}
+	}
 
 	virtual void calcTimeVectors(const PsimagLite::Vector<SizeType>::Type& indices,
 	                             RealType Eg,
@@ -203,12 +214,16 @@ public:
 
 		typename PsimagLite::Vector<SizeType>::Type steps(phi.sectors());
 
-		triDiag(phi,T,V,steps);
-
 		VectorVectorRealType eigs(phi.sectors());
 
-		for (SizeType ii=0;ii<phi.sectors();ii++)
-			PsimagLite::diag(T[ii],eigs[ii],'V');
+		if (recycle_) {
+			triDiagRecycling(phi, T, V, eigs, steps, extra);
+		} else {
+			triDiag(phi,T,V,steps);
+
+			for (SizeType ii=0;ii<phi.sectors();ii++)
+				PsimagLite::diag(T[ii],eigs[ii],'V');
+		}
 
 		calcTargetVectors(indices, phi, T, V, Eg, eigs, steps);
 
@@ -228,6 +243,10 @@ public:
 
 private:
 
+	static const RealType RITZ_WEIGHT;
+	static const RealType MIN_WFT_WEIGHT;
+	static const RealType MIN_NEW_DIRECTION;
+
 	//! Do not normalize states here, it leads to wrong results (!)
 	void calcTargetVectors(typename PsimagLite::Vector<SizeType>::Type indices,
 	                       const VectorWithOffsetType& phi,
@@ -315,6 +334,249 @@ private:
 		threadedTriDiag.loopCreate(helperTriDiag);
 	}
 
+	/* PSIDOC KrylovRecycle
+	With SolverOptions=KrylovRecycle, the Ritz vectors of the previous
+	Krylov decomposition that carry weight in phi are kept, taken to the
+	current basis with the WFT, and, together with phi, used as the subspace
+	in which $\exp(-iHt)\phi$ is computed. The subspace is accepted if
+	$t_{\rm max}\sum_k |c_k|\,\|(HQ - QH_Q)s_k\| \le \epsilon\|\phi\|$,
+	where $Q$ is the orthonormal basis of the subspace, $H_Q = Q^\dagger HQ$,
+	$s_k$ are the eigenvectors of $H_Q$, $c_k$ are the coefficients of phi
+	on them, and $\epsilon$ is given by KrylovRecycleTolerance= (default
+	$10^{-7}$). Otherwise, or if the WFT lost too much of the Ritz vectors,
+	a fresh Lanczos decomposition is done. The Krylov steps saved are printed
+	each time.
+	*/
+	void triDiagRecycling(const VectorWithOffsetType& phi,
+	                      VectorMatrixFieldType& T,
+	                      VectorMatrixFieldType& V,
+	                      VectorVectorRealType& eigs,
+	                      typename PsimagLite::Vector<SizeType>::Type& steps,
+	                      const typename BaseType::ExtraData& extra)
+	{
+		wftRitzVectors(extra);
+
+		ParallelTriDiagType helperTriDiag(phi,T,V,steps,lrs_,time(),model_,ioIn_);
+		VectorVectorWithOffsetType ritzNew;
+		for (SizeType ii = 0; ii < phi.sectors(); ++ii) {
+			const SizeType i0 = phi.sector(ii);
+			PsimagLite::OstringStream msg;
+			msg<<"KrylovRecycle: sector "<<i0<<" ";
+			RealType error = 0;
+			SizeType matvecs = 0;
+			if (recycled(T[ii], V[ii], eigs[ii], error, matvecs, phi, i0)) {
+				steps[ii] = T[ii].rows();
+				SizeType saved = (lastFreshSteps_ > matvecs) ? lastFreshSteps_ - matvecs : 0;
+				stepsSaved_ += saved;
+				msg<<"recycled "<<steps[ii]<<" vectors, error bound="<<error;
+				msg<<" matvecs="<<matvecs<<" steps saved="<<saved;
+			} else {
+				helperTriDiag.doTask(ii, 0);
+				PsimagLite::diag(T[ii], eigs[ii], 'V');
+				lastFreshSteps_ = steps[ii];
+				msg<<"fresh start with "<<steps[ii]<<" steps";
+				if (matvecs > 0) msg<<" (error bound was "<<error<<")";
+			}
+
+			msg<<"; total steps saved="<<stepsSaved_;
+			progress_.printline(msg, std::cout);
+
+			keepRitzVectors(ritzNew, T[ii], V[ii], i0);
+		}
+
+		ritz_.swap(ritzNew);
+		ritzLeftBlock_ = lrs_.left().block();
+	}
+
+	// Ritz vectors of the previous call are in the previous basis if
+	// the left block has changed since then
+	void wftRitzVectors(const typename BaseType::ExtraData& extra)
+	{
+		if (ritz_.size() == 0 || ritzLeftBlock_ == lrs_.left().block()) return;
+		if (extra.block.size() == 0) {
+			ritz_.clear();
+			return;
+		}
+
+		for (SizeType k = 0; k < ritz_.size(); ++k) {
+			VectorWithOffsetType ritzNew;
+			BaseType::wftHelper().wftOneVector(ritzNew, ritz_[k], extra.block[0]);
+			ritz_[k] = ritzNew;
+		}
+	}
+
+	// Ritz vectors with weight in phi, at most half the steps of the last
+	// fresh decomposition so that recycling them can pay
+	void keepRitzVectors(VectorVectorWithOffsetType& ritzNew,
+	                     const MatrixComplexOrRealType& T,
+	                     const MatrixComplexOrRealType& V,
+	                     SizeType i0) const
+	{
+		const SizeType n = V.rows();
+		const SizeType m = T.cols();
+
+		// weight of Ritz vector k in phi; column 0 of V is phi/|phi|
+		typename PsimagLite::Vector<std::pair<RealType, SizeType> >::Type weights(m);
+		for (SizeType k = 0; k < m; ++k)
+			weights[k] = std::pair<RealType, SizeType>(PsimagLite::real(PsimagLite::conj(T(0, k))*
+			                                                            T(0, k)), k);
+
+		std::sort(weights.begin(), weights.end());
+		const SizeType maxKept = std::max(static_cast<SizeType>(2), lastFreshSteps_/2);
+		SizeType kept = 0;
+		for (SizeType kk = m; kk > 0 && kept < maxKept; --kk) {
+			if (weights[kk - 1].first < RITZ_WEIGHT) break;
+			const SizeType k = weights[kk - 1].second;
+			typename PsimagLite::Vector<VectorType>::Type y(1, VectorType(n, 0.0));
+			for (SizeType kprime = 0; kprime < m; ++kprime)
+				for (SizeType j = 0; j < n; ++j)
+					y[0][j] += V(j, kprime)*T(kprime, k);
+
+			VectorWithOffsetType ritz;
+			typename PsimagLite::Vector<SizeType>::Type sectors(1, i0);
+			ritz.set(y, sectors, lrs_.super());
+			ritzNew.push_back(ritz);
+			++kept;
+		}
+	}
+
+	// On success, V has the orthonormal basis Q of phi and the Ritz vectors,
+	// with phi/|phi| first, T the eigenvectors of Q^dagger H Q, and eigs
+	// its eigenvalues
+	bool recycled(MatrixComplexOrRealType& T,
+	              MatrixComplexOrRealType& V,
+	              VectorRealType& eigs,
+	              RealType& error,
+	              SizeType& matvecs,
+	              const VectorWithOffsetType& phi,
+	              SizeType i0) const
+	{
+		const SizeType n = phi.effectiveSize(i0);
+		typename PsimagLite::Vector<VectorType>::Type q;
+		VectorType phi2(n);
+		phi.extract(phi2, i0);
+		RealType normaPhi = PsimagLite::norm(phi2);
+		if (normaPhi == 0) return false;
+		phi2 /= normaPhi;
+		q.push_back(phi2);
+
+		RealType weightKept = 0;
+		SizeType candidates = 0;
+		for (SizeType k = 0; k < ritz_.size(); ++k) {
+			for (SizeType jj = 0; jj < ritz_[k].sectors(); ++jj) {
+				if (ritz_[k].sector(jj) != i0) continue;
+				VectorType y(n);
+				ritz_[k].extract(y, i0);
+				RealType normaY = PsimagLite::norm(y);
+				weightKept += normaY*normaY;
+				++candidates;
+				if (orthonormalize(y, q)) q.push_back(y);
+			}
+		}
+
+		// the Ritz vectors had norm one before the WFT
+		if (candidates == 0 || weightKept < MIN_WFT_WEIGHT*candidates) return false;
+
+		const SizeType m = q.size();
+		if (m < 2) return false;
+
+		SizeType p = lrs_.super().findPartitionNumber(phi.offset(i0));
+		typename ModelType::HamiltonianConnectionType hc(p,
+		                                                 lrs_,
+		                                                 model_.geometry(),
+		                                                 ModelType::modelLinks(),
+		                                                 time(),
+		                                                 0);
+		typename LanczosSolverType::MatrixType lanczosHelper(model_, hc);
+
+		typename PsimagLite::Vector<VectorType>::Type hq(m);
+		for (SizeType j = 0; j < m; ++j) {
+			hq[j].resize(n);
+			for (SizeType i = 0; i < n; ++i)
+				hq[j][i] = 0.0;
+			lanczosHelper.matrixVectorProduct(hq[j], q[j]);
+		}
+
+		matvecs = m;
+
+		MatrixComplexOrRealType hs(m, m);
+		for (SizeType i = 0; i < m; ++i)
+			for (SizeType j = 0; j < m; ++j)
+				hs(i, j) = dot(q[i], hq[j]);
+
+		// hermitian part, to remove round off
+		for (SizeType i = 0; i < m; ++i) {
+			for (SizeType j = i; j < m; ++j) {
+				hs(i, j) = 0.5*(hs(i, j) + PsimagLite::conj(hs(j, i)));
+				hs(j, i) = PsimagLite::conj(hs(i, j));
+			}
+		}
+
+		VectorRealType eigsHs(m);
+		MatrixComplexOrRealType s = hs;
+		PsimagLite::diag(s, eigsHs, 'V');
+
+		// error bound of exp(-iHt) phi in the subspace, for the largest time
+		RealType tmax = 0;
+		for (SizeType i = 0; i < times_.size(); ++i)
+			tmax = std::max(tmax, static_cast<RealType>(fabs(times_[i])));
+
+		error = 0;
+		for (SizeType k = 0; k < m; ++k) {
+			RealType residual2 = 0;
+			for (SizeType i = 0; i < n; ++i) {
+				ComplexOrRealType r = 0.0;
+				for (SizeType j = 0; j < m; ++j)
+					r += (hq[j][i] - eigsHs[k]*q[j][i])*s(j, k);
+				residual2 += PsimagLite::real(PsimagLite::conj(r)*r);
+			}
+
+			// phi = |phi| q[0], so its coefficient on Ritz vector k is |phi| s(0, k)*
+			error += tmax*normaPhi*sqrt(PsimagLite::real(PsimagLite::conj(s(0, k))*s(0, k))*residual2);
+		}
+
+		if (error > recycleTolerance_*normaPhi) return false;
+
+		V.resize(n, m);
+		for (SizeType j = 0; j < m; ++j)
+			for (SizeType i = 0; i < n; ++i)
+				V(i, j) = q[j][i];
+
+		T = s;
+		eigs = eigsHs;
+		return true;
+	}
+
+	// Gram-Schmidt, twice, of y against q, which is orthonormal;
+	// returns false if y is (almost) in the span of q
+	static bool orthonormalize(VectorType& y, const typename PsimagLite::Vector<VectorType>::Type& q)
+	{
+		RealType norma0 = PsimagLite::norm(y);
+		if (norma0 == 0) return false;
+		for (SizeType pass = 0; pass < 2; ++pass) {
+			for (SizeType j = 0; j < q.size(); ++j) {
+				ComplexOrRealType c = dot(q[j], y);
+				for (SizeType i = 0; i < y.size(); ++i)
+					y[i] -= c*q[j][i];
+			}
+		}
+
+		RealType norma = PsimagLite::norm(y);
+		if (norma < MIN_NEW_DIRECTION*norma0) return false;
+		y /= norma;
+		return true;
+	}
+
+	// x^dagger y
+	static ComplexOrRealType dot(const VectorType& x, const VectorType& y)
+	{
+		assert(x.size() == y.size());
+		ComplexOrRealType sum = 0.0;
+		for (SizeType i = 0; i < x.size(); ++i)
+			sum += PsimagLite::conj(x[i])*y[i];
+		return sum;
+	}
+
 	const SizeType& currentTimeStep_;
 	const TargetParamsType& tstStruct_;
 	const VectorRealType& times_;
@@ -325,7 +587,26 @@ private:
 	InputValidatorType& ioIn_;
 	bool timeHasAdvanced_;
 	KrylovHelperType krylovHelper_;
+	bool recycle_;
+	RealType recycleTolerance_;
+	PsimagLite::ProgressIndicator progress_;
+	VectorVectorWithOffsetType ritz_;
+	typename PsimagLite::Vector<SizeType>::Type ritzLeftBlock_;
+	SizeType lastFreshSteps_;
+	SizeType stepsSaved_;
 }; //class TimeVectorsKrylov
+
+template<typename T1, typename T2, typename T3, typename T4, typename T5>
+const typename TimeVectorsKrylov<T1, T2, T3, T4, T5>::RealType
+TimeVectorsKrylov<T1, T2, T3, T4, T5>::RITZ_WEIGHT = 1e-12;
+
+template<typename T1, typename T2, typename T3, typename T4, typename T5>
+const typename TimeVectorsKrylov<T1, T2, T3, T4, T5>::RealType
+TimeVectorsKrylov<T1, T2, T3, T4, T5>::MIN_WFT_WEIGHT = 0.9;
+
+template<typename T1, typename T2, typename T3, typename T4, typename T5>
+const typename TimeVectorsKrylov<T1, T2, T3, T4, T5>::RealType
+TimeVectorsKrylov<T1, T2, T3, T4, T5>::MIN_NEW_DIRECTION = 1e-6;
 } // namespace Dmrg
 /*@}*/
 #endif
@@ -151,17 +151,19 @@ public:
 	                       BasisWithOperatorsType& pE,
 	                       const TargetingType& target,
 	                       SizeType keptStates,
-	                       ProgramGlobals::DirectionEnum direction)
+	                       ProgramGlobals::DirectionEnum direction,
+	                       SizeType loopIndex)
 	{
 		PsimagLite::Profiling profiling("TruncationChangeBasis", std::cout);
 		DensityMatrixBaseType* dmS = 0;
+		const RealType perturbation = parameters_.densityMatrixPerturbationOf(loopIndex);
 
 		if (direction == ProgramGlobals::DirectionEnum::EXPAND_SYSTEM) {
-			changeBasis(pS,target,keptStates,direction, &dmS);
+			changeBasis(pS,target,keptStates,direction, perturbation, &dmS);
 			assert(dmS);
 			truncateBasis(pS,lrs_.right(), *dmS, direction, keptStates);
 		} else {
-			changeBasis(pE,target,keptStates,direction, &dmS);
+			changeBasis(pE,target,keptStates,direction, perturbation, &dmS);
 			assert(dmS);
 			truncateBasis(pE,lrs_.left(), *dmS, direction, keptStates);
 		}
@@ -189,6 +191,7 @@ public:
 		changeBasis(sBasis,
 		            target,
 		            keptStates, ProgramGlobals::DirectionEnum::EXPAND_SYSTEM,
+		            0,
 		            &dmS);
 		assert(dmS);
 		truncateBasis(sBasis,
@@ -204,6 +207,7 @@ public:
 		            target,
 		            keptStates,
 		            ProgramGlobals::DirectionEnum::EXPAND_ENVIRON,
+		            0,
 		            &dmE);
 		assert(dmE);
 		truncateBasis(eBasis,
@@ -221,6 +225,7 @@ private:
 	                 const TargetingType& target,
 	                 SizeType keptStates,
 	                 ProgramGlobals::DirectionEnum direction,
+	                 RealType perturbation,
 	                 DensityMatrixBaseType** dm)
 	{
 		/* PSIDOC Truncation
@@ -249,6 +254,12 @@ private:
 		bool enablePersistentSvd = (parameters_.options.find("EnablePersistentSvd") !=
 		        PsimagLite::String::npos);
 		ParamsDensityMatrixType p(useSvd, direction, debug, enablePersistentSvd);
+		p.randomizedSvd = (parameters_.options.find("truncationRandomizedSvd") !=
+		        PsimagLite::String::npos);
+		p.randomizedSvdCompare = (parameters_.options.find("truncationRandomizedSvdCompare") !=
+		        PsimagLite::String::npos);
+		p.keptStates = keptStates;
+		p.perturbation = perturbation;
 		TruncationCache& cache = (direction == expandSys) ? leftCache_ :
 		                                                    rightCache_;
 
@@ -269,10 +280,22 @@ private:
 		DensityMatrixBaseType* dmS = *dm;
 		assert(dmS);
 
-		dmS->diag(cache.eigs,'V');
+		bool partialDiag = (parameters_.options.find("truncationPartialDiag") !=
+		        PsimagLite::String::npos && dmS->canDiagPartially());
+
+		if (partialDiag)
+			dmS->eigenvalues(cache.eigs);
+		else
+			dmS->diag(cache.eigs,'V');
 
 		updateKeptStates(keptStates, cache.eigs);
 
+		rSprime = pBasis;
+		rSprime.changeBasis(cache.removedIndices,cache.eigs,keptStates,parameters_);
+
+		if (partialDiag)
+			dmS->diagKept(cache.removedIndices);
+
 		cache.transform = dmS->operator()();
 		if (parameters_.options.find("nodmrgtransform") != PsimagLite::String::npos) {
 			PsimagLite::OstringStream msg;
@@ -280,9 +303,6 @@ private:
 			progress_.printline(msg,std::cout);
 			cache.transform.setTo(1.0);
 		}
-
-		rSprime = pBasis;
-		rSprime.changeBasis(cache.removedIndices,cache.eigs,keptStates,parameters_);
 	}
 
 	void truncateBasis(BasisWithOperatorsType& rPrime,
@@ -487,15 +507,13 @@ private:
 
 		PsimagLite::String label("DensityMatrixEigenvalues");
 
-		static bool firstCall = true;
-		if (firstCall) {
+		if (counterVector_.size() == 0) {
 			ioOut_.createGroup(label);
 			SizeType n = geometry_.numberOfSites();
 			counterVector_.resize(n, 0);
 			ioOut_.write(n, label + "/Size");
 			for (SizeType i = 0; i < n; ++i)
 				ioOut_.createGroup(label + "/" + ttos(i));
-			firstCall = false;
 		}
 
 		SizeType last = lrs_.left().block().size();
@@ -85,7 +85,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "VectorWithOffset.h" // for operator*
 #include "Parallel2PointCorrelations.h"
 #include "Concurrency.h"
-#include "Parallelizer.h"
+#include "ParallelizerPool.h"
 #include "ProgramGlobals.h"
 
 namespace Dmrg {
@@ -106,6 +106,35 @@ public:
 	typedef typename CorrelationsSkeletonType::BraketType BraketType;
 	typedef typename CorrelationsSkeletonType::SparseMatrixType SparseMatrixType;
 	typedef typename ObserverHelperType::MatrixType MatrixType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename PsimagLite::Vector<VectorSizeType>::Type VectorVectorSizeType;
+
+	// <bra|O1_i O2_j|ket> for all i <= j in w
+	struct Request {
+
+		Request(MatrixType& w_,
+		        const SparseMatrixType& O1_,
+		        const SparseMatrixType& O2_,
+		        ProgramGlobals::FermionOrBosonEnum fermionicSign_,
+		        PsimagLite::String bra_,
+		        PsimagLite::String ket_)
+		    : w(&w_),
+		      O1(O1_),
+		      O2(O2_),
+		      fermionicSign(fermionicSign_),
+		      bra(bra_),
+		      ket(ket_)
+		{}
+
+		MatrixType* w;
+		SparseMatrixType O1;
+		SparseMatrixType O2;
+		ProgramGlobals::FermionOrBosonEnum fermionicSign;
+		PsimagLite::String bra;
+		PsimagLite::String ket;
+	};
+
+	typedef typename PsimagLite::Vector<Request>::Type VectorRequestType;
 	typedef Parallel2PointCorrelations<ThisType> Parallel2PointCorrelationsType;
 	typedef typename Parallel2PointCorrelationsType::PairType PairType;
 
@@ -119,30 +148,95 @@ public:
 	                PsimagLite::String bra,
 	                PsimagLite::String ket) const
 	{
-		SizeType rows = w.n_row();
-		SizeType cols = w.n_col();
-
-		typename PsimagLite::Vector<PairType>::Type pairs;
-		for (SizeType i=0;i<rows;i++) {
-			for (SizeType j=i;j<cols;j++) {
-				if (i>j) continue;
-				pairs.push_back(PairType(i,j));
-			}
+		VectorRequestType requests(1, Request(w, O1, O2, fermionicSign, bra, ket));
+		operator()(requests);
+	}
+
+	// All requests in one pass, threaded over rows
+	// Requests with the same O1, fermionic sign, and size form a group,
+	// whose rows grow O1 from site i once, one site at a time for
+	// j = i + 1, i + 2, ..., instead of once per (i, j) and request
+	void operator()(const VectorRequestType& requests) const
+	{
+		VectorVectorSizeType groups;
+		for (SizeType r = 0; r < requests.size(); ++r) {
+			SizeType g = 0;
+			for (; g < groups.size(); ++g)
+				if (sameGroup(requests[groups[g][0]], requests[r])) break;
+
+			if (g == groups.size())
+				groups.push_back(VectorSizeType());
+
+			groups[g].push_back(r);
 		}
 
-		typedef PsimagLite::Parallelizer<Parallel2PointCorrelationsType> ParallelizerType;
-		ParallelizerType threaded2Points(PsimagLite::Concurrency::codeSectionParams);
+		typedef ParallelizerPool<Parallel2PointCorrelationsType> ParallelizerType;
+		ParallelizerType threaded2Points(PsimagLite::Concurrency::codeSectionParams, "TwoPointCorrelations");
 
-		Parallel2PointCorrelationsType helper2Points(w,
-		                                             *this,
-		                                             pairs,
-		                                             O1,
-		                                             O2,
-		                                             fermionicSign,
-		                                             bra,
-		                                             ket);
+		Parallel2PointCorrelationsType helper2Points(*this, requests, groups);
 
-		threaded2Points.loopCreate(helper2Points);
+		threaded2Points.loopCreate(helper2Points, helper2Points.weights());
+	}
+
+	// Row i, for j >= i, of all requests of group
+	void calcRow(const VectorRequestType& requests,
+	             const VectorSizeType& group,
+	             SizeType i) const
+	{
+		assert(group.size() > 0);
+		const Request& first = requests[group[0]];
+		const SizeType cols = first.w->n_col();
+		if (i >= cols) return;
+
+		const ProgramGlobals::FermionOrBosonEnum fermionicSign = first.fermionicSign;
+		typename PsimagLite::Vector<SparseMatrixType>::Type O2m(group.size());
+		for (SizeType k = 0; k < group.size(); ++k) {
+			const Request& r = requests[group[k]];
+			(*r.w)(i, i) = calcDiagonalCorrelation(i, r.O1, r.O2, fermionicSign, r.bra, r.ket);
+			skeleton_.createWithModification(O2m[k], r.O2, 'n');
+		}
+
+		const SizeType n = skeleton_.numberOfSites();
+		SparseMatrixType O1g;
+		skeleton_.createWithModification(O1g, first.O1, 'n');
+		SizeType grownTo = (i > 0) ? i - 1 : 0;
+		for (SizeType j = i + 1; j < cols; ++j) {
+			if (j == n - 1 && i == j - 1) {
+				for (SizeType k = 0; k < group.size(); ++k) {
+					const Request& r = requests[group[k]];
+					(*r.w)(i, j) = calcCorrelation_(i, j, r.O1, r.O2, fermionicSign, r.bra, r.ket);
+				}
+
+				continue;
+			}
+
+			// j - 2 is the pointer at the right corner
+			const SizeType ns = (j == n - 1) ? j - 2 : j - 1;
+			assert(ns >= grownTo);
+			skeleton_.growDirectlyFrom(O1g, i, fermionicSign, grownTo, ns);
+			grownTo = ns;
+
+			for (SizeType k = 0; k < group.size(); ++k) {
+				const Request& r = requests[group[k]];
+				if (j == n - 1) {
+					(*r.w)(i, j) = skeleton_.bracketRightCorner(O1g,
+					                                            O2m[k],
+					                                            fermionicSign,
+					                                            j - 2,
+					                                            r.bra,
+					                                            r.ket);
+					continue;
+				}
+
+				SparseMatrixType O2g;
+				const SizeType ptr = skeleton_.dmrgMultiply(O2g, O1g, O2m[k], fermionicSign, ns);
+				(*r.w)(i, j) = skeleton_.bracket(O2g,
+				                                 ProgramGlobals::FermionOrBosonEnum::BOSON,
+				                                 ptr,
+				                                 r.bra,
+				                                 r.ket);
+			}
+		}
 	}
 
 	// Return the vector: O1 * O2 |psi>
@@ -253,6 +347,28 @@ private:
 		                         ket);
 	}
 
+	static bool sameGroup(const Request& a, const Request& b)
+	{
+		if (a.fermionicSign != b.fermionicSign) return false;
+		if (a.w->n_row() != b.w->n_row() || a.w->n_col() != b.w->n_col()) return false;
+		return sameMatrix(a.O1, b.O1);
+	}
+
+	static bool sameMatrix(const SparseMatrixType& a, const SparseMatrixType& b)
+	{
+		const SizeType rows = a.rows();
+		if (rows != b.rows() || a.cols() != b.cols()) return false;
+		if (a.getRowPtr(rows) != b.getRowPtr(rows)) return false;
+		for (SizeType i = 0; i < rows; ++i) {
+			if (a.getRowPtr(i) != b.getRowPtr(i)) return false;
+			for (int k = a.getRowPtr(i); k < a.getRowPtr(i + 1); ++k)
+				if (a.getCol(k) != b.getCol(k) || a.getValue(k) != b.getValue(k))
+					return false;
+		}
+
+		return true;
+	}
+
 	static SparseMatrixType identity(SizeType n)
 	{
 		SparseMatrixType ret(n, n);
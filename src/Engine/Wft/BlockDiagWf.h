@@ -4,6 +4,7 @@
 #include "BlockDiagonalMatrix.h"
 #include "LAPACK.h"
 #include "PackIndices.h"
+#include "ParallelizerPool.h"
 
 #include <iostream>
 #include <iomanip>
@@ -468,9 +469,9 @@ public:
 		patches_.resize(npatches);
 
 		SizeType threads = std::min(npatches, PsimagLite::Concurrency::codeSectionParams.npthreads);
-		typedef PsimagLite::Parallelizer<ParallelBlockCtor> ParallelizerType;
+		typedef ParallelizerPool<ParallelBlockCtor> ParallelizerType;
 		PsimagLite::CodeSectionParams codeSectionParams(threads);
-		ParallelizerType threadedCtor(codeSectionParams);
+		ParallelizerType threadedCtor(codeSectionParams, "BlockDiagWf::ctor");
 
 		ParallelBlockCtor helper(patchesLeft, patchesRight, lrs, src, iSrc, patches_, data_);
 
@@ -493,9 +494,9 @@ public:
 	{
 		SizeType npatches = data_.size();
 		SizeType threads = std::min(npatches, PsimagLite::Concurrency::codeSectionParams.npthreads);
-		typedef PsimagLite::Parallelizer<ParallelBlockTransform> ParallelizerType;
+		typedef ParallelizerPool<ParallelBlockTransform> ParallelizerType;
 		PsimagLite::CodeSectionParams codeSectionParams(threads);
-		ParallelizerType threadedTransform(codeSectionParams);
+		ParallelizerType threadedTransform(codeSectionParams, "BlockDiagWf::transform");
 
 		ParallelBlockTransform helper(tLeft,
 		                              tRight,
@@ -135,7 +135,8 @@ public:
 	      wftImpl_(0),
 	      rng_(3433117),
 	      noLoad_(false),
-	      save_(params.options.find("noSaveWft") == PsimagLite::String::npos)
+	      save_(params.options.find("noSaveWft") == PsimagLite::String::npos),
+	      isFork_(false)
 	{
 		if (!isEnabled_) return;
 
@@ -165,11 +166,26 @@ public:
 	~WaveFunctionTransfFactory()
 	{
 		if (!isEnabled_) return;
-		IoType::Out ioOut(filenameOut_, IoType::ACC_RDW);
-		write(ioOut);
+		if (!isFork_) {
+			IoType::Out ioOut(filenameOut_, IoType::ACC_RDW);
+			write(ioOut);
+		}
+
 		delete wftImpl_;
 	}
 
+	// Continues from the state of other, see MettsChains=; a fork does not
+	// write to the data file, which belongs to other
+	void fork(const WaveFunctionTransfFactory& other)
+	{
+		isFork_ = true;
+		if (!isEnabled_) return;
+		wftOptions_ = other.wftOptions_;
+		waveStructCombined_.copyFrom(other.waveStructCombined_);
+		noLoad_ = other.noLoad_;
+		sitesSeen_ = other.sitesSeen_;
+	}
+
 	void setStage(ProgramGlobals::DirectionEnum stage)
 	{
 		if (stage == wftOptions_.dir) return;
@@ -470,6 +486,7 @@ private:
 	PsimagLite::Random48<RealType> rng_;
 	bool noLoad_;
 	const bool save_;
+	bool isFork_;
 	VectorSizeType sitesSeen_;
 }; // class WaveFunctionTransformation
 } // namespace Dmrg
@@ -86,7 +86,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "WaveFunctionTransfBase.h"
 #include "MatrixOrIdentity.h"
 #include "ParallelWftOne.h"
-#include "Parallelizer.h"
+#include "ParallelizerPool.h"
 #include "MatrixVectorKron/KronMatrix.h"
 #include "WftAccelBlocks.h"
 #include "WftAccelPatches.h"
@@ -202,9 +202,9 @@ private:
 		}
 
 		SizeType i0 = psiDest.sector(iNew);
-		typedef PsimagLite::Parallelizer<ParallelWftType> ParallelizerType;
+		typedef ParallelizerPool<ParallelWftType> ParallelizerType;
 
-		ParallelizerType threadedWft(PsimagLite::Concurrency::codeSectionParams);
+		ParallelizerType threadedWft(PsimagLite::Concurrency::codeSectionParams, "WaveFunctionTransfLocal::transformVectorParallel");
 		ParallelWftType helperWft(psiDest,
 		                          psiSrc,
 		                          lrs,
@@ -240,7 +240,7 @@ private:
 		        lrs.left().block().size() > 1)
 			return wftAccelBlocks_.environFromInfinite(psiDest, i0, psiSrc, iOld, lrs, nk);
 
-		typedef PsimagLite::Parallelizer<WftSparseTwoSiteType> ParallelizerType;
+		typedef ParallelizerPool<WftSparseTwoSiteType> ParallelizerType;
 
 		SparseMatrixType ws;
 		dmrgWaveStruct_.getTransform(ProgramGlobals::SysOrEnvEnum::SYSTEM).toSparse(ws);
@@ -249,7 +249,7 @@ private:
 		SparseMatrixType weT;
 		transposeConjugate(weT,we);
 
-		ParallelizerType threadedWft(PsimagLite::Concurrency::codeSectionParams);
+		ParallelizerType threadedWft(PsimagLite::Concurrency::codeSectionParams, "WaveFunctionTransfLocal::tVector1FromInfinite");
 
 		WftSparseTwoSiteType helperWft(psiDest,
 		                               i0,
@@ -286,7 +286,7 @@ private:
 	                                  const LeftRightSuperType& lrs,
 	                                  const VectorSizeType& nk) const
 	{
-		typedef PsimagLite::Parallelizer<WftSparseTwoSiteType> ParallelizerType;
+		typedef ParallelizerPool<WftSparseTwoSiteType> ParallelizerType;
 
 		assert(dmrgWaveStruct_.lrs().super().permutationInverse().size() == psiSrc.size());
 
@@ -317,7 +317,7 @@ private:
 					                                   nk);
 					continue;
 				} else {
-					ParallelizerType threadedWft(PsimagLite::Concurrency::codeSectionParams);
+					ParallelizerType threadedWft(PsimagLite::Concurrency::codeSectionParams, "WaveFunctionTransfLocal::transformVector2FromInfinite");
 
 					WftSparseTwoSiteType helperWft(psiDest,
 					                               i0,
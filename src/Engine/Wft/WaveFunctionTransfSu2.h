@@ -88,6 +88,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Random48.h"
 #include "ParallelWftSu2.h"
 #include "MatrixOrIdentity.h"
+#include "ParallelizerPool.h"
 
 namespace Dmrg {
 
@@ -200,8 +201,8 @@ private:
 	                             const VectorSizeType& nk,
 	                             typename ProgramGlobals::DirectionEnum dir) const
 	{
-		typedef PsimagLite::Parallelizer<ParallelWftType> ParallelizerType;
-		ParallelizerType threadedWft(PsimagLite::Concurrency::codeSectionParams);
+		typedef ParallelizerPool<ParallelWftType> ParallelizerType;
+		ParallelizerType threadedWft(PsimagLite::Concurrency::codeSectionParams, "WaveFunctionTransfSu2");
 
 		ParallelWftType helperWft(psiDest,
 		                          psiSrc,
@@ -126,6 +126,14 @@ public:
 		}
 	}
 
+	void copyFrom(const WaveStructCombined& other)
+	{
+		lrs_.dontCopyOperators(other.lrs_);
+		wsStack_ = other.wsStack_;
+		weStack_ = other.weStack_;
+		needsPop_ = other.needsPop_;
+	}
+
 	void setLrs(const LeftRightSuperType& lrs)
 	{
 		lrs_.dontCopyOperators(lrs);
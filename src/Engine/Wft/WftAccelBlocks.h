@@ -3,6 +3,7 @@
 #include "Matrix.h"
 #include "BLAS.h"
 #include "ProgramGlobals.h"
+#include "ParallelizerPool.h"
 
 #include <iostream>
 #include <iomanip>
@@ -566,9 +567,9 @@ public:
 
 		SizeType threads = std::min(volumeOfNk,
 		                            PsimagLite::Concurrency::codeSectionParams.npthreads);
-		typedef PsimagLite::Parallelizer<ParallelWftInBlocks> ParallelizerType;
+		typedef ParallelizerPool<ParallelWftInBlocks> ParallelizerType;
 		PsimagLite::CodeSectionParams codeSectionParams(threads);
-		ParallelizerType threadedWft(codeSectionParams);
+		ParallelizerType threadedWft(codeSectionParams, "WftAccelBlocks::environFromInfinite");
 
 		ParallelWftInBlocks helperWft(result,
 		                              psi,
@@ -614,9 +615,9 @@ public:
 		VectorMatrixType result(volumeOfNk);
 
 		SizeType threads = std::min(volumeOfNk, PsimagLite::Concurrency::codeSectionParams.npthreads);
-		typedef PsimagLite::Parallelizer<ParallelWftInBlocks> ParallelizerType;
+		typedef ParallelizerPool<ParallelWftInBlocks> ParallelizerType;
 		PsimagLite::CodeSectionParams codeSectionParams(threads);
-		ParallelizerType threadedWft(codeSectionParams);
+		ParallelizerType threadedWft(codeSectionParams, "WftAccelBlocks::systemFromInfinite");
 
 		ParallelWftInBlocks helperWft(result,
 		                              psi,
@@ -4,6 +4,7 @@
 #include "BLAS.h"
 #include <limits>
 #include "ProgramGlobals.h"
+#include "ParallelizerPool.h"
 
 namespace Dmrg {
 
@@ -213,20 +214,20 @@ private:
 		                uPreviousPinv,
 		                vPrimePreviousPinv,
 		                qnsPrevious);
-		typedef PsimagLite::Parallelizer<LoopOne> ParallelizerOneType;
+		typedef ParallelizerPool<LoopOne> ParallelizerOneType;
 		SizeType threads = std::min(std::max(qnsVeryOld.size(), qnsPrevious.size()),
 		                            PsimagLite::Concurrency::codeSectionParams.npthreads);
 		PsimagLite::CodeSectionParams codeSectionParams(threads);
-		ParallelizerOneType threadOne(codeSectionParams);
+		ParallelizerOneType threadOne(codeSectionParams, "WftAccelSvd::loopOne");
 		threadOne.loopCreate(loopOne);
 
-		typedef PsimagLite::Parallelizer<LoopTwo> ParallelizerTwoType;
+		typedef ParallelizerPool<LoopTwo> ParallelizerTwoType;
 		LoopTwo loopTwo(loopOne.uFinal(),
 		                loopOne.vPrimeFinal(),
 		                loopOne.qns(),
 		                sPrevious,
 		                qnsPrevious);
-		ParallelizerTwoType threadTwo(codeSectionParams);
+		ParallelizerTwoType threadTwo(codeSectionParams, "WftAccelSvd::loopTwo");
 		threadTwo.loopCreate(loopTwo);
 	}
 
@@ -87,6 +87,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "VerySparseMatrix.h"
 #include "ProgramGlobals.h"
 #include "Geometry/GeometryDca.h"
+#include "ProgressIndicator.h"
 #include <cstdlib>
 #include <numeric>
 
@@ -144,9 +145,13 @@ public:
 	                    io),
 	      modelParameters_(io),
 	      geometry_(geometry),
-	      isSsh_(additional == "SSH")
+	      isSsh_(additional == "SSH"),
+	      progress_("HubbardHolstein")
 	{
 		HilbertSpaceHubbardHolsteinType::setBitPhonons(modelParameters_.numberphonons);
+		if (modelParameters_.phononBasisStates > 0)
+			setPhononRotation();
+
 		if (isSsh_) {
 			PsimagLite::String warning("HubbardHolstein: ");
 			warning += "SSH term in use.\n";
@@ -169,15 +174,11 @@ public:
 		findAllMatrices(cm,0,natBasis);
 
 		for (SizeType i=0;i<n;i++) {
-
-			addInteractionFU(hmatrix, cm, block[i]);
-
-			addInteractionFPhonon(hmatrix, cm, block[i]);
-
-			addPotentialFV(hmatrix, cm, block[i]);
-
-			addPotentialPhononV(hmatrix, cm, block[i]);
-
+			// products of operators are taken in the full phonon space
+			SparseMatrixType hFull;
+			hFull.makeDiagonal(natBasis.size());
+			addOnSite(hFull, cm, block[i]);
+			hmatrix += rotate(hFull);
 		}
 	}
 
@@ -211,12 +212,13 @@ protected:
 		HilbertBasisType natBasis;
 		setBasis(natBasis, block);
 		setSymmetryRelated(qns, natBasis);
+		rotate(qns);
 
 		//! Set the operators c^\daggger_{i\gamma\sigma} in the natural basis
 		SparseMatrixType tmpMatrix;
 		for (SizeType i=0;i<block.size();i++) {
 			for (int sigma=0;sigma<2;sigma++) {
-				tmpMatrix = findOperatorMatrices(i,sigma,natBasis);
+				tmpMatrix = rotate(findOperatorMatrices(i,sigma,natBasis));
 				int asign= 1;
 				if (sigma>0) asign= 1;
 				typename OperatorType::Su2RelatedType su2related;
@@ -239,7 +241,7 @@ protected:
 
 			if (modelParameters_.numberphonons == 0) continue;
 
-			tmpMatrix=findPhononadaggerMatrix(i,natBasis);
+			tmpMatrix = rotate(findPhononadaggerMatrix(i,natBasis));
 
 			typename OperatorType::Su2RelatedType su2related2;
 			su2related2.source.push_back(i*2);
@@ -261,7 +263,7 @@ protected:
 			// Set the operators c_(i,sigma} * x_i in the natural basis
 
 			for (int sigma=0;sigma<2;sigma++) {
-				tmpMatrix = findSSHMatrices(i,sigma,natBasis);
+				tmpMatrix = rotate(findSSHMatrices(i,sigma,natBasis));
 				int asign= 1;
 				if (sigma>0) asign= 1;
 				typename OperatorType::Su2RelatedType su2related3;
@@ -499,6 +501,165 @@ private:
 		}
 	}
 
+	void addOnSite(SparseMatrixType& hmatrix,
+	               const VectorSparseMatrixType& cm,
+	               SizeType actualIndexOfSite) const
+	{
+		addInteractionFU(hmatrix, cm, actualIndexOfSite);
+
+		addInteractionFPhonon(hmatrix, cm, actualIndexOfSite);
+
+		addPotentialFV(hmatrix, cm, actualIndexOfSite);
+
+		addPotentialPhononV(hmatrix, cm, actualIndexOfSite);
+	}
+
+	// PhononBasisStates=k keeps the k phonon states of largest weight in
+	// rho = sum_site (1/Z_site) sum_{e, j} exp(-(E(site, e, j) - E0(site))/T)
+	//       |phi(site, e, j)><phi(site, e, j)|,
+	// the sum over sites of the local thermal density matrices traced over
+	// the electronic state e; phi(site, e, j) and E(site, e, j) are the
+	// eigenvectors and eigenvalues of the on-site Hamiltonian with electronic
+	// state e, E0(site) is the lowest of them, and T is PhononBasisTemperature=,
+	// by default the largest phonon frequency; the same basis is used for all sites
+	void setPhononRotation()
+	{
+		typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+
+		const SizeType full = modelParameters_.numberphonons + 1;
+		const SizeType k = modelParameters_.phononBasisStates;
+		const RealType temperature = phononBasisTemperature();
+		BlockType block(1, 0);
+		HilbertBasisType natBasis;
+		setBasis(natBasis, block);
+		VectorSparseMatrixType cm;
+		findAllMatrices(cm, 0, natBasis);
+
+		MatrixType rho(full, full);
+		const SizeType nsites = geometry_.numberOfSites();
+		for (SizeType site = 0; site < nsites; ++site) {
+			SparseMatrixType hFull;
+			hFull.makeDiagonal(natBasis.size());
+			addOnSite(hFull, cm, site);
+			MatrixType dense;
+			crsMatrixToFullMatrix(dense, hFull);
+
+			typename PsimagLite::Vector<MatrixType>::Type h(4);
+			typename PsimagLite::Vector<VectorRealType>::Type eigs(4);
+			RealType e0 = 0;
+			for (SizeType e = 0; e < 4; ++e) {
+				h[e].resize(full, full);
+				for (SizeType b = 0; b < full; ++b)
+					for (SizeType b2 = 0; b2 < full; ++b2)
+						h[e](b, b2) = dense(e*full + b, e*full + b2);
+
+				eigs[e].resize(full);
+				PsimagLite::diag(h[e], eigs[e], 'V');
+				if (e == 0 || eigs[e][0] < e0) e0 = eigs[e][0];
+			}
+
+			MatrixType rhoSite(full, full);
+			RealType z = 0;
+			for (SizeType e = 0; e < 4; ++e) {
+				for (SizeType j = 0; j < full; ++j) {
+					const RealType weight = exp(-(eigs[e][j] - e0)/temperature);
+					z += weight;
+					for (SizeType b = 0; b < full; ++b)
+						for (SizeType b2 = 0; b2 < full; ++b2)
+							rhoSite(b, b2) += weight*h[e](b, j)*PsimagLite::conj(h[e](b2, j));
+				}
+			}
+
+			for (SizeType b = 0; b < full; ++b)
+				for (SizeType b2 = 0; b2 < full; ++b2)
+					rho(b, b2) += rhoSite(b, b2)/z;
+		}
+
+		// eigenvalues in ascending order
+		VectorRealType eigs(full);
+		PsimagLite::diag(rho, eigs, 'V');
+		RealType total = 0;
+		for (SizeType j = 0; j < full; ++j)
+			total += eigs[j];
+
+		RealType discarded = 0;
+		for (SizeType j = 0; j < full - k; ++j)
+			discarded += eigs[j];
+
+		phononRotation_.resize(full, k);
+		for (SizeType j = 0; j < k; ++j)
+			for (SizeType b = 0; b < full; ++b)
+				phononRotation_(b, j) = rho(b, full - 1 - j);
+
+		PsimagLite::OstringStream msg;
+		msg<<"PhononBasisStates="<<k<<" of "<<full<<" at temperature "<<temperature;
+		msg<<", discarded weight="<<discarded/total;
+		progress_.printline(msg, std::cout);
+	}
+
+	// PhononBasisTemperature= or else the largest phonon frequency, or 1
+	// if all phonon frequencies are zero
+	RealType phononBasisTemperature() const
+	{
+		if (modelParameters_.phononBasisTemperature > 0)
+			return modelParameters_.phononBasisTemperature;
+
+		RealType maxFrequency = 0;
+		for (SizeType i = 0; i < modelParameters_.potentialPV.size(); ++i) {
+			const RealType frequency = fabs(modelParameters_.potentialPV[i]);
+			if (frequency > maxFrequency) maxFrequency = frequency;
+		}
+
+		return (maxFrequency > 0) ? maxFrequency : 1;
+	}
+
+	// one-site matrix m from the full phonon space to the PhononBasisStates=
+	// basis, R^dagger m R, where R is block diagonal with one block
+	// phononRotation_ for each electronic state
+	SparseMatrixType rotate(const SparseMatrixType& m) const
+	{
+		const SizeType k = phononRotation_.cols();
+		if (k == 0) return m;
+
+		const SizeType full = modelParameters_.numberphonons + 1;
+		MatrixType dense;
+		crsMatrixToFullMatrix(dense, m);
+		assert(dense.rows() == 4*full);
+
+		MatrixType tmp(4*full, 4*k);
+		for (SizeType row = 0; row < 4*full; ++row)
+			for (SizeType e = 0; e < 4; ++e)
+				for (SizeType j = 0; j < k; ++j)
+					for (SizeType b = 0; b < full; ++b)
+						tmp(row, e*k + j) += dense(row, e*full + b)*phononRotation_(b, j);
+
+		MatrixType result(4*k, 4*k);
+		for (SizeType e = 0; e < 4; ++e)
+			for (SizeType j = 0; j < k; ++j)
+				for (SizeType col = 0; col < 4*k; ++col)
+					for (SizeType b = 0; b < full; ++b)
+						result(e*k + j, col) += PsimagLite::conj(phononRotation_(b, j))*
+						        tmp(e*full + b, col);
+
+		return SparseMatrixType(result);
+	}
+
+	// quantum numbers depend only on the electronic state
+	void rotate(VectorQnType& qns) const
+	{
+		const SizeType k = phononRotation_.cols();
+		if (k == 0) return;
+
+		const SizeType full = modelParameters_.numberphonons + 1;
+		assert(qns.size() == 4*full);
+		VectorQnType reduced(4*k, QnType::zero());
+		for (SizeType e = 0; e < 4; ++e)
+			for (SizeType j = 0; j < k; ++j)
+				reduced[e*k + j] = qns[e*full];
+
+		qns = reduced;
+	}
+
 	void addPotentialFV(SparseMatrixType &hmatrix,
 	                    const VectorSparseMatrixType& cm,
 	                    SizeType actualIndexOfSite) const
@@ -582,6 +743,9 @@ private:
 	ParametersHubbardHolsteinType modelParameters_;
 	const GeometryType& geometry_;
 	bool isSsh_;
+	PsimagLite::ProgressIndicator progress_;
+	// (NumberPhonons + 1) x PhononBasisStates; empty for the full phonon space
+	MatrixType phononRotation_;
 }; //class HubbardHolstein
 } // namespace Dmrg
 /*@}*/
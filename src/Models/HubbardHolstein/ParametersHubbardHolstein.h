@@ -97,7 +97,7 @@ struct ParametersHubbardHolstein : public ParametersModelBase<ComplexOrRealType,
 
 	template<typename IoInputType>
 	ParametersHubbardHolstein(IoInputType& io)
-	    : BaseType(io, false)
+	    : BaseType(io, false), phononBasisStates(0), phononBasisTemperature(0)
 	{
 
 		SizeType nsites = 0;
@@ -112,6 +112,20 @@ struct ParametersHubbardHolstein : public ParametersModelBase<ComplexOrRealType,
 		io.read(potentialFV,"potentialFV");
 		io.read(potentialPV,"potentialPV");
 
+		try {
+			io.readline(phononBasisStates, "PhononBasisStates=");
+		} catch (std::exception&) {}
+
+		if (phononBasisStates > numberphonons + 1)
+			err("PhononBasisStates= cannot be larger than NumberPhonons= plus one\n");
+
+		try {
+			io.readline(phononBasisTemperature, "PhononBasisTemperature=");
+		} catch (std::exception&) {}
+
+		if (phononBasisTemperature < 0)
+			err("PhononBasisTemperature= cannot be negative\n");
+
 		/*
 		for (SizeType i = 0; i < h; ++i) {
 			PsimagLite::Matrix<ComplexOrRealType> m;
@@ -140,6 +154,8 @@ struct ParametersHubbardHolstein : public ParametersModelBase<ComplexOrRealType,
 		io.write(label + "/lambdaFP", lambdaFP);
 		io.write(label + "/potentialFV", potentialFV);
 		io.write(label + "/potentialPV", potentialPV);
+		io.write(label + "/phononBasisStates", phononBasisStates);
+		io.write(label + "/phononBasisTemperature", phononBasisTemperature);
 	}
 
 	//! Function that prints model parameters to stream os
@@ -157,6 +173,11 @@ struct ParametersHubbardHolstein : public ParametersModelBase<ComplexOrRealType,
 		os<<parameters.potentialFV;
 		os<<"potentialPV\n";
 		os<<parameters.potentialPV;
+		if (parameters.phononBasisStates > 0)
+			os<<"PhononBasisStates="<<parameters.phononBasisStates<<"\n";
+		if (parameters.phononBasisTemperature > 0)
+			os<<"PhononBasisTemperature="<<parameters.phononBasisTemperature<<"\n";
+
 		return os;
 	}
 
@@ -166,6 +187,10 @@ struct ParametersHubbardHolstein : public ParametersModelBase<ComplexOrRealType,
 	// Onsite potential values
 	VectorRealType potentialFV;
 	VectorRealType potentialPV;
+	// 0 means the full phonon space of NumberPhonons + 1 states
+	SizeType phononBasisStates;
+	// 0 means the largest phonon frequency of potentialPV
+	RealType phononBasisTemperature;
 };
 } // namespace Dmrg
 
@@ -75,17 +75,25 @@ bool observeOneFullSweep(IoInputType& io,
 	                                  nf,
 	                                  trail);
 
+	// consecutive labels are measured together
+	PsimagLite::Vector<PsimagLite::String>::Type labels;
 	for (SizeType i = 0; i < vecOptions.size(); ++i) {
 		PsimagLite::String item = vecOptions[i];
 
 		if (item.find("%") == 0) continue;
 
-		if (item.length() > 0 && item[0] != '<')
-			observerLib.measure(item, rows, cols, orbitals);
-		else
-			observerLib.interpret(item, rows, cols);
+		if (item.length() > 0 && item[0] != '<') {
+			labels.push_back(item);
+			continue;
+		}
+
+		observerLib.measure(labels, rows, cols, orbitals);
+		labels.clear();
+		observerLib.interpret(item, rows, cols);
 	}
 
+	observerLib.measure(labels, rows, cols, orbitals);
+
 	start = end;
 	return observerLib.endOfData();
 }
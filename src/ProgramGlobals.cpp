@@ -80,6 +80,7 @@ namespace Dmrg {
 
 SizeType ProgramGlobals::maxElectronsOneSpin = 0;
 bool ProgramGlobals::oldChangeOfBasis = false;
+bool ProgramGlobals::su2NoKron = false;
 const PsimagLite::String ProgramGlobals::license=
 "Copyright (c) 2009-2016-2018, UT-Battelle, LLC\n"
 "All rights reserved\n"
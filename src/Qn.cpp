@@ -3,6 +3,7 @@
 namespace Dmrg {
 
 Qn::VectorModalStructType Qn::modalStruct;
+bool Qn::modalStructWritten = false;
 bool Qn::ifPresentOther0IsElectrons = true;
 
 }
@@ -128,6 +128,9 @@ operator: dmrg
 testQn: testQn.o Qn.o
 	\$(CXX) Qn.o testQn.o \$(LDFLAGS) -o testQn
 
+testSu2ReducedKron: testSu2ReducedKron.o
+	\$(CXX) testSu2ReducedKron.o \$(LDFLAGS) -o testSu2ReducedKron
+
 libkronutil.a:
 	\$(MAKE) -C KronUtil
 
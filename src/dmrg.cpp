@@ -3,6 +3,7 @@
 #include "Provenance.h"
 #include "RegisterSignals.h"
 #include "DmrgDriver.h"
+#include "ParallelizerPool.h"
 
 typedef PsimagLite::Vector<PsimagLite::String>::Type VectorStringType;
 typedef  PsimagLite::CrsMatrix<std::complex<RealType> > MySparseMatrixComplex;
@@ -382,12 +383,18 @@ to the main dmrg driver are the following.
 	                                          setAffinities,
 	                                          threadsStackSize);
 	ConcurrencyType::setOptions(codeSection);
+	ThreadPoolEngine::init(dmrgSolverParams.nthreads,
+	                       (dmrgSolverParams.options.find("threadPool") != PsimagLite::String::npos),
+	                       setAffinities);
 
 	registerSignals();
 
 	if (dmrgSolverParams.options.find("notReallySortCustom") != PsimagLite::String::npos)
 		ProgramGlobals::notReallySortAlgo = "custom";
 
+	if (dmrgSolverParams.options.find("su2NoKron") != PsimagLite::String::npos)
+		ProgramGlobals::su2NoKron = true;
+
 	bool isComplex = (dmrgSolverParams.options.find("useComplex") != PsimagLite::String::npos);
 	if (dmrgSolverParams.options.find("TimeStepTargeting") != PsimagLite::String::npos)
 		isComplex = true;
@@ -397,5 +404,7 @@ to the main dmrg driver are the following.
 	} else {
 		mainLoop0<MySparseMatrixReal>(io, dmrgSolverParams, options);
 	}
+
+	ThreadPoolEngine::printStats(std::cout);
 }
 
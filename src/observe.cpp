@@ -1,4 +1,5 @@
 #include "ObserveDriver.h"
+#include "ParallelizerPool.h"
 
 using namespace Dmrg;
 
@@ -198,6 +199,8 @@ int main(int argc,char **argv)
 	                      != PsimagLite::String::npos);
 	PsimagLite::CodeSectionParams codeSectionParams(dmrgSolverParams.nthreads, setAffinities);
 	ConcurrencyType::setOptions(codeSectionParams);
+	ThreadPoolEngine::init(dmrgSolverParams.nthreads,
+	                       (dmrgSolverParams.options.find("threadPool") != PsimagLite::String::npos));
 
 	bool isComplex = (dmrgSolverParams.options.find("useComplex") != PsimagLite::String::npos);
 	if (dmrgSolverParams.options.find("TimeStepTargeting") != PsimagLite::String::npos)
@@ -209,5 +212,7 @@ int main(int argc,char **argv)
 		mainLoop0<MySparseMatrixReal>(io,dmrgSolverParams,inputCheck, list);
 	}
 
+	ThreadPoolEngine::printStats(std::cout);
+
 } // main
 
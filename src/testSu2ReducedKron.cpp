@@ -0,0 +1,333 @@
+// Compares the products of Su2ReducedKron, by patches and GEMMs, with the
+// element by element loops of ModelHelperSu2, for random reduced bases
+// Usage: ./testSu2ReducedKron [seed]
+// Prints the largest difference and returns 1 if it is not small
+#include "Vector.h"
+#include "Matrix.h"
+#include "CrsMatrix.h"
+#include "Su2ReducedKron.h"
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+
+typedef double RealType;
+typedef PsimagLite::CrsMatrix<RealType> SparseMatrixType;
+typedef PsimagLite::Matrix<RealType> MatrixType;
+typedef PsimagLite::Vector<RealType>::Type VectorRealType;
+typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+typedef std::pair<SizeType, SizeType> PairType;
+typedef Dmrg::Link<RealType> LinkType;
+
+RealType random01() { return drand48(); }
+
+// The parts of BasisWithOperators that Su2ReducedKron uses
+struct MockBasis {
+
+	struct OperatorsType {
+		struct OperatorType {
+			typedef SparseMatrixType StorageType;
+		};
+	};
+
+	SizeType reducedSize() const { return j.size(); }
+
+	SizeType reducedIndex(SizeType i) const { return i; }
+
+	PairType jmValue(SizeType i) const { return PairType(j[i], 0); }
+
+	void su2ElectronsBridge(VectorSizeType& e) const { e = electrons; }
+
+	SizeType jMax() const { return jmax; }
+
+	VectorSizeType j;
+	VectorSizeType electrons;
+	SizeType jmax;
+};
+
+struct MockSuper {
+
+	SizeType partition(SizeType m) const { return (m == 0) ? start : end; }
+
+	SizeType start;
+	SizeType end;
+};
+
+struct MockLeftRightSuper {
+
+	typedef MockBasis BasisWithOperatorsType;
+
+	const MockBasis& left() const { return left_; }
+
+	const MockBasis& right() const { return right_; }
+
+	const MockSuper& super() const { return super_; }
+
+	MockBasis left_;
+	MockBasis right_;
+	MockSuper super_;
+};
+
+// The parts of Su2Reduced that Su2ReducedKron uses; the factors are random
+// but depend only on j, as the Wigner-Eckart factors do
+struct MockSu2Reduced {
+
+	SizeType reducedEffectiveSize() const { return effective.size(); }
+
+	const PairType& reducedEffective(SizeType i) const { return effective[i]; }
+
+	SizeType flavorMapping(SizeType i) const { return flavor[i]; }
+
+	SizeType flavorMapping(SizeType i1, SizeType i2) const
+	{
+		int i = effectiveIndex(i1, i2);
+		return (i < 0) ? 0 : flavor[i];
+	}
+
+	RealType reducedFactor(SizeType angularMomentum,
+	                       SizeType category,
+	                       bool flip,
+	                       SizeType lf1,
+	                       SizeType lf2) const
+	{
+		SizeType c = (flip) ? angularMomentum - category : category;
+		return factor[c](lf1, lf2);
+	}
+
+	RealType reducedHamiltonianFactor(SizeType j1, SizeType j2) const
+	{
+		return hamiltonianFactor(j1, j2);
+	}
+
+	const SparseMatrixType& hamiltonianLeft() const { return hl; }
+
+	const SparseMatrixType& hamiltonianRight() const { return hr; }
+
+	PsimagLite::Vector<PairType>::Type effective;
+	VectorSizeType flavor;
+	PsimagLite::Matrix<int> effectiveIndex;
+	PsimagLite::Vector<MatrixType>::Type factor;
+	MatrixType hamiltonianFactor;
+	SparseMatrixType hl;
+	SparseMatrixType hr;
+};
+
+typedef Dmrg::Su2ReducedKron<MockLeftRightSuper, MockSu2Reduced> Su2ReducedKronType;
+
+// random operator of basis; if deltaN is zero it conserves j and electrons,
+// otherwise it changes the electrons by deltaN
+void randomOperator(SparseMatrixType& m, const MockBasis& basis, int deltaN)
+{
+	const SizeType n = basis.reducedSize();
+	MatrixType dense(n, n);
+	for (SizeType i = 0; i < n; ++i) {
+		for (SizeType iprime = 0; iprime < n; ++iprime) {
+			int dn = basis.electrons[i] - basis.electrons[iprime];
+			if (dn != deltaN) continue;
+			if (deltaN == 0 && basis.j[i] != basis.j[iprime]) continue;
+			if (random01() < 0.4) continue;
+			dense(i, iprime) = random01() - 0.5;
+		}
+	}
+
+	fullMatrixToCrsMatrix(m, dense);
+}
+
+void randomBasis(MockBasis& basis, SizeType n, SizeType jmax)
+{
+	basis.jmax = jmax;
+	for (SizeType i = 0; i < n; ++i) {
+		basis.j.push_back(static_cast<SizeType>(random01()*jmax));
+		basis.electrons.push_back(static_cast<SizeType>(random01()*3));
+	}
+}
+
+// ModelHelperSu2::fastOpProdInter, for a SYSTEM_ENVIRON link
+void fastOpProdInter(VectorRealType& x,
+                     const VectorRealType& y,
+                     const SparseMatrixType& A,
+                     const SparseMatrixType& B,
+                     const LinkType& link,
+                     bool flipped,
+                     const MockLeftRightSuper& lrs,
+                     const MockSu2Reduced& su2reduced)
+{
+	RealType fermionSign = (link.fermionOrBoson ==
+	                        Dmrg::ProgramGlobals::FermionOrBosonEnum::FERMION) ? -1 : 1;
+	int offset = lrs.super().partition(0);
+	for (SizeType i = 0; i < su2reduced.reducedEffectiveSize(); ++i) {
+		int ix = su2reduced.flavorMapping(i) - offset;
+		if (ix < 0 || ix >= int(x.size())) continue;
+
+		SizeType i1 = su2reduced.reducedEffective(i).first;
+		SizeType i2 = su2reduced.reducedEffective(i).second;
+		SizeType n1 = lrs.left().electrons[i1];
+		RealType fsign = (n1 > 0 && n1 % 2 != 0) ? fermionSign : 1;
+		SizeType lf1 = lrs.left().j[i1] + lrs.right().j[i2]*lrs.left().jMax();
+		for (int k1 = A.getRowPtr(i1); k1 < A.getRowPtr(i1 + 1); ++k1) {
+			SizeType i1prime = A.getCol(k1);
+			for (int k2 = B.getRowPtr(i2); k2 < B.getRowPtr(i2 + 1); ++k2) {
+				SizeType i2prime = B.getCol(k2);
+				if (su2reduced.effectiveIndex(i1prime, i2prime) < 0) continue;
+				SizeType lf2 = lrs.left().j[i1prime] +
+				        lrs.right().j[i2prime]*lrs.left().jMax();
+				RealType lfactor = su2reduced.reducedFactor(link.angularMomentum,
+				                                            link.category,
+				                                            flipped,
+				                                            lf1,
+				                                            lf2);
+				if (lfactor == 0) continue;
+				lfactor *= link.angularFactor;
+
+				int jx = su2reduced.flavorMapping(i1prime, i2prime) - offset;
+				if (jx < 0 || jx >= int(y.size())) continue;
+
+				x[ix] += fsign*link.value*lfactor*A.getValue(k1)*B.getValue(k2)*y[jx];
+			}
+		}
+	}
+}
+
+// ModelHelperSu2::hamiltonianLeftProduct and hamiltonianRightProduct
+void hamiltonianProduct(VectorRealType& x,
+                        const VectorRealType& y,
+                        bool left,
+                        const MockLeftRightSuper& lrs,
+                        const MockSu2Reduced& su2reduced)
+{
+	int offset = lrs.super().partition(0);
+	const SparseMatrixType& h = (left) ? su2reduced.hamiltonianLeft() :
+	                                     su2reduced.hamiltonianRight();
+	for (SizeType i = 0; i < su2reduced.reducedEffectiveSize(); ++i) {
+		int ix = su2reduced.flavorMapping(i) - offset;
+		if (ix < 0 || ix >= int(x.size())) continue;
+
+		SizeType i1 = su2reduced.reducedEffective(i).first;
+		SizeType i2 = su2reduced.reducedEffective(i).second;
+		RealType lfactor = su2reduced.reducedHamiltonianFactor(lrs.left().j[i1],
+		                                                       lrs.right().j[i2]);
+		if (lfactor == 0) continue;
+
+		SizeType row = (left) ? i1 : i2;
+		for (int k = h.getRowPtr(row); k < h.getRowPtr(row + 1); ++k) {
+			SizeType i1prime = (left) ? h.getCol(k) : i1;
+			SizeType i2prime = (left) ? i2 : h.getCol(k);
+			if (su2reduced.effectiveIndex(i1prime, i2prime) < 0) continue;
+			int jx = su2reduced.flavorMapping(i1prime, i2prime) - offset;
+			if (jx < 0 || jx >= int(y.size())) continue;
+
+			x[ix] += h.getValue(k)*y[jx];
+		}
+	}
+}
+
+RealType maxDifference(const VectorRealType& x1, const VectorRealType& x2)
+{
+	RealType diff = 0;
+	for (SizeType i = 0; i < x1.size(); ++i)
+		diff = std::max(diff, fabs(x1[i] - x2[i]));
+	return diff;
+}
+
+int main(int argc, char** argv)
+{
+	srand48((argc > 1) ? atoi(argv[1]) : 1234);
+
+	const SizeType jmax = 3;
+	const SizeType electrons = 2;
+	MockLeftRightSuper lrs;
+	randomBasis(lrs.left_, 11, jmax);
+	randomBasis(lrs.right_, 9, jmax);
+
+	// effective states have the total electrons and even j1 + j2,
+	// as states of a given total j do
+	MockSu2Reduced su2reduced;
+	const SizeType nl = lrs.left().reducedSize();
+	const SizeType nr = lrs.right().reducedSize();
+	su2reduced.effectiveIndex.resize(nl, nr);
+	for (SizeType i1 = 0; i1 < nl; ++i1) {
+		for (SizeType i2 = 0; i2 < nr; ++i2) {
+			su2reduced.effectiveIndex(i1, i2) = -1;
+			if (lrs.left().electrons[i1] + lrs.right().electrons[i2] != electrons) continue;
+			if ((lrs.left().j[i1] + lrs.right().j[i2]) % 2 != 0) continue;
+			su2reduced.effectiveIndex(i1, i2) = su2reduced.effective.size();
+			su2reduced.effective.push_back(PairType(i1, i2));
+		}
+	}
+
+	// partition 0 starts at 5 and leaves out two effective states
+	const SizeType ne = su2reduced.effective.size();
+	if (ne < 3) {
+		std::cerr<<"testSu2ReducedKron: too few states, try another seed\n";
+		return 1;
+	}
+
+	VectorSizeType permutation(ne);
+	for (SizeType i = 0; i < ne; ++i) permutation[i] = i;
+	for (SizeType i = ne - 1; i > 0; --i)
+		std::swap(permutation[i], permutation[static_cast<SizeType>(random01()*(i + 1))]);
+	for (SizeType i = 0; i < ne; ++i)
+		su2reduced.flavor.push_back(5 + permutation[i]);
+	lrs.super_.start = 5;
+	lrs.super_.end = 5 + ne - 2;
+
+	su2reduced.factor.resize(3);
+	for (SizeType c = 0; c < su2reduced.factor.size(); ++c) {
+		su2reduced.factor[c].resize(jmax*jmax, jmax*jmax);
+		for (SizeType i = 0; i < jmax*jmax; ++i)
+			for (SizeType j = 0; j < jmax*jmax; ++j)
+				su2reduced.factor[c](i, j) = (random01() < 0.3) ? 0 : random01() - 0.5;
+	}
+
+	su2reduced.hamiltonianFactor.resize(jmax, jmax);
+	for (SizeType j1 = 0; j1 < jmax; ++j1)
+		for (SizeType j2 = 0; j2 < jmax; ++j2)
+			su2reduced.hamiltonianFactor(j1, j2) = (random01() < 0.3) ? 0 : 1;
+
+	randomOperator(su2reduced.hl, lrs.left(), 0);
+	randomOperator(su2reduced.hr, lrs.right(), 0);
+
+	// A adds an electron on the left and B removes one on the right
+	SparseMatrixType A;
+	randomOperator(A, lrs.left(), 1);
+	SparseMatrixType B;
+	randomOperator(B, lrs.right(), -1);
+
+	LinkType link(0,
+	              1,
+	              Dmrg::ProgramGlobals::ConnectionEnum::SYSTEM_ENVIRON,
+	              0.7,
+	              Dmrg::ProgramGlobals::FermionOrBosonEnum::FERMION,
+	              LinkType::PairSizeType(0, 0),
+	              LinkType::PairCharType('N', 'N'),
+	              2,
+	              1.3,
+	              0);
+
+	Su2ReducedKronType kron(0, lrs, su2reduced, true);
+	kron.cacheOperators(A, B);
+
+	const SizeType total = ne - 2;
+	VectorRealType y(total);
+	for (SizeType i = 0; i < total; ++i) y[i] = random01() - 0.5;
+
+	RealType diff = 0;
+	for (SizeType flipped = 0; flipped < 2; ++flipped) {
+		VectorRealType x1(total, 0.0);
+		VectorRealType x2(total, 0.0);
+		kron.fastOpProdInter(x1, y, A, B, link, flipped, su2reduced);
+		fastOpProdInter(x2, y, A, B, link, flipped, lrs, su2reduced);
+		diff = std::max(diff, maxDifference(x1, x2));
+	}
+
+	for (SizeType left = 0; left < 2; ++left) {
+		VectorRealType x1(total, 0.0);
+		VectorRealType x2(total, 0.0);
+		if (left) kron.hamiltonianLeftProduct(x1, y, su2reduced);
+		else kron.hamiltonianRightProduct(x1, y, su2reduced);
+		hamiltonianProduct(x2, y, left, lrs, su2reduced);
+		diff = std::max(diff, maxDifference(x1, x2));
+	}
+
+	std::cout<<"testSu2ReducedKron: max difference "<<diff<<"\n";
+	return (diff < 1e-12) ? 0 : 1;
+}